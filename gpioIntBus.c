@@ -0,0 +1,225 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "gpioIntBus.h"
+#include "dis_dfe8219_log.h"
+
+/**
+ * @brief Check whether an event channel belongs to the subscriber
+ * @param sub Subscriber state
+ * @param channel GPIO interrupt channel number
+ * @return bool true if the subscriber takes all channels or the consumer matches
+ */
+static bool bus_channel_matches(const GpioIntBusSub *sub, uint16_t channel)
+{
+    if (sub->consumer[0] == '\0') {
+        return true;
+    }
+    
+    return channel < GPIO_INT_MAX_CHANNELS &&
+           strncmp(sub->bus->consumer[channel], sub->consumer, sizeof(sub->consumer)) == 0;
+}
+
+/**
+ * @brief Skip the events a faster publisher has already overwritten
+ * @param sub Subscriber state
+ */
+static void bus_skip_lost(GpioIntBusSub *sub)
+{
+    uint64_t head = __atomic_load_n(&sub->bus->head, __ATOMIC_ACQUIRE);
+    
+    if (head > sub->bus->capacity && sub->next < head - sub->bus->capacity) {
+        sub->lost += head - sub->bus->capacity - sub->next;
+        sub->next = head - sub->bus->capacity;
+    }
+}
+
+uint8_t gpio_int_bus_open(GpioIntBusSub *sub, const char *name, const char *consumer)
+{
+    struct stat st;
+    
+    if (!sub) {
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
+    
+    memset(sub, 0, sizeof(*sub));
+    if (consumer) {
+        snprintf(sub->consumer, sizeof(sub->consumer), "%s", consumer);
+    }
+    
+    /* Read-write: subscribers register on the wake futex */
+    int fd = shm_open(name ? name : GPIO_INT_BUS_DEFAULT_NAME, O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to open GPIO interrupt bus: %s\n", strerror(errno));
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    void *map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(GpioIntBusHeader)) {
+        map = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (map == MAP_FAILED) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to map GPIO interrupt bus\n");
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    GpioIntBusHeader *bus = map;
+    size_t need = sizeof(*bus) + (size_t)bus->capacity * sizeof(GpioIntBusSlot);
+    if (bus->magic != GPIO_INT_BUS_MAGIC || bus->version != GPIO_INT_BUS_VERSION ||
+        bus->slot_size != sizeof(GpioIntBusSlot) || bus->capacity == 0 ||
+        (bus->capacity & (bus->capacity - 1)) != 0 || need > (size_t)st.st_size) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Incompatible GPIO interrupt bus (version %u)\n", bus->version);
+        munmap(map, (size_t)st.st_size);
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    sub->bus = bus;
+    sub->map_len = (size_t)st.st_size;
+    sub->next = __atomic_load_n(&bus->head, __ATOMIC_ACQUIRE);
+    return DIS_COMMON_ERR_OK;
+}
+
+void gpio_int_bus_close(GpioIntBusSub *sub)
+{
+    if (sub && sub->bus) {
+        munmap(sub->bus, sub->map_len);
+        sub->bus = NULL;
+    }
+}
+
+const GpioIntEvent *gpio_int_bus_peek(GpioIntBusSub *sub)
+{
+    if (!sub || !sub->bus) {
+        return NULL;
+    }
+    
+    for (;;) {
+        GpioIntBusSlot *slot = gpio_int_bus_slot(sub->bus, sub->next);
+        uint64_t want = 2 * sub->next + 2;
+        uint64_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        
+        /* Not published yet, or still being written */
+        if (seq < want) {
+            return NULL;
+        }
+        
+        if (seq == want) {
+            uint16_t channel = slot->event.channel;
+            
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) == want) {
+                if (bus_channel_matches(sub, channel)) {
+                    sub->peek_seq = want;
+                    return &slot->event;
+                }
+                sub->next++;
+                continue;
+            }
+        }
+        
+        /* Lapped by the publisher */
+        bus_skip_lost(sub);
+        if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) > 2 * sub->next + 2) {
+            sub->lost++;
+            sub->next++;
+        }
+    }
+}
+
+uint8_t gpio_int_bus_release(GpioIntBusSub *sub)
+{
+    if (!sub || !sub->bus) {
+        return 0;
+    }
+    
+    GpioIntBusSlot *slot = gpio_int_bus_slot(sub->bus, sub->next);
+    
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    uint8_t intact = (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) == sub->peek_seq);
+    if (!intact) {
+        sub->lost++;
+    }
+    
+    sub->next++;
+    return intact;
+}
+
+int gpio_int_bus_read(GpioIntBusSub *sub, GpioIntEvent *events, unsigned int max)
+{
+    unsigned int n = 0;
+    
+    if (!sub || !sub->bus || !events) {
+        return -1;
+    }
+    
+    /* Sample active first, so everything published before the stop is drained */
+    bool active = __atomic_load_n(&sub->bus->active, __ATOMIC_ACQUIRE);
+    
+    while (n < max) {
+        const GpioIntEvent *event = gpio_int_bus_peek(sub);
+        if (!event) {
+            break;
+        }
+        
+        events[n] = *event;
+        if (gpio_int_bus_release(sub)) {
+            n++;
+        }
+    }
+    
+    return (n == 0 && !active) ? -1 : (int)n;
+}
+
+int gpio_int_bus_wait(GpioIntBusSub *sub, int timeout_ms)
+{
+    struct timespec deadline;
+    
+    if (!sub || !sub->bus) {
+        return -1;
+    }
+    
+    GpioIntBusHeader *bus = sub->bus;
+    
+    /* FUTEX_WAIT_BITSET takes an absolute CLOCK_MONOTONIC deadline */
+    if (timeout_ms >= 0) {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += timeout_ms / 1000;
+        deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+    
+    for (;;) {
+        uint32_t wake = __atomic_load_n(&bus->wake, __ATOMIC_SEQ_CST);
+        
+        if (__atomic_load_n(&bus->head, __ATOMIC_ACQUIRE) > sub->next) {
+            return 1;
+        }
+        if (!__atomic_load_n(&bus->active, __ATOMIC_ACQUIRE)) {
+            return -1;
+        }
+        
+        /* The publisher bumps wake before it looks at waiters, so either it
+         * sees us or the futex value no longer matches and we recheck */
+        __atomic_fetch_add(&bus->waiters, 1, __ATOMIC_SEQ_CST);
+        long ret = syscall(SYS_futex, &bus->wake, FUTEX_WAIT_BITSET, wake,
+                           (timeout_ms >= 0) ? &deadline : NULL, NULL, FUTEX_BITSET_MATCH_ANY);
+        int err = errno;
+        __atomic_fetch_sub(&bus->waiters, 1, __ATOMIC_SEQ_CST);
+        
+        if (ret != 0 && err == ETIMEDOUT) {
+            return 0;
+        }
+    }
+}
@@ -0,0 +1,133 @@
+#ifndef _GPIOINTBUS_H_
+#define _GPIOINTBUS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "gpioInterrupt.h"
+
+/*
+ * Cross-process interrupt event bus.
+ *
+ * The process running the GPIO interrupt system publishes every dispatched
+ * event into a POSIX shared memory ring (gpio_int_bus_start()). Other
+ * services map the ring with the subscriber API below and consume events
+ * without opening /dev/uioN or linking the interrupt system.
+ *
+ * Slot n of the ring is a seqlock: seq is 2n+1 while the event is written and
+ * 2n+2 once complete. Readers check seq before and after using the event, so
+ * a slot overwritten by a faster publisher is detected and counted as lost.
+ * The publisher bumps the wake futex once per monitor pass, so a burst of
+ * events costs at most one wakeup syscall per pass.
+ */
+
+#define GPIO_INT_BUS_MAGIC          0x42494947u     /* "GIIB" */
+#define GPIO_INT_BUS_VERSION        1
+
+/* Default shared memory object name, see shm_open(3) */
+#define GPIO_INT_BUS_DEFAULT_NAME   "/gpio_int_bus"
+
+/* Upper bound on bus slots */
+#define GPIO_INT_BUS_MAX_SLOTS      (1u << 20)
+
+/**
+ * @brief Header at the start of the bus shared memory object
+ *
+ * The slots follow the header as a ring of capacity entries.
+ */
+typedef struct {
+    uint32_t    magic;          /* GPIO_INT_BUS_MAGIC */
+    uint16_t    version;        /* GPIO_INT_BUS_VERSION */
+    uint16_t    slot_size;      /* sizeof(GpioIntBusSlot) */
+    uint32_t    capacity;       /* Slots in the ring (power of two) */
+    uint32_t    publisher_pid;  /* Process publishing the events */
+    uint8_t     active;         /* 1 while the publisher runs, 0 once it stopped */
+    uint8_t     pad0[47];
+    uint64_t    head;           /* Events claimed so far, updated atomically by the monitor threads */
+    uint8_t     pad1[56];
+    uint32_t    wake;           /* Futex word, bumped after each monitor pass that published */
+    uint32_t    waiters;        /* Subscribers sleeping on wake */
+    uint8_t     pad2[56];
+    char        consumer[GPIO_INT_MAX_CHANNELS][16];    /* gpiod consumer of each monitored channel */
+} GpioIntBusHeader;
+
+/**
+ * @brief One event slot of the bus ring
+ */
+typedef struct {
+    uint64_t        seq;        /* 2n+1 while event n is written, 2n+2 once complete */
+    GpioIntEvent    event;      /* Dispatched event */
+} GpioIntBusSlot;
+
+/**
+ * @brief Subscriber state of one process-local reader
+ */
+typedef struct {
+    GpioIntBusHeader    *bus;           /* Mapped bus, NULL when closed */
+    size_t              map_len;        /* Mapping length */
+    uint64_t            next;           /* Number of the next event to read */
+    uint64_t            peek_seq;       /* seq of the slot returned by gpio_int_bus_peek() */
+    uint64_t            lost;           /* Events overwritten before they were read */
+    char                consumer[16];   /* Only channels of this consumer, "" for all */
+} GpioIntBusSub;
+
+/**
+ * @brief Get the slot holding event n of a bus
+ * @param bus Mapped bus
+ * @param n Event number
+ * @return GpioIntBusSlot* Slot of the event
+ */
+static inline GpioIntBusSlot *gpio_int_bus_slot(const GpioIntBusHeader *bus, uint64_t n)
+{
+    return (GpioIntBusSlot *)(bus + 1) + (n & (bus->capacity - 1));
+}
+
+/**
+ * @brief Map a bus and start reading at the next published event
+ * @param sub Subscriber state to set up
+ * @param name Shared memory object name (NULL for GPIO_INT_BUS_DEFAULT_NAME)
+ * @param consumer Only deliver channels whose gpiod consumer matches (NULL for all)
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ */
+uint8_t gpio_int_bus_open(GpioIntBusSub *sub, const char *name, const char *consumer);
+
+/**
+ * @brief Unmap a bus
+ * @param sub Subscriber state
+ */
+void gpio_int_bus_close(GpioIntBusSub *sub);
+
+/**
+ * @brief Get the next event in place, without copying it
+ * @param sub Subscriber state
+ * @return const GpioIntEvent* Event inside the ring, NULL if none is pending
+ *
+ * The publisher may overwrite the slot while it is in use. Only act on the
+ * event once gpio_int_bus_release() confirms it was intact.
+ */
+const GpioIntEvent *gpio_int_bus_peek(GpioIntBusSub *sub);
+
+/**
+ * @brief Finish with the event returned by gpio_int_bus_peek() and advance
+ * @param sub Subscriber state
+ * @return uint8_t 1 if the event was intact while in use, 0 if it was overwritten
+ */
+uint8_t gpio_int_bus_release(GpioIntBusSub *sub);
+
+/**
+ * @brief Copy pending events out of the ring
+ * @param sub Subscriber state
+ * @param events Output array
+ * @param max Capacity of events
+ * @return int Number of events copied, -1 once the publisher has stopped and the ring is drained
+ */
+int gpio_int_bus_read(GpioIntBusSub *sub, GpioIntEvent *events, unsigned int max);
+
+/**
+ * @brief Sleep until events are pending
+ * @param sub Subscriber state
+ * @param timeout_ms Timeout in milliseconds, < 0 to wait forever
+ * @return int 1 if events are pending, 0 on timeout, -1 once the publisher has stopped
+ */
+int gpio_int_bus_wait(GpioIntBusSub *sub, int timeout_ms);
+
+#endif
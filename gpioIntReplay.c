@@ -0,0 +1,306 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "gpioInterrupt.h"
+#include "gpioIntSim.h"
+
+/*
+ * Replays a trace recorded with gpio_int_trace_start() through the dispatcher
+ * on the simulated backend, either at the recorded pace or as fast as the
+ * monitor keeps up, and prints the per-channel statistics afterwards.
+ *
+ * Usage: gpioIntReplay [-f] [-r] <trace file>
+ *   -f  Replay as fast as the monitor drains each channel instead of at the
+ *       original timing
+ *   -r  Re-raise the interrupts a UIO wakeup coalesced (record.missed), each
+ *       as a wakeup of its own
+ */
+
+/* Time given to the workers to drain their queues after the last event */
+#define REPLAY_DRAIN_US 200000
+
+static _Atomic uint64_t *g_replay_callbacks = NULL;
+
+/**
+ * @brief Count delivered events
+ * @param event Delivered event
+ */
+static void replay_callback(const GpioIntEvent *event)
+{
+    atomic_fetch_add_explicit(&g_replay_callbacks[event->channel], 1, memory_order_relaxed);
+}
+
+/**
+ * @brief Get the current CLOCK_MONOTONIC time
+ * @return uint64_t Time in nanoseconds
+ */
+static uint64_t replay_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Sleep until an absolute CLOCK_MONOTONIC time
+ * @param deadline_ns Wakeup time in nanoseconds
+ */
+static void replay_sleep_until(uint64_t deadline_ns)
+{
+    struct timespec ts = {
+        .tv_sec = (time_t)(deadline_ns / 1000000000ull),
+        .tv_nsec = (long)(deadline_ns % 1000000000ull),
+    };
+    
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+}
+
+/**
+ * @brief Map a trace file and validate its header
+ * @param path Trace file
+ * @param len Output: mapping length
+ * @return const GpioIntTraceHeader* Mapped trace, NULL on failure
+ */
+static const GpioIntTraceHeader *replay_open(const char *path, size_t *len)
+{
+    struct stat st;
+    
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0 || fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(GpioIntTraceHeader)) {
+        fprintf(stderr, "%s: cannot read trace\n", path);
+        if (fd >= 0) {
+            close(fd);
+        }
+        return NULL;
+    }
+    
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "%s: cannot map trace\n", path);
+        return NULL;
+    }
+    
+    const GpioIntTraceHeader *trace = map;
+    size_t need = sizeof(*trace) + (size_t)trace->capacity * sizeof(GpioIntTraceRecord);
+    if (trace->magic != GPIO_INT_TRACE_MAGIC || trace->version != GPIO_INT_TRACE_VERSION ||
+        trace->record_size != sizeof(GpioIntTraceRecord) || trace->capacity == 0 ||
+        (trace->capacity & (trace->capacity - 1)) != 0 || need > (size_t)st.st_size) {
+        fprintf(stderr, "%s: not a GPIO interrupt trace (version %u)\n", path, GPIO_INT_TRACE_VERSION);
+        munmap(map, (size_t)st.st_size);
+        return NULL;
+    }
+    
+    *len = (size_t)st.st_size;
+    return trace;
+}
+
+/**
+ * @brief Copy the complete records of a trace in recording order
+ * @param trace Mapped trace
+ * @param cnt Output: number of records
+ * @return GpioIntTraceRecord* Records (caller frees), NULL on failure
+ *
+ * Only the last capacity records survive in the ring. Records whose seq does
+ * not match their position were torn or overwritten and are skipped.
+ */
+static GpioIntTraceRecord *replay_load(const GpioIntTraceHeader *trace, uint32_t *cnt)
+{
+    const GpioIntTraceRecord *ring = (const GpioIntTraceRecord *)(trace + 1);
+    uint64_t head = trace->head;
+    uint64_t first = (head > trace->capacity) ? head - trace->capacity : 0;
+    uint32_t n = 0;
+    
+    GpioIntTraceRecord *records = malloc((size_t)(head - first + 1) * sizeof(*records));
+    if (!records) {
+        return NULL;
+    }
+    
+    for (uint64_t i = first; i < head; i++) {
+        const GpioIntTraceRecord *rec = &ring[i & (trace->capacity - 1)];
+        
+        if (rec->seq == (uint32_t)(i + 1)) {
+            records[n++] = *rec;
+        }
+    }
+    
+    *cnt = n;
+    return records;
+}
+
+/**
+ * @brief Build a simulated channel table covering every channel of a trace
+ * @param records Trace records
+ * @param cnt Number of records
+ * @param ctx Output context
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ *
+ * Channels that recorded edges replay in edge mode, all others in UIO mode.
+ */
+static uint8_t replay_build_ctx(const GpioIntTraceRecord *records, uint32_t cnt, GpioIntCtx *ctx)
+{
+    uint16_t int_cnt = 0;
+    
+    for (uint32_t i = 0; i < cnt; i++) {
+        if (records[i].channel >= int_cnt) {
+            int_cnt = records[i].channel + 1;
+        }
+    }
+    
+    uint8_t ret = gpio_int_ctx_alloc(ctx, int_cnt);
+    if (ret != DIS_COMMON_ERR_OK) {
+        return ret;
+    }
+    
+    for (uint32_t i = 0; i < cnt; i++) {
+        GpioIntChannel *ch = &ctx->ch[records[i].channel];
+        
+        gpio_int_ctx_set_enabled(ctx, records[i].channel, 1);
+        snprintf(ch->pin_cfg.consumer, sizeof(ch->pin_cfg.consumer), "replay%u", records[i].channel);
+        if (records[i].edge != GPIO_INT_EDGE_NONE) {
+            ch->pin_cfg.mode = GPIO_INT_MODE_EDGE;
+        }
+    }
+    
+    return DIS_COMMON_ERR_OK;
+}
+
+/**
+ * @brief Print the statistics of every replayed channel
+ * @param ctx Replayed channel table
+ * @param recorded Records per channel
+ */
+static void replay_report(const GpioIntCtx *ctx, const uint64_t *recorded)
+{
+    printf("%-4s %10s %10s %10s %10s %10s %10s %10s %10s\n", "ch", "recorded", "irqs", "missed",
+           "drops", "callbacks", "w2d_p50", "w2d_p99", "w2d_max");
+    
+    for (uint16_t i = 0; i < ctx->int_cnt; i++) {
+        GpioIntStats stats;
+        
+        if (!gpio_int_ctx_is_enabled(ctx, i) || gpio_int_get_stats(i, &stats) != DIS_COMMON_ERR_OK) {
+            continue;
+        }
+        
+        printf("%-4u %10llu %10llu %10llu %10llu %10llu %10llu %10llu %10llu\n", i,
+               (unsigned long long)recorded[i], (unsigned long long)stats.interrupts,
+               (unsigned long long)stats.missed, (unsigned long long)stats.drops,
+               (unsigned long long)atomic_load(&g_replay_callbacks[i]),
+               (unsigned long long)stats.wake_to_dispatch.p50_ns,
+               (unsigned long long)stats.wake_to_dispatch.p99_ns,
+               (unsigned long long)stats.wake_to_dispatch.max_ns);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool fast = false;
+    bool reraise = false;
+    int opt;
+    
+    while ((opt = getopt(argc, argv, "fr")) != -1) {
+        if (opt == 'f') {
+            fast = true;
+        } else if (opt == 'r') {
+            reraise = true;
+        } else {
+            break;
+        }
+    }
+    if (optind != argc - 1) {
+        fprintf(stderr, "Usage: %s [-f] [-r] <trace file>\n", argv[0]);
+        return 2;
+    }
+    
+    size_t map_len;
+    const GpioIntTraceHeader *trace = replay_open(argv[optind], &map_len);
+    if (!trace) {
+        return 1;
+    }
+    
+    uint32_t cnt;
+    GpioIntTraceRecord *records = replay_load(trace, &cnt);
+    munmap((void *)trace, map_len);
+    if (!records || cnt == 0) {
+        fprintf(stderr, "%s: no complete records\n", argv[optind]);
+        free(records);
+        return 1;
+    }
+    
+    GpioIntCtx ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    if (replay_build_ctx(records, cnt, &ctx) != DIS_COMMON_ERR_OK) {
+        free(records);
+        return 1;
+    }
+    
+    uint64_t *recorded = calloc(ctx.int_cnt, sizeof(*recorded));
+    g_replay_callbacks = calloc(ctx.int_cnt, sizeof(*g_replay_callbacks));
+    if (!recorded || !g_replay_callbacks) {
+        return 1;
+    }
+    
+    gpio_int_set_backend(&g_gpio_int_sim_backend);
+    if (gpio_int_system_init_with_ctx(&ctx) != DIS_COMMON_ERR_OK) {
+        fprintf(stderr, "Failed to start the GPIO interrupt system\n");
+        return 1;
+    }
+    for (uint16_t i = 0; i < ctx.int_cnt; i++) {
+        if (gpio_int_ctx_is_enabled(&ctx, i)) {
+            gpio_int_register_event_callback(i, replay_callback);
+        }
+    }
+    
+    uint64_t start_ns = replay_now_ns();
+    
+    for (uint32_t i = 0; i < cnt; i++) {
+        const GpioIntTraceRecord *rec = &records[i];
+        
+        if (!fast) {
+            replay_sleep_until(start_ns + (rec->timestamp_ns - records[0].timestamp_ns));
+        } else {
+            /* Only coalesce what the recording coalesced: wait for the monitor to take the last one */
+            while (gpio_int_sim_busy(rec->channel)) {
+                sched_yield();
+            }
+        }
+        
+        /* The sim does not count interrupts raised while masked, so each one
+         * the recorded wakeup coalesced is raised once the channel is free */
+        if (reraise) {
+            for (uint32_t m = 0; m < rec->missed; m++) {
+                gpio_int_sim_raise_irq(rec->channel);
+                while (gpio_int_sim_busy(rec->channel)) {
+                    sched_yield();
+                }
+            }
+        }
+        
+        gpio_int_sim_inject(rec->channel, rec->gpio_value);
+        recorded[rec->channel]++;
+    }
+    
+    uint64_t elapsed_ns = replay_now_ns() - start_ns;
+    usleep(REPLAY_DRAIN_US);
+    
+    printf("Replayed %u records in %.3f ms (recorded span %.3f ms)%s\n", cnt, elapsed_ns / 1e6,
+           (records[cnt - 1].timestamp_ns - records[0].timestamp_ns) / 1e6, fast ? ", fast" : "");
+    replay_report(&ctx, recorded);
+    
+    gpio_int_system_deinit();
+    gpio_int_ctx_free(&ctx);
+    free(recorded);
+    free(g_replay_callbacks);
+    free(records);
+    return 0;
+}
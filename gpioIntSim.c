@@ -0,0 +1,471 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <time.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include "gpioIntSim.h"
+#include "dis_dfe8219_log.h"
+
+/**
+ * @brief Simulated channel state
+ */
+typedef struct {
+    int             fd;             /* eventfd standing in for the UIO or gpiod event fd */
+    bool            active;         /* eventfd has been created */
+    uint8_t         mode;           /* GpioIntAcqMode of the channel */
+    int             value;          /* Current simulated line value */
+    bool            irq_enabled;    /* IRQ armed (UIO semantics) */
+    bool            irq_pending;    /* Interrupt latched while masked */
+    uint32_t        icount;         /* Interrupts fired so far */
+    volatile uint32_t *datain;      /* Data-in register word in the file-backed map, NULL if unmapped */
+    uint32_t        datain_bit;     /* Bit of the line in *datain */
+    GpioIntEvent    edges[GPIO_INT_SIM_EDGE_DEPTH]; /* Pending edge events */
+    uint32_t        edge_head;
+    uint32_t        edge_tail;
+} SimChannel;
+
+static SimChannel *g_sim_channel = NULL;
+static uint16_t g_sim_channel_cnt = 0;
+static pthread_mutex_t g_sim_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* ========== Private Helper Functions ========== */
+
+/**
+ * @brief Grow the simulated channel table to hold cnt channels
+ * @param cnt Number of channels
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * Must be called with g_sim_mutex held.
+ */
+static uint8_t sim_reserve(uint16_t cnt)
+{
+    if (cnt <= g_sim_channel_cnt) {
+        return DIS_COMMON_ERR_OK;
+    }
+    
+    SimChannel *table = realloc(g_sim_channel, cnt * sizeof(*table));
+    if (!table) {
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    memset(&table[g_sim_channel_cnt], 0, (cnt - g_sim_channel_cnt) * sizeof(*table));
+    for (uint16_t i = g_sim_channel_cnt; i < cnt; i++) {
+        table[i].fd = -1;
+    }
+    
+    g_sim_channel = table;
+    g_sim_channel_cnt = cnt;
+    return DIS_COMMON_ERR_OK;
+}
+
+/**
+ * @brief Set the simulated line value, mirroring it into the data-in register
+ * @param sim Simulated channel (g_sim_mutex held)
+ * @param value Line value (0 or 1)
+ */
+static void sim_store_value(SimChannel *sim, int value)
+{
+    sim->value = value;
+    
+    if (sim->datain) {
+        uint32_t mask = 1u << sim->datain_bit;
+        *sim->datain = value ? (*sim->datain | mask) : (*sim->datain & ~mask);
+    }
+}
+
+/**
+ * @brief Back the UIO register map of a channel with an unlinked temporary file
+ * @param ch Channel table entry, regs and regs_len are set on success
+ * @param sim Simulated channel (g_sim_mutex held)
+ * 
+ * Failure is not fatal, the channel then reads the value through get_value.
+ */
+static void sim_map_regs(GpioIntChannel *ch, SimChannel *sim)
+{
+    char path[] = "/tmp/gpioIntSimRegsXXXXXX";
+    long page = sysconf(_SC_PAGESIZE);
+    size_t end = GPIO_INT_DATAIN_OFFSET(&ch->pin_cfg) + sizeof(uint32_t);
+    size_t len = (end + (size_t)page - 1) & ~((size_t)page - 1);
+    
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "Simulated backend failed to create register file\n");
+        return;
+    }
+    unlink(path);
+    
+    void *regs = MAP_FAILED;
+    if (ftruncate(fd, (off_t)len) == 0) {
+        regs = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    
+    if (regs == MAP_FAILED) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "Simulated backend failed to map register file\n");
+        return;
+    }
+    
+    ch->regs = regs;
+    ch->regs_len = len;
+    sim->datain = (volatile uint32_t *)((uint8_t *)regs + GPIO_INT_DATAIN_OFFSET(&ch->pin_cfg));
+    sim->datain_bit = ch->pin_cfg.group_bit % 32u;
+    sim_store_value(sim, sim->value);
+}
+
+/**
+ * @brief Signal the channel eventfd
+ * @param sim Simulated channel (g_sim_mutex held)
+ */
+static void sim_signal(SimChannel *sim)
+{
+    uint64_t one = 1;
+    if (write(sim->fd, &one, sizeof(one)) != sizeof(one)) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Simulated backend failed to signal eventfd\n");
+    }
+}
+
+/**
+ * @brief Create the eventfd of a simulated channel
+ * @param sim Simulated channel
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ */
+static uint8_t sim_open_fd(SimChannel *sim)
+{
+    if (sim->active) {
+        return DIS_COMMON_ERR_OK;
+    }
+    
+    sim->fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (sim->fd < 0) {
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    sim->active = true;
+    return DIS_COMMON_ERR_OK;
+}
+
+/**
+ * @brief Queue a simulated edge event for the current line value
+ * @param sim Simulated channel (g_sim_mutex held)
+ */
+static void sim_queue_edge(SimChannel *sim)
+{
+    struct timespec ts;
+    
+    if (sim->edge_tail - sim->edge_head >= GPIO_INT_SIM_EDGE_DEPTH) {
+        return; /* FIFO full: the kernel drops new events as well */
+    }
+    
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    GpioIntEvent *event = &sim->edges[sim->edge_tail % GPIO_INT_SIM_EDGE_DEPTH];
+    memset(event, 0, sizeof(*event));
+    event->edge = sim->value ? GPIO_INT_EDGE_RISING : GPIO_INT_EDGE_FALLING;
+    event->gpio_value = sim->value;
+    event->timestamp_ns = (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+    sim->edge_tail++;
+    
+    sim_signal(sim);
+}
+
+/**
+ * @brief Raise an interrupt on a simulated channel
+ * @param sim Simulated channel (g_sim_mutex held)
+ */
+static void sim_raise(SimChannel *sim)
+{
+    if (sim->mode == GPIO_INT_MODE_EDGE) {
+        sim->icount++;
+        sim_queue_edge(sim);
+        return;
+    }
+    
+    /* UIO masks the IRQ when it fires until user space re-enables it. Like
+     * uio_pdrv_genirq the masked line is disabled, so raises only latch one
+     * pending interrupt that is counted when it fires on re-enable */
+    if (sim->irq_enabled) {
+        sim->irq_enabled = false;
+        sim->icount++;
+        sim_signal(sim);
+    } else {
+        sim->irq_pending = true;
+    }
+}
+
+/* ========== Backend Operations ========== */
+
+/**
+ * @brief Create the eventfd standing in for /dev/uioN and the register file
+ */
+static uint8_t sim_init_irq(GpioIntCtx *ctx, uint16_t channel)
+{
+    uint8_t ret;
+    
+    pthread_mutex_lock(&g_sim_mutex);
+    ret = sim_reserve(ctx->int_cnt);
+    if (ret == DIS_COMMON_ERR_OK) {
+        SimChannel *sim = &g_sim_channel[channel];
+        ret = sim_open_fd(sim);
+        ctx->ch[channel].fd = sim->fd;
+        if (ret == DIS_COMMON_ERR_OK && ctx->ch[channel].pin_cfg.datain_mmio) {
+            sim_map_regs(&ctx->ch[channel], sim);
+        }
+    }
+    pthread_mutex_unlock(&g_sim_mutex);
+    
+    return ret;
+}
+
+/**
+ * @brief Reset the simulated line, creating the event fd in edge mode
+ */
+static uint8_t sim_init_line(GpioIntCtx *ctx, uint16_t channel)
+{
+    uint8_t ret;
+    
+    pthread_mutex_lock(&g_sim_mutex);
+    ret = sim_reserve(ctx->int_cnt);
+    if (ret != DIS_COMMON_ERR_OK) {
+        pthread_mutex_unlock(&g_sim_mutex);
+        return ret;
+    }
+    
+    SimChannel *sim = &g_sim_channel[channel];
+    sim->mode = ctx->ch[channel].pin_cfg.mode;
+    sim->irq_enabled = false;
+    sim->irq_pending = false;
+    sim->icount = 0;
+    sim->edge_head = 0;
+    sim->edge_tail = 0;
+    if (sim->mode == GPIO_INT_MODE_EDGE) {
+        ret = sim_open_fd(sim);
+    }
+    pthread_mutex_unlock(&g_sim_mutex);
+    
+    return ret;
+}
+
+/**
+ * @brief Close the simulated channel
+ */
+static void sim_release(GpioIntCtx *ctx, uint16_t channel)
+{
+    pthread_mutex_lock(&g_sim_mutex);
+    if (channel >= g_sim_channel_cnt) {
+        pthread_mutex_unlock(&g_sim_mutex);
+        return;
+    }
+    
+    SimChannel *sim = &g_sim_channel[channel];
+    if (sim->active) {
+        close(sim->fd);
+    }
+    sim->fd = -1;
+    sim->active = false;
+    sim->irq_enabled = false;
+    sim->irq_pending = false;
+    sim->datain = NULL;
+    if (ctx->ch[channel].regs) {
+        munmap(ctx->ch[channel].regs, ctx->ch[channel].regs_len);
+    }
+    ctx->ch[channel].fd = -1;
+    ctx->ch[channel].line = NULL;
+    ctx->ch[channel].datain = NULL;
+    ctx->ch[channel].regs = NULL;
+    ctx->ch[channel].regs_len = 0;
+    pthread_mutex_unlock(&g_sim_mutex);
+}
+
+/**
+ * @brief Consume the interrupt and report the simulated icount
+ */
+static int sim_read_irq(GpioIntCtx *ctx, uint16_t channel, uint32_t *icount)
+{
+    uint64_t kicks;
+    
+    if (read(ctx->ch[channel].fd, &kicks, sizeof(kicks)) != sizeof(kicks)) {
+        return -1;
+    }
+    
+    pthread_mutex_lock(&g_sim_mutex);
+    *icount = g_sim_channel[channel].icount;
+    pthread_mutex_unlock(&g_sim_mutex);
+    
+    return (int)sizeof(*icount);
+}
+
+/**
+ * @brief Re-arm the simulated IRQ, firing a latched interrupt immediately
+ */
+static int sim_enable_irq(GpioIntCtx *ctx, uint16_t channel)
+{
+    (void)ctx;
+    
+    pthread_mutex_lock(&g_sim_mutex);
+    SimChannel *sim = &g_sim_channel[channel];
+    if (sim->irq_pending) {
+        /* The latched interrupt fires right away and masks the IRQ again */
+        sim->irq_pending = false;
+        sim->icount++;
+        sim_signal(sim);
+    } else {
+        sim->irq_enabled = true;
+    }
+    pthread_mutex_unlock(&g_sim_mutex);
+    
+    return 0;
+}
+
+/**
+ * @brief Read the simulated line value
+ */
+static int sim_get_value(GpioIntCtx *ctx, uint16_t channel)
+{
+    (void)ctx;
+    
+    pthread_mutex_lock(&g_sim_mutex);
+    int value = g_sim_channel[channel].value;
+    pthread_mutex_unlock(&g_sim_mutex);
+    
+    return value;
+}
+
+/**
+ * @brief Get the simulated edge event fd
+ */
+static int sim_get_event_fd(GpioIntCtx *ctx, uint16_t channel)
+{
+    (void)ctx;
+    
+    pthread_mutex_lock(&g_sim_mutex);
+    int fd = g_sim_channel[channel].fd;
+    pthread_mutex_unlock(&g_sim_mutex);
+    
+    return fd;
+}
+
+/**
+ * @brief Pop up to max simulated edge events
+ */
+static int sim_read_events(GpioIntCtx *ctx, uint16_t channel, GpioIntEvent *events, unsigned int max)
+{
+    uint64_t kicks;
+    unsigned int n = 0;
+    (void)ctx;
+    
+    pthread_mutex_lock(&g_sim_mutex);
+    SimChannel *sim = &g_sim_channel[channel];
+    if (read(sim->fd, &kicks, sizeof(kicks)) != sizeof(kicks)) {
+        kicks = 0;
+    }
+    
+    while (n < max && sim->edge_head != sim->edge_tail) {
+        events[n++] = sim->edges[sim->edge_head % GPIO_INT_SIM_EDGE_DEPTH];
+        sim->edge_head++;
+    }
+    
+    /* Keep the fd readable while events remain */
+    if (sim->edge_head != sim->edge_tail) {
+        sim_signal(sim);
+    }
+    pthread_mutex_unlock(&g_sim_mutex);
+    
+    return (int)n;
+}
+
+/**
+ * @brief Snapshot all simulated line values under one lock
+ */
+static void sim_read_all(GpioIntCtx *ctx, int *values)
+{
+    pthread_mutex_lock(&g_sim_mutex);
+    for (uint16_t i = 0; i < ctx->int_cnt && i < g_sim_channel_cnt; i++) {
+        if (gpio_int_ctx_is_enabled(ctx, i)) {
+            values[i] = g_sim_channel[i].value;
+        }
+    }
+    pthread_mutex_unlock(&g_sim_mutex);
+}
+
+const GpioIntBackendOps g_gpio_int_sim_backend = {
+    .name         = "sim",
+    .init_irq     = sim_init_irq,
+    .init_line    = sim_init_line,
+    .release      = sim_release,
+    .read_irq     = sim_read_irq,
+    .enable_irq   = sim_enable_irq,
+    .get_value    = sim_get_value,
+    .get_event_fd = sim_get_event_fd,
+    .read_events  = sim_read_events,
+    .init_lines   = NULL,
+    .read_all     = sim_read_all,
+};
+
+/* ========== Public API Functions ========== */
+
+uint8_t gpio_int_sim_set_value(uint16_t channel, int value)
+{
+    pthread_mutex_lock(&g_sim_mutex);
+    if (channel >= g_sim_channel_cnt) {
+        pthread_mutex_unlock(&g_sim_mutex);
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
+    sim_store_value(&g_sim_channel[channel], value ? 1 : 0);
+    pthread_mutex_unlock(&g_sim_mutex);
+    
+    return DIS_COMMON_ERR_OK;
+}
+
+uint8_t gpio_int_sim_raise_irq(uint16_t channel)
+{
+    pthread_mutex_lock(&g_sim_mutex);
+    if (channel >= g_sim_channel_cnt || !g_sim_channel[channel].active) {
+        pthread_mutex_unlock(&g_sim_mutex);
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    sim_raise(&g_sim_channel[channel]);
+    pthread_mutex_unlock(&g_sim_mutex);
+    
+    return DIS_COMMON_ERR_OK;
+}
+
+uint8_t gpio_int_sim_inject(uint16_t channel, int value)
+{
+    pthread_mutex_lock(&g_sim_mutex);
+    if (channel >= g_sim_channel_cnt || !g_sim_channel[channel].active) {
+        pthread_mutex_unlock(&g_sim_mutex);
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    SimChannel *sim = &g_sim_channel[channel];
+    value = value ? 1 : 0;
+    bool changed = (sim->value != value);
+    sim_store_value(sim, value);
+    if (changed || sim->mode != GPIO_INT_MODE_EDGE) {
+        sim_raise(sim);
+    }
+    pthread_mutex_unlock(&g_sim_mutex);
+    
+    return DIS_COMMON_ERR_OK;
+}
+
+uint8_t gpio_int_sim_busy(uint16_t channel)
+{
+    uint8_t busy = 0;
+    
+    pthread_mutex_lock(&g_sim_mutex);
+    if (channel < g_sim_channel_cnt && g_sim_channel[channel].active) {
+        SimChannel *sim = &g_sim_channel[channel];
+        if (sim->mode == GPIO_INT_MODE_EDGE) {
+            busy = (sim->edge_tail - sim->edge_head >= GPIO_INT_SIM_EDGE_DEPTH);
+        } else {
+            busy = !sim->irq_enabled;
+        }
+    }
+    pthread_mutex_unlock(&g_sim_mutex);
+    
+    return busy;
+}
@@ -0,0 +1,60 @@
+#ifndef _GPIOINTSIM_H_
+#define _GPIOINTSIM_H_
+
+#include <stdint.h>
+#include "gpioInterrupt.h"
+
+/* Depth of the simulated per-channel edge event FIFO */
+#define GPIO_INT_SIM_EDGE_DEPTH 64
+
+/**
+ * @brief Simulated backend: eventfds stand in for /dev/uioN and gpiod
+ *
+ * Select it with gpio_int_set_backend(&g_gpio_int_sim_backend) and start the
+ * system with gpio_int_system_init_with_ctx() to run the monitor thread,
+ * dispatch and shutdown on any Linux host. Interrupts follow UIO semantics:
+ * a raised interrupt masks the IRQ until the monitor thread re-enables it.
+ * As with uio_pdrv_genirq the masked line is disabled: interrupts raised
+ * meanwhile latch a single pending one, counted in icount when it fires on
+ * re-enable.
+ * Channels with datain_mmio get an unlinked temporary file as UIO map 0,
+ * kept in sync with the line value, to exercise the register read path.
+ */
+extern const GpioIntBackendOps g_gpio_int_sim_backend;
+
+/**
+ * @brief Set the simulated line value without raising an interrupt
+ * @param channel GPIO interrupt channel number
+ * @param value Line value (0 or 1)
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ */
+uint8_t gpio_int_sim_set_value(uint16_t channel, int value);
+
+/**
+ * @brief Raise a simulated interrupt on a channel
+ * @param channel GPIO interrupt channel number
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * In edge mode this queues an edge event for the current line value.
+ */
+uint8_t gpio_int_sim_raise_irq(uint16_t channel);
+
+/**
+ * @brief Set the simulated line value and raise an interrupt
+ * @param channel GPIO interrupt channel number
+ * @param value Line value (0 or 1)
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * In edge mode an event is only generated when the value changes.
+ */
+uint8_t gpio_int_sim_inject(uint16_t channel, int value);
+
+/**
+ * @brief Check whether a simulated channel is still busy with earlier interrupts
+ * @param channel GPIO interrupt channel number
+ * @return uint8_t 1 if another interrupt would coalesce (UIO IRQ still masked)
+ *         or be dropped (edge FIFO full), 0 otherwise
+ */
+uint8_t gpio_int_sim_busy(uint16_t channel);
+
+#endif
@@ -0,0 +1,34 @@
+/* Generated by gpioIntTableGen.py from gpioIntService.txt, do not edit */
+
+#include "gpioInterrupt.h"
+
+const uint16_t g_gpio_int_static_cnt = 3;
+
+const uint64_t g_gpio_int_static_enable[1] = { 0x7ull };
+
+const GpioIntChannel g_gpio_int_static_ch[3] = {
+    [0] = {
+        .pin_cfg = { .group_id = 4, .group_bit = 7, .uio_index = 2, .consumer = "PAP Service", .mode = GPIO_INT_MODE_UIO },
+        .overflow_policy = GPIO_INT_OVERFLOW_QUEUE,
+        .shard = 0,
+        .fd = -1,
+    },
+    [1] = {
+        .pin_cfg = { .group_id = 4, .group_bit = 8, .uio_index = 3, .consumer = "PAP Service", .mode = GPIO_INT_MODE_UIO },
+        .overflow_policy = GPIO_INT_OVERFLOW_QUEUE,
+        .shard = 0,
+        .fd = -1,
+    },
+    [2] = {
+        .pin_cfg = { .group_id = 4, .group_bit = 20, .uio_index = 4, .consumer = "power_drop", .mode = GPIO_INT_MODE_UIO },
+        .overflow_policy = GPIO_INT_OVERFLOW_QUEUE,
+        .shard = 0,
+        .priority = GPIO_INT_PRIO_CRITICAL,
+        .dispatch = GPIO_INT_DISPATCH_WORKER,
+        .fd = -1,
+    },
+};
+
+const GpioIntRuleCfg g_gpio_int_static_rule[16] = {
+    { 0 },
+};
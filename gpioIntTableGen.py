@@ -0,0 +1,248 @@
+#!/usr/bin/env python3
+"""Generate the compile-time GPIO interrupt channel table from gpioIntService.txt.
+
+Usage: gpioIntTableGen.py [gpioIntService.txt] [gpioIntTable.c]
+
+The output defines the table used by gpio_int_system_init_static(). It applies
+the same defaults and range checks as gpio_int_ctx_from_db(), so both init
+paths bring up identical channels. Regenerate and commit gpioIntTable.c
+whenever gpioIntService.txt changes.
+"""
+
+import os
+import re
+import sys
+
+MAX_CHANNELS = 1024
+CONSUMER_LEN = 16
+MAX_RULES = 16
+RULE_MAX_TERMS = 4
+
+MODE_EDGE = 1
+OVERFLOW_MERGE = 2
+FILTER_FALLING = 2
+PRIO_CRITICAL = 1
+DISPATCH_INLINE = 1
+STORM_POLL_US = 10000
+
+MODE_NAMES = ["GPIO_INT_MODE_UIO", "GPIO_INT_MODE_EDGE"]
+POLICY_NAMES = ["GPIO_INT_OVERFLOW_QUEUE", "GPIO_INT_OVERFLOW_LATEST", "GPIO_INT_OVERFLOW_MERGE"]
+FILTER_NAMES = ["GPIO_INT_FILTER_BOTH", "GPIO_INT_FILTER_RISING", "GPIO_INT_FILTER_FALLING"]
+PRIO_NAMES = ["GPIO_INT_PRIO_NORMAL", "GPIO_INT_PRIO_CRITICAL"]
+DISPATCH_NAMES = ["GPIO_INT_DISPATCH_WORKER", "GPIO_INT_DISPATCH_INLINE"]
+RULE_OP_NAMES = ["GPIO_INT_RULE_AND", "GPIO_INT_RULE_OR", "GPIO_INT_RULE_SEQ"]
+
+LINE_RE = re.compile(r'^(/GPIOINT/\S+)\s+(.*?)\s*$')
+
+
+def fail(path, msg):
+    sys.exit("%s: %s" % (path, msg))
+
+
+def parse(path):
+    """Return {key: value} where value is a string or a list of ints."""
+    keys = {}
+    with open(path) as f:
+        for lineno, raw in enumerate(f, 1):
+            line = raw.strip()
+            if not line or line.startswith('#'):
+                continue
+            m = LINE_RE.match(line)
+            if not m:
+                fail(path, "line %d: cannot parse '%s'" % (lineno, line))
+            key, value = m.groups()
+            if value.startswith('"'):
+                if not value.endswith('"') or len(value) < 2:
+                    fail(path, "line %d: unterminated string" % lineno)
+                keys[key] = value[1:-1]
+            else:
+                try:
+                    keys[key] = [int(v, 0) for v in value.split(',')]
+                except ValueError:
+                    fail(path, "line %d: bad number list '%s'" % (lineno, value))
+                if any(v < 0 or v > 255 for v in keys[key]):
+                    fail(path, "line %d: values must fit in a byte" % lineno)
+    return keys
+
+
+def u8(keys, key, default=None, upper=255):
+    """Return the first byte of an optional key, default if missing or out of range."""
+    value = keys.get(key)
+    if not isinstance(value, list) or value[0] > upper:
+        return default
+    return value[0]
+
+
+def u16(keys, key):
+    """Return an optional big-endian 2-byte key, 0 if missing."""
+    value = keys.get(key)
+    if not isinstance(value, list) or len(value) < 2:
+        return 0
+    return (value[0] << 8) | value[1]
+
+
+def channel_entry(path, keys, ch, enabled):
+    prefix = "/GPIOINT/ch%d/" % ch
+    pin_cfg = keys.get(prefix + "pin_cfg")
+    consumer = keys.get(prefix + "consumer")
+
+    if pin_cfg is None and consumer is None:
+        if enabled:
+            fail(path, "channel %d is enabled but has no pin_cfg/consumer" % ch)
+        return None
+    if not isinstance(pin_cfg, list) or len(pin_cfg) < 3:
+        fail(path, "%spin_cfg needs group_id, group_bit, uio_index" % prefix)
+    if not isinstance(consumer, str):
+        fail(path, "%sconsumer must be a string" % prefix)
+    if len(consumer.encode()) >= CONSUMER_LEN:
+        fail(path, "%sconsumer exceeds %d characters" % (prefix, CONSUMER_LEN - 1))
+
+    mode = u8(keys, prefix + "mode", 0, MODE_EDGE)
+    policy = u8(keys, prefix + "overflow_policy", 0, OVERFLOW_MERGE)
+    shard = u8(keys, prefix + "shard", 0)
+    priority = u8(keys, prefix + "priority", 0, PRIO_CRITICAL)
+    dispatch = u8(keys, prefix + "dispatch", 0, DISPATCH_INLINE)
+    debounce_ms = u8(keys, prefix + "debounce_ms", 0)
+    min_pulse_us = u8(keys, prefix + "min_pulse_us", 0)
+    edge_filter = u8(keys, prefix + "edge_filter", 0, FILTER_FALLING)
+    datain = keys.get(prefix + "datain_reg")
+    storm_rate = keys.get(prefix + "storm_rate")
+    storm_rate = (storm_rate[0] << 8) | storm_rate[1] if isinstance(storm_rate, list) and len(storm_rate) >= 2 else 0
+    storm_window_ms = u8(keys, prefix + "storm_window_ms", 0)
+    storm_poll_ms = u8(keys, prefix + "storm_poll_ms", 0)
+    if storm_rate and storm_rate * (storm_poll_ms * 1000 or STORM_POLL_US) <= 1000000:
+        storm_rate = 0
+    counter_window_ms = u16(keys, prefix + "counter_window_ms")
+
+    pin = [
+        ".group_id = %d" % pin_cfg[0],
+        ".group_bit = %d" % pin_cfg[1],
+        ".uio_index = %d" % pin_cfg[2],
+        '.consumer = "%s"' % consumer.replace('\\', '\\\\').replace('"', '\\"'),
+        ".mode = %s" % MODE_NAMES[mode],
+    ]
+    if isinstance(datain, list) and len(datain) >= 2:
+        pin += [".datain_mmio = 1", ".datain_reg = 0x%04x" % ((datain[0] << 8) | datain[1])]
+
+    lines = [
+        "    [%d] = {" % ch,
+        "        .pin_cfg = { %s }," % ", ".join(pin),
+        "        .overflow_policy = %s," % POLICY_NAMES[policy],
+        "        .shard = %d," % shard,
+    ]
+    if priority or dispatch:
+        lines += [
+            "        .priority = %s," % PRIO_NAMES[priority],
+            "        .dispatch = %s," % DISPATCH_NAMES[dispatch],
+        ]
+    if debounce_ms or min_pulse_us or edge_filter:
+        lines.append("        .filter = { .debounce_us = %d, .min_pulse_us = %d, .edge_filter = %s }," %
+                     (debounce_ms * 1000, min_pulse_us, FILTER_NAMES[edge_filter]))
+    if storm_rate:
+        lines.append("        .storm = { .max_rate = %d, .window_us = %d, .poll_us = %d }," %
+                     (storm_rate, storm_window_ms * 1000, storm_poll_ms * 1000))
+    if counter_window_ms:
+        lines.append("        .counter = { .window_us = %d }," % (counter_window_ms * 1000))
+    lines += [
+        "        .fd = -1,",
+        "    },",
+    ]
+    return "\n".join(lines)
+
+
+def rule_entry(path, keys, rule, int_cnt):
+    prefix = "/GPIOINT/rule%d/" % rule
+    op = u8(keys, prefix + "op")
+    if op is None:
+        return None
+    if op >= len(RULE_OP_NAMES):
+        fail(path, "%sop out of range" % prefix)
+
+    term_cnt = u8(keys, prefix + "term_cnt", 0)
+    terms = keys.get(prefix + "terms")
+    if not 1 <= term_cnt <= RULE_MAX_TERMS:
+        fail(path, "%sterm_cnt must be 1..%d" % (prefix, RULE_MAX_TERMS))
+    if not isinstance(terms, list) or len(terms) < 2 * term_cnt:
+        fail(path, "%sterms needs %d channel, level pairs" % (prefix, term_cnt))
+    pairs = [(terms[2 * i], terms[2 * i + 1]) for i in range(term_cnt)]
+    if any(ch >= int_cnt or level > 1 for ch, level in pairs):
+        fail(path, "%sterms needs channels below IntCount and levels 0/1" % prefix)
+
+    lines = [
+        "    [%d] = {" % rule,
+        "        .op = %s," % RULE_OP_NAMES[op],
+        "        .term_cnt = %d," % term_cnt,
+        "        .term = { %s }," % ", ".join("{ %d, %d }" % pair for pair in pairs),
+    ]
+    window_us = u16(keys, prefix + "window_us")
+    hold_ms = u16(keys, prefix + "hold_ms")
+    if window_us:
+        lines.append("        .window_us = %d," % window_us)
+    if hold_ms:
+        lines.append("        .hold_us = %d," % (hold_ms * 1000))
+    lines.append("    },")
+    return "\n".join(lines)
+
+
+def generate(src, dst):
+    keys = parse(src)
+
+    int_cnt = u8(keys, "/GPIOINT/IntCount")
+    if not int_cnt or int_cnt > MAX_CHANNELS:
+        fail(src, "/GPIOINT/IntCount missing or out of range")
+
+    enable_list = keys.get("/GPIOINT/enable_list")
+    if not isinstance(enable_list, list) or len(enable_list) < int_cnt:
+        fail(src, "/GPIOINT/enable_list needs %d entries" % int_cnt)
+
+    entries = []
+    for ch in range(int_cnt):
+        entry = channel_entry(src, keys, ch, enable_list[ch] != 0)
+        if entry:
+            entries.append(entry)
+
+    rules = []
+    for rule in range(min(u8(keys, "/GPIOINT/RuleCount", 0), MAX_RULES)):
+        entry = rule_entry(src, keys, rule, int_cnt)
+        if entry:
+            rules.append(entry)
+
+    words = (int_cnt + 63) // 64
+    mask = [0] * words
+    for ch in range(int_cnt):
+        if enable_list[ch]:
+            mask[ch // 64] |= 1 << (ch % 64)
+
+    out = [
+        "/* Generated by gpioIntTableGen.py from %s, do not edit */" % os.path.basename(src),
+        "",
+        '#include "gpioInterrupt.h"',
+        "",
+        "const uint16_t g_gpio_int_static_cnt = %d;" % int_cnt,
+        "",
+        "const uint64_t g_gpio_int_static_enable[%d] = { %s };" %
+        (words, ", ".join("0x%xull" % w for w in mask)),
+        "",
+        "const GpioIntChannel g_gpio_int_static_ch[%d] = {" % int_cnt,
+        "\n".join(entries),
+        "};",
+        "",
+        "const GpioIntRuleCfg g_gpio_int_static_rule[%d] = {" % MAX_RULES,
+        "\n".join(rules) if rules else "    { 0 },",
+        "};",
+        "",
+    ]
+
+    with open(dst, "w") as f:
+        f.write("\n".join(out))
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    src = sys.argv[1] if len(sys.argv) > 1 else os.path.join(here, "gpioIntService.txt")
+    dst = sys.argv[2] if len(sys.argv) > 2 else os.path.join(here, "gpioIntTable.c")
+    generate(src, dst)
+
+
+if __name__ == "__main__":
+    main()
@@ -1,637 +1,6204 @@
+#define _GNU_SOURCE
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <string.h>
+#include <errno.h>
+#include <limits.h>
 #include <pthread.h>
+#include <sched.h>
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <linux/futex.h>
 #include <stdbool.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <poll.h>
+#ifdef GPIO_INT_USE_IO_URING
+#include <liburing.h>
+#endif
 #include "dis_dfe8219_dataBase.h"
 #include "dis_dfe8219_api.h"
 #include "gpioInterrupt.h"
+#include "gpioIntBus.h"
 #include "dis_dfe8219_log.h"
 
 /* Global GPIO interrupt context for system-wide use */
 GpioIntCtx g_gpio_system_ctx;
 static bool g_gpio_system_initialized = false;
 
+/* Active I/O backend */
+static const GpioIntBackendOps *g_gpio_backend = &g_gpio_int_hw_backend;
+
+/* Real-time configuration of the monitor and worker threads */
+static GpioIntRtCfg g_gpio_rt_cfg = {
+    .sched_policy = GPIO_INT_SCHED_OTHER,
+    .monitor_cpu  = GPIO_INT_CPU_ANY,
+    .worker_cpu   = GPIO_INT_CPU_ANY,
+};
+static bool g_gpio_memory_locked = false;
+
+/* Thread stack size used with lock_memory, so locked stacks stay small */
+#define GPIO_INT_RT_STACK_SIZE      (256u * 1024u)
+
+/* Stack depth touched at thread start with lock_memory */
+#define GPIO_INT_RT_PREFAULT_SIZE   (64u * 1024u)
+
+#ifdef GPIO_INT_USE_IO_URING
+/**
+ * @brief io_uring state of one UIO channel in a shard
+ *
+ * want is set by the configuration thread, the other fields belong to the
+ * monitor thread. inflight lets channel removal wait out the posted read.
+ */
+typedef struct {
+    uint32_t            icount;         /* Buffer of the posted UIO read */
+    _Atomic bool        want;           /* Channel is monitored, keep a read posted */
+    bool                armed;          /* A read is posted */
+    bool                cancel_sent;    /* The posted read is being cancelled */
+    _Atomic uint8_t     inflight;       /* Posted reads and re-enable writes not completed yet */
+} UringChannel;
+#endif
+
+/**
+ * @brief One monitor loop: an epoll set with its own thread and wake eventfd
+ *
+ * Channels are split across shards so a slow read or re-enable on one
+ * channel only delays the channels sharing its shard. With the io_uring
+ * loop, the UIO channels of the shard live on the ring and the epoll set
+ * only carries edge channels, filter timers and the wake eventfd.
+ */
+typedef struct {
+    pthread_t           thread;         /* Monitor thread handle */
+    bool                started;        /* Monitor thread has been created */
+    uint8_t             index;          /* Shard number */
+    int                 epoll_fd;       /* epoll set of the shard's channels */
+    int                 wake_fd;        /* eventfd to interrupt a blocking epoll_wait */
+    struct epoll_event  *events;        /* epoll event buffer, sized to the channel table */
+    int                 event_cap;      /* Capacity of events */
+    _Atomic uint64_t    pass;           /* Completed passes, see wait_monitor_pass() */
+    GpioIntEvent        *batch;         /* Events collected for batch subscribers this pass */
+    uint8_t             *batch_subs;    /* Subscriber mask of each collected event */
+    GpioIntEvent        *batch_out;     /* Per-subscriber selection handed to the callback */
+    uint32_t            batch_cnt;      /* Number of collected events */
+    bool                bus_pending;    /* Events published to the bus this pass, wake subscribers */
+    _Atomic uint16_t    critical_cnt;   /* Critical channels on the shard, served first in each pass */
+    bool                use_uring;      /* Shard runs gpio_uring_monitor_thread() */
+#ifdef GPIO_INT_USE_IO_URING
+    struct io_uring     ring;           /* Posted UIO reads, re-enable writes and the epoll poll */
+    UringChannel        *uring_ch;      /* Per-channel ring state, indexed by channel */
+    struct io_uring_cqe **cqes;         /* Completions taken in one pass */
+    unsigned int        cqe_cap;        /* Capacity of cqes */
+    uint16_t            uring_ch_cnt;   /* Entries in uring_ch */
+#endif
+} MonitorShard;
+
 /* GPIO interrupt monitoring thread variables */
-static pthread_t g_gpio_monitor_thread;
-static bool g_gpio_monitor_running = false;
-static int g_gpio_epoll_fd = -1;
+static MonitorShard *g_gpio_monitor = NULL;
+static uint8_t g_gpio_monitor_cnt = 0;
+static _Atomic bool g_gpio_monitor_running = false;
+
+/* epoll data tag of the monitor wake eventfd */
+#define MONITOR_WAKE_TAG UINT32_MAX
+
+/* Waiters for a monitor pass, used to wait out events of a removed channel */
+static _Atomic int g_gpio_monitor_pass_waiters = 0;
+static pthread_mutex_t g_gpio_monitor_pass_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_gpio_monitor_pass_cond = PTHREAD_COND_INITIALIZER;
+
+/* Serializes system init/deinit and runtime channel reconfiguration */
+static pthread_mutex_t g_gpio_config_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Held for writing while lines are requested or released, for reading by gpio_int_read_all() */
+static pthread_rwlock_t g_gpio_line_lock = PTHREAD_RWLOCK_INITIALIZER;
+
+/* Number of channels the per-channel state arrays below are sized for */
+static uint16_t g_channel_state_cnt = 0;
+
+/* UIO icount of the previous wakeup, NO_ICOUNT before the first one */
+#define NO_ICOUNT UINT64_MAX
+
+/**
+ * @brief Delivery state of a channel consumer
+ *
+ * The monitor thread moves the channel to PENDING after queueing an event
+ * and only kicks the consumer's eventfd if it was IDLE. The consumer moves
+ * it to RUNNING while draining and back to IDLE with a compare-and-swap,
+ * which fails if an event was queued meanwhile.
+ */
+typedef enum {
+    CHANNEL_IDLE    = 0,    /* Consumer asleep, the next event must wake it */
+    CHANNEL_RUNNING = 1,    /* Consumer draining the queue */
+    CHANNEL_PENDING = 2,    /* Events queued since the consumer last looked */
+} ChannelDelivery;
+
+/**
+ * @brief Per-channel state touched on every interrupt, one cache line per channel
+ *
+ * Callbacks are published atomically by the registration functions, the
+ * delivery state is shared by the monitor thread and the channel consumer,
+ * and the counters belong to the monitor thread.
+ */
+typedef struct {
+    _Alignas(64) _Atomic(gpio_interrupt_callback_t) callback;
+    _Atomic(gpio_interrupt_wide_callback_t) wide_callback;
+    _Atomic(gpio_interrupt_event_callback_t) event_callback;
+    _Atomic uint8_t     delivery;       /* ChannelDelivery */
+    uint32_t            edge_seq;       /* Edge sequence counter for GPIO_INT_MODE_EDGE */
+    uint64_t            last_icount;    /* UIO icount of the previous wakeup */
+} ChannelHot;
+
+static ChannelHot *g_channel_hot = NULL;
+
+/* ========== Callback Worker Support ========== */
+
+/**
+ * @brief Persistent callback worker for one channel
+ *
+ * A channel with a registered callback owns a long-lived worker thread that
+ * sleeps on an eventfd. The monitor thread queues the event and kicks the
+ * eventfd, so no allocation or thread creation happens on the interrupt
+ * path. A pulled channel has no thread: its consumer drains the queue with
+ * gpio_int_wait() and wake_fd is the event fd handed out to it.
+ */
+typedef struct {
+    pthread_t   thread;         /* Worker thread handle */
+    int         wake_fd;        /* eventfd used to wake the worker or the pull consumer */
+    bool        started;        /* Worker thread has been created */
+    _Atomic bool stop;          /* Request worker thread to exit */
+    _Atomic bool pull;          /* Delivered through gpio_int_wait(), never a worker */
+} CallbackWorker;
+
+static CallbackWorker *g_channel_worker = NULL;
+
+/* ========== Batch Delivery Support ========== */
+
+/**
+ * @brief Batch callback subscriber
+ *
+ * A slot is published by setting its bit in g_batch_active after callback
+ * and arg are written, and retired by clearing it and waiting out a pass on
+ * every shard before the slot is reused.
+ */
+typedef struct {
+    gpio_interrupt_batch_callback_t callback;
+    void                            *arg;
+} BatchSubscriber;
+
+static BatchSubscriber g_batch_subscriber[GPIO_INT_MAX_BATCH_SUBSCRIBERS];
+static _Atomic uint8_t g_batch_active = 0;
+
+/* Per-channel mask of the batch subscribers interested in the channel */
+static _Atomic uint8_t *g_channel_batch_subs = NULL;
+
+/* ========== Trace Recorder Support ========== */
+
+/* Mapped trace file, NULL while not recording */
+static GpioIntTraceHeader *_Atomic g_gpio_trace = NULL;
+static size_t g_gpio_trace_len = 0;
+
+/* Upper bound on trace records, keeps the file below 2 GiB */
+#define GPIO_INT_TRACE_MAX_RECORDS (1u << 26)
+
+/* ========== Event Bus Publisher Support ========== */
+
+/* Mapped bus shared memory object, NULL while not publishing */
+static GpioIntBusHeader *_Atomic g_gpio_bus = NULL;
+static size_t g_gpio_bus_len = 0;
+static char g_gpio_bus_name[NAME_MAX + 1];
+
+/* ========== Glitch Filter Support ========== */
+
+/**
+ * @brief Glitch filter state of one channel
+ *
+ * Owned by the monitor shard servicing the channel. Raw interrupts only
+ * (re)arm the timer; the line is sampled once the timer expires.
+ */
+typedef struct {
+    int         timer_fd;       /* timerfd in the shard's epoll set, -1 without timed filtering */
+    bool        armed;          /* A transition is pending */
+    int         stable_value;   /* Last reported level, -1 before the first sample */
+    int         last_value;     /* Level of the latest raw edge (edge mode) */
+    uint32_t    icount;         /* icount of the latest raw interrupt */
+    uint32_t    raw_cnt;        /* Raw interrupts since the pending transition started */
+    uint32_t    missed;         /* Missed interrupts accumulated while pending */
+    uint64_t    start_ns;       /* Monitor time of the first raw interrupt, for min_pulse_us */
+    uint64_t    first_ts;       /* Event timestamp of the first raw interrupt */
+} ChannelFilter;
+
+static ChannelFilter *g_channel_filter = NULL;
+
+/* epoll data tag bit marking the filter timer of a channel */
+#define FILTER_TIMER_TAG 0x80000000u
+
+/* ========== Storm Protection Support ========== */
+
+/**
+ * @brief Interrupt storm state of one channel
+ *
+ * Owned by the monitor shard servicing the channel. While polling, the
+ * interrupt source is re-armed by the poll timer instead of after each
+ * wakeup; fired tells the timer whether it needs re-arming. The window
+ * counts interrupts. An edge poll reads every edge the kernel kept, so the
+ * rate is measured while polling too. A masked UIO IRQ is disabled and
+ * counts nothing, so a polling UIO channel takes at most one interrupt per
+ * poll and its window only tells whether any poll found it fired.
+ */
+typedef struct {
+    int             timer_fd;       /* timerfd in the shard's epoll set, -1 without storm protection */
+    _Atomic bool    polling;        /* Storm polling, read by gpio_int_get_stats() */
+    bool            fired;          /* The source fired since it was last re-armed */
+    bool            saturated;      /* A poll read a full edge batch in the window, more may be lost */
+    uint32_t        limit;          /* Interrupts per window that start polling */
+    uint64_t        window_ns;      /* Measurement window */
+    uint64_t        window_start;   /* Start of the current window */
+    uint32_t        window_cnt;     /* Interrupts in the window, wakeups while a UIO channel polls */
+    uint64_t        last_icount;    /* UIO icount of the previous wakeup, NO_ICOUNT before the first one */
+} ChannelStorm;
+
+static ChannelStorm *g_channel_storm = NULL;
+
+/* Notified of storm transitions on the monitor threads */
+static _Atomic gpio_interrupt_storm_callback_t g_gpio_storm_callback = NULL;
+
+/* epoll data tag bit marking the storm poll timer of a channel */
+#define STORM_TIMER_TAG 0x40000000u
+
+/* ========== Counter Mode Support ========== */
+
+/**
+ * @brief Counter mode state of one channel
+ *
+ * The window being accumulated is owned by the monitor shard servicing the
+ * channel. The last closed window is published with a seqlock, as in the
+ * state cache. The callback stays registered while the channel is down.
+ */
+typedef struct {
+    _Atomic(gpio_interrupt_counter_callback_t) callback;
+    void            *arg;           /* User argument of callback */
+    int             timer_fd;       /* Window timerfd in the shard's epoll set, -1 outside counter mode */
+    int             level;          /* Latest known level, -1 if unknown */
+    uint8_t         edge;           /* GpioIntEdge of the latest edge */
+    uint64_t        level_ns;       /* Time up to which the level is accounted */
+    uint64_t        edge_ns;        /* Timestamp of the latest edge */
+    uint64_t        rise_ns;        /* Latest rising edge a period can start from, 0 if none */
+    GpioIntCounterReport window;    /* Window being accumulated */
+    _Alignas(64) _Atomic uint32_t seq;  /* Even when stable, odd while report is written */
+    GpioIntCounterReport report;    /* Last closed window */
+} ChannelCounter;
 
-/* GPIO interrupt callback function array */
-static gpio_interrupt_callback_t g_gpio_callbacks[MAX_INT_CNT] = {NULL};
+static ChannelCounter *g_channel_counter = NULL;
 
-/* Channel running status and mutex protection */
-static bool g_channel_is_running[MAX_INT_CNT] = {false};
-static pthread_mutex_t g_channel_mutex[MAX_INT_CNT];
-static bool g_mutex_initialized = false;
+/* epoll data tag bit marking the window timer of a counter channel */
+#define COUNTER_TIMER_TAG 0x10000000u
 
-/* ========== Callback Thread Support ========== */
+/* ========== State Cache Support ========== */
 
 /**
- * @brief Structure to pass data to callback thread
+ * @brief Last known state of one channel, on its own cache line
+ *
+ * seq is a seqlock written only by the thread owning the channel (the
+ * monitor thread, or the configuration thread while the channel is down).
+ * Readers copy the fields and retry if seq was odd or changed meanwhile, so
+ * neither side takes a lock or makes a syscall.
  */
 typedef struct {
-    uint8_t channel;
-    int gpio_value;
-    gpio_interrupt_callback_t callback;
-    pthread_mutex_t *mutex;
-} CallbackThreadData;
+    _Alignas(64) _Atomic uint32_t seq;  /* Even when stable, odd while written */
+    int         value;                  /* Latest GPIO value, -1 if unknown */
+    uint8_t     edge;                   /* GpioIntEdge of the latest event */
+    uint64_t    timestamp_ns;           /* Timestamp of the latest event, 0 before the first one */
+    uint64_t    events;                 /* Events since the channel was brought up */
+} ChannelState;
+
+static ChannelState *g_channel_cache = NULL;
+
+/* ========== Composite Rule Support ========== */
+
+/**
+ * @brief Evaluation state of one composite event rule
+ *
+ * The evaluation fields are owned by the monitor shard servicing the term
+ * channels. A rule is published by setting its bit in g_channel_rules for
+ * each term channel after the state is reset, and retired by clearing the
+ * bits and waiting out a pass of its shard.
+ */
+typedef struct {
+    _Atomic(gpio_interrupt_rule_callback_t) callback;
+    void            *arg;           /* User argument of callback */
+    bool            started;        /* Bits set and hold timer in the shard's epoll set */
+    uint8_t         shard;          /* Shard servicing every term channel */
+    int             timer_fd;       /* Hold timerfd, -1 while the rule is not started */
+    bool            active;         /* Condition is true, re-matching waits for it to drop */
+    bool            held;           /* Hold timer armed for the current assertion */
+    uint8_t         next;           /* Next term a SEQ rule waits for */
+    uint16_t        channel;        /* Channel that made the condition true */
+    uint64_t        first_ns;       /* Earliest term assertion of the current match */
+    uint64_t        rise_ns;        /* Timestamp of the event that made the condition true */
+    uint64_t        seq_start_ns;   /* Timestamp of the first term of a SEQ in progress */
+    _Atomic uint64_t matches;       /* Matches since the rule was started */
+} RuleState;
+
+static RuleState g_rule_state[GPIO_INT_MAX_RULES];
+
+/* Per-channel mask of the started rules with a term on the channel */
+static _Atomic uint16_t *g_channel_rules = NULL;
+
+/* epoll data tag bit marking the hold timer of a rule */
+#define RULE_TIMER_TAG 0x20000000u
+
+/* ========== Event Queue Support ========== */
+
+/**
+ * @brief Lock-free single-producer/single-consumer event queue
+ *
+ * The monitor thread is the only producer and the channel worker the only
+ * consumer. When the queue is full, LATEST and MERGE policies fold further
+ * events into the overflow fields, which the consumer collects after it has
+ * drained the ring, so no interrupt is lost without being counted. Once a
+ * fold is pending every new event joins it, even if the ring has room again,
+ * until the consumer has collected it: the folded events are never overtaken
+ * by newer ones. The fold is published under a sequence lock and counted
+ * with running totals, so the consumer knows exactly which events it took.
+ */
+typedef struct {
+    _Alignas(64) _Atomic uint32_t head;         /* Next slot to consume */
+    _Alignas(64) _Atomic uint32_t tail;         /* Next slot to produce */
+    GpioIntEvent        slot[GPIO_INT_QUEUE_DEPTH];
+    _Atomic uint8_t     policy;                 /* GpioIntOverflowPolicy */
+    _Atomic uint32_t    overflow_seq;           /* Odd while the fold is being written */
+    _Atomic uint32_t    overflow_cnt;           /* Events folded since the queue was reset */
+    _Atomic uint32_t    overflow_taken;         /* Folded events collected by the consumer */
+    int                 overflow_value;         /* Latest folded value */
+    uint8_t             overflow_edge;          /* Latest folded edge */
+    uint32_t            overflow_icount;        /* Latest folded icount */
+    uint64_t            overflow_ts;            /* Latest folded timestamp */
+    uint32_t            overflow_missed;        /* Missed interrupts of all folded events */
+    uint32_t            overflow_missed_taken;  /* Missed interrupts collected, consumer only */
+    _Atomic uint64_t    drop_cnt;               /* Dropped or superseded events */
+} ChannelEventQueue;
+
+static ChannelEventQueue *g_channel_queue = NULL;
+
+/* ========== Latency Statistics Support ========== */
+
+/* Log-linear histogram layout: 2^HIST_SUB_BITS linear sub-buckets per power of two */
+#define HIST_SUB_BITS   3
+#define HIST_SUB_CNT    (1u << HIST_SUB_BITS)
+#define HIST_MAX_BITS   36      /* Values clamp at 2^36 ns (~68 s) */
+#define HIST_BUCKETS    ((HIST_MAX_BITS - HIST_SUB_BITS + 1) * HIST_SUB_CNT)
+
+/**
+ * @brief Lock-free log-linear (HDR-style) latency histogram
+ */
+typedef struct {
+    _Atomic uint32_t    bucket[HIST_BUCKETS];
+    _Atomic uint64_t    count;
+    _Atomic uint64_t    max;
+} LatencyHistogram;
+
+/**
+ * @brief Per-channel statistics
+ *
+ * Each block is written by a single thread and kept on its own cache lines:
+ * the monitor thread owns the counters and wake_to_dispatch, the channel
+ * worker (the monitor thread for inline dispatch) owns the callback
+ * histograms.
+ */
+typedef struct {
+    _Alignas(64) _Atomic uint64_t interrupts;
+    _Atomic uint64_t    missed;
+    _Atomic uint64_t    filtered;
+    _Atomic uint64_t    reenable_failures;
+    _Atomic uint64_t    storms;
+    LatencyHistogram    wake_to_dispatch;
+    _Alignas(64) LatencyHistogram dispatch_to_callback;
+    _Alignas(64) LatencyHistogram callback_duration;
+} ChannelStats;
+
+static ChannelStats *g_channel_stats = NULL;
 
 /* ========== Private Helper Functions ========== */
 
 /* Forward declarations for static functions */
-static uint8_t gpio_int_start_monitor_thread(void);
-static uint8_t gpio_int_stop_monitor_thread(void);
+static uint8_t gpio_int_start_monitor_threads(void);
+static uint8_t gpio_int_stop_monitor_threads(void);
+static void wait_monitor_pass(MonitorShard *shard);
+static void rules_close(void);
+static void uring_post_enable(MonitorShard *shard, uint16_t channel);
 
 /**
- * @brief Initialize channel mutexes
- * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * @brief Allocate a zeroed, cache-line-aligned array
+ * @param count Number of elements
+ * @param size Element size
+ * @return void* Array, NULL on failure
  */
-static uint8_t init_channel_mutexes(void)
+static void *alloc_aligned_array(size_t count, size_t size)
 {
-    if (g_mutex_initialized) {
-        return DIS_COMMON_ERR_OK;
+    size_t bytes = (count * size + 63u) & ~(size_t)63u;
+    void *ptr = aligned_alloc(64, bytes);
+    
+    if (ptr) {
+        memset(ptr, 0, bytes);
+    }
+    return ptr;
+}
+
+/**
+ * @brief Free per-channel runtime state
+ */
+static void cleanup_channel_state(void)
+{
+    if (g_channel_filter) {
+        for (uint16_t i = 0; i < g_channel_state_cnt; i++) {
+            if (g_channel_filter[i].timer_fd >= 0) {
+                close(g_channel_filter[i].timer_fd);
+            }
+        }
     }
     
-    for (uint8_t i = 0; i < MAX_INT_CNT; i++) {
-        if (pthread_mutex_init(&g_channel_mutex[i], NULL) != 0) {
-            /* Cleanup previously initialized mutexes */
-            for (uint8_t j = 0; j < i; j++) {
-                pthread_mutex_destroy(&g_channel_mutex[j]);
+    if (g_channel_storm) {
+        for (uint16_t i = 0; i < g_channel_state_cnt; i++) {
+            if (g_channel_storm[i].timer_fd >= 0) {
+                close(g_channel_storm[i].timer_fd);
             }
-            return DIS_COMMON_ERR_API_FAIL;
         }
-        g_channel_is_running[i] = false;
     }
     
-    g_mutex_initialized = true;
-    return DIS_COMMON_ERR_OK;
+    if (g_channel_counter) {
+        for (uint16_t i = 0; i < g_channel_state_cnt; i++) {
+            if (g_channel_counter[i].timer_fd >= 0) {
+                close(g_channel_counter[i].timer_fd);
+            }
+        }
+    }
+    
+    /* Workers are joined by now, only the event fds of pulled channels remain */
+    if (g_channel_worker) {
+        for (uint16_t i = 0; i < g_channel_state_cnt; i++) {
+            if (g_channel_worker[i].pull && g_channel_worker[i].wake_fd >= 0) {
+                close(g_channel_worker[i].wake_fd);
+            }
+        }
+    }
+    
+    free(g_channel_hot);
+    free(g_channel_worker);
+    free(g_channel_queue);
+    free(g_channel_stats);
+    free(g_channel_batch_subs);
+    free(g_channel_filter);
+    free(g_channel_storm);
+    free(g_channel_counter);
+    free(g_channel_cache);
+    free(g_channel_rules);
+    
+    g_channel_hot = NULL;
+    g_channel_worker = NULL;
+    g_channel_queue = NULL;
+    g_channel_stats = NULL;
+    g_channel_batch_subs = NULL;
+    g_channel_filter = NULL;
+    g_channel_storm = NULL;
+    g_channel_counter = NULL;
+    g_channel_cache = NULL;
+    g_channel_rules = NULL;
+    g_channel_state_cnt = 0;
 }
 
 /**
- * @brief Cleanup channel mutexes
+ * @brief Allocate per-channel runtime state for cnt channels
+ * @param cnt Number of channels
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
  */
-static void cleanup_channel_mutexes(void)
+static uint8_t init_channel_state(uint16_t cnt)
 {
-    if (!g_mutex_initialized) {
-        return;
+    cleanup_channel_state();
+    
+    g_channel_hot = alloc_aligned_array(cnt, sizeof(*g_channel_hot));
+    g_channel_worker = calloc(cnt, sizeof(*g_channel_worker));
+    g_channel_queue = alloc_aligned_array(cnt, sizeof(*g_channel_queue));
+    g_channel_stats = alloc_aligned_array(cnt, sizeof(*g_channel_stats));
+    g_channel_batch_subs = calloc(cnt, sizeof(*g_channel_batch_subs));
+    g_channel_filter = calloc(cnt, sizeof(*g_channel_filter));
+    g_channel_storm = calloc(cnt, sizeof(*g_channel_storm));
+    g_channel_counter = alloc_aligned_array(cnt, sizeof(*g_channel_counter));
+    g_channel_cache = alloc_aligned_array(cnt, sizeof(*g_channel_cache));
+    g_channel_rules = calloc(cnt, sizeof(*g_channel_rules));
+    
+    if (!g_channel_hot || !g_channel_worker || !g_channel_queue || !g_channel_stats ||
+        !g_channel_batch_subs || !g_channel_filter || !g_channel_storm || !g_channel_counter ||
+        !g_channel_cache || !g_channel_rules) {
+        cleanup_channel_state();
+        return DIS_COMMON_ERR_API_FAIL;
     }
     
-    for (uint8_t i = 0; i < MAX_INT_CNT; i++) {
-        pthread_mutex_destroy(&g_channel_mutex[i]);
-        g_channel_is_running[i] = false;
+    for (uint16_t i = 0; i < cnt; i++) {
+        g_channel_hot[i].last_icount = NO_ICOUNT;
+        g_channel_worker[i].wake_fd = -1;
+        g_channel_filter[i].timer_fd = -1;
+        g_channel_storm[i].timer_fd = -1;
+        g_channel_counter[i].timer_fd = -1;
+        g_channel_counter[i].report.channel = i;
+        g_channel_counter[i].report.gpio_value = -1;
+        g_channel_cache[i].value = -1;
     }
     
-    g_mutex_initialized = false;
+    g_channel_state_cnt = cnt;
+    return DIS_COMMON_ERR_OK;
 }
 
 /**
- * @brief Thread function to execute GPIO callback
- * @param arg Pointer to CallbackThreadData structure
- * @return void* Thread return value
+ * @brief Find the next enabled channel at or after a given index
+ * @param ctx Context pointer
+ * @param from First channel index to consider
+ * @return int Channel index, -1 if there is none
+ * 
+ * Walks the enable bitmap a word at a time so sparse tables are scanned in
+ * time proportional to the number of words, not channels.
  */
-static void* gpio_callback_thread_func(void *arg)
+static int next_enabled_channel(const GpioIntCtx *ctx, uint32_t from)
 {
-    CallbackThreadData *data = (CallbackThreadData *)arg;
+    uint32_t words = GPIO_INT_MASK_WORDS(ctx->int_cnt);
+    uint32_t w = from / 64u;
     
-    if (data && data->callback && data->mutex) {
-        /* Execute the callback function */
-        data->callback(data->channel, data->gpio_value);
-        
-        /* Clear the running flag after callback execution */
-        pthread_mutex_lock(data->mutex);
-        g_channel_is_running[data->channel] = false;
-        pthread_mutex_unlock(data->mutex);
+    if (from >= ctx->int_cnt) {
+        return -1;
     }
     
-    /* Free the allocated data */
-    free(data);
-    return NULL;
+    uint64_t bits = ctx->enable_mask[w] & (~0ull << (from % 64u));
+    while (1) {
+        if (bits) {
+            uint32_t channel = w * 64u + (uint32_t)__builtin_ctzll(bits);
+            return (channel < ctx->int_cnt) ? (int)channel : -1;
+        }
+        if (++w >= words) {
+            return -1;
+        }
+        bits = ctx->enable_mask[w];
+    }
 }
 
+/* Iterate over the enabled channels of a context */
+#define FOR_EACH_ENABLED_CHANNEL(ctx, ch) \
+    for (int ch = next_enabled_channel((ctx), 0); ch >= 0; ch = next_enabled_channel((ctx), (uint32_t)ch + 1))
+
 /**
- * @brief GPIO interrupt service routine
- * @param channel GPIO interrupt channel number
- * @param gpio_ctx Pointer to GPIO interrupt context
+ * @brief Get current CLOCK_MONOTONIC time in nanoseconds
+ * @return uint64_t Monotonic timestamp
+ */
+static inline uint64_t gpio_int_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Touch the top of the calling thread's stack so it is faulted in
  * 
- * This function reads GPIO value and calls registered callbacks.
+ * Only done with lock_memory: combined with mlockall(MCL_FUTURE) the pages
+ * then stay resident and the interrupt path takes no page faults.
  */
-static void gpio_interrupt_handler(uint8_t channel, GpioIntCtx *gpio_ctx)
-{    
-    if (channel >= MAX_INT_CNT) {
-        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Invalid GPIO interrupt channel: %u\n", channel);
+static __attribute__((noinline)) void prefault_thread_stack(void)
+{
+    volatile uint8_t stack[GPIO_INT_RT_PREFAULT_SIZE];
+    
+    if (!g_gpio_rt_cfg.lock_memory) {
         return;
     }
     
-    /* Read current GPIO value */
-    int gpio_value = gpiod_line_get_value(gpio_ctx->line[channel]);
-    if (gpio_value < 0) {
-        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to read GPIO value for channel %u\n", channel);
-        return;
+    for (size_t i = 0; i < sizeof(stack); i += 4096) {
+        stack[i] = 0;
     }
- 
-    /* Call registered callback if available */
-    if (g_gpio_callbacks[channel] != NULL && !g_channel_is_running[channel]) {
-        /* Set running flag */
-        pthread_mutex_lock(&g_channel_mutex[channel]);
-        g_channel_is_running[channel] = true;
-        pthread_mutex_unlock(&g_channel_mutex[channel]);
-        
-        /* Create a new thread to execute the callback */
-        CallbackThreadData *data = (CallbackThreadData *)malloc(sizeof(CallbackThreadData));
-        if (!data) {
-            /* Reset running flag if memory allocation fails */
-            pthread_mutex_lock(&g_channel_mutex[channel]);
-            g_channel_is_running[channel] = false;
-            pthread_mutex_unlock(&g_channel_mutex[channel]);
-            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to allocate memory for callback thread data\n");
-            return;
-        }
-        data->channel = channel;
-        data->gpio_value = gpio_value;
-        data->callback = g_gpio_callbacks[channel];
-        data->mutex = &g_channel_mutex[channel];
-
-        pthread_t thread;
-        if (pthread_create(&thread, NULL, gpio_callback_thread_func, data) != 0) {
-            /* Reset running flag if thread creation fails */
-            pthread_mutex_lock(&g_channel_mutex[channel]);
-            g_channel_is_running[channel] = false;
-            pthread_mutex_unlock(&g_channel_mutex[channel]);
-            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to create callback thread for channel %u\n", channel);
-            free(data);
-        } else {
-            pthread_detach(thread);
+}
+
+/**
+ * @brief Create a monitor or worker thread with the real-time configuration
+ * @param thread Output thread handle
+ * @param func Thread function
+ * @param arg Thread argument
+ * @param policy GpioIntSchedPolicy of the thread
+ * @param priority FIFO/RR priority, clamped to the policy's range
+ * @param cpu CPU to pin the thread to, GPIO_INT_CPU_ANY for none
+ * @return int 0 on success, pthread_create() error otherwise
+ * 
+ * If the scheduling or affinity attributes are refused (no CAP_SYS_NICE,
+ * CPU offline) the thread is created with default attributes instead.
+ */
+static int create_interrupt_thread(pthread_t *thread, void *(*func)(void *), void *arg,
+                                   uint8_t sched_policy, uint8_t priority, int16_t cpu)
+{
+    pthread_attr_t attr;
+    int ret;
+    
+    pthread_attr_init(&attr);
+    
+    if (g_gpio_rt_cfg.lock_memory) {
+        pthread_attr_setstacksize(&attr, GPIO_INT_RT_STACK_SIZE);
+    }
+    
+    if (sched_policy != GPIO_INT_SCHED_OTHER) {
+        int policy = (sched_policy == GPIO_INT_SCHED_RR) ? SCHED_RR : SCHED_FIFO;
+        struct sched_param param;
+        
+        param.sched_priority = priority;
+        if (param.sched_priority < sched_get_priority_min(policy)) {
+            param.sched_priority = sched_get_priority_min(policy);
+        } else if (param.sched_priority > sched_get_priority_max(policy)) {
+            param.sched_priority = sched_get_priority_max(policy);
         }
-    } 
+        
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, policy);
+        pthread_attr_setschedparam(&attr, &param);
+    }
+    
+    if (cpu != GPIO_INT_CPU_ANY) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(cpu, &cpus);
+        pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus);
+    }
+    
+    ret = pthread_create(thread, &attr, func, arg);
+    pthread_attr_destroy(&attr);
+    
+    if (ret == EPERM || ret == EINVAL) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "Real-time thread attributes refused (%s), using defaults\n",
+                         strerror(ret));
+        ret = pthread_create(thread, NULL, func, arg);
+    }
+    
+    return ret;
 }
 
 /**
- * @brief Initialize UIO device for a channel
- * @param cfg Pin configuration
- * @param fd_ptr Pointer to file descriptor to set
- * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * @brief Map a latency value to its histogram bucket
+ * @param value_ns Latency in nanoseconds
+ * @return uint32_t Bucket index
  */
-static uint8_t init_uio_device(const GpioIntPinCfg *cfg, int *fd_ptr)
+static inline uint32_t hist_bucket_index(uint64_t value_ns)
 {
-    char dev_path[32];
-    snprintf(dev_path, sizeof(dev_path), "/dev/uio%u", cfg->uio_index);
+    if (value_ns < HIST_SUB_CNT) {
+        return (uint32_t)value_ns;
+    }
     
-    *fd_ptr = open(dev_path, O_RDWR);
-    if (*fd_ptr < 0) {
-        return DIS_COMMON_ERR_API_FAIL;
+    uint32_t msb = 63u - (uint32_t)__builtin_clzll(value_ns);
+    if (msb >= HIST_MAX_BITS) {
+        return HIST_BUCKETS - 1;
     }
     
-    return DIS_COMMON_ERR_OK;
+    uint32_t shift = msb - HIST_SUB_BITS;
+    return (shift + 1) * HIST_SUB_CNT + (uint32_t)((value_ns >> shift) & (HIST_SUB_CNT - 1));
 }
 
 /**
- * @brief Initialize GPIO line for a channel
- * @param cfg Pin configuration  
- * @param line_ptr Pointer to gpiod line to set
- * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * @brief Get the upper bound of a histogram bucket
+ * @param index Bucket index
+ * @return uint64_t Largest value mapped to the bucket
  */
-static uint8_t init_gpio_line(const GpioIntPinCfg *cfg, struct gpiod_line **line_ptr)
+static uint64_t hist_bucket_upper(uint32_t index)
 {
-    char chipname[16];
-    snprintf(chipname, sizeof(chipname), "gpiochip%u", cfg->group_id);
+    if (index < HIST_SUB_CNT) {
+        return index;
+    }
     
-    struct gpiod_chip *chip = gpiod_chip_open_by_name(chipname);
-    if (!chip) {
-        return DIS_COMMON_ERR_API_FAIL;
+    uint32_t shift = index / HIST_SUB_CNT - 1;
+    uint64_t sub = index % HIST_SUB_CNT;
+    return ((HIST_SUB_CNT + sub + 1) << shift) - 1;
+}
+
+/**
+ * @brief Record one latency sample (single writer per histogram)
+ * @param hist Histogram
+ * @param value_ns Latency in nanoseconds
+ */
+static inline void hist_record(LatencyHistogram *hist, uint64_t value_ns)
+{
+    atomic_fetch_add_explicit(&hist->bucket[hist_bucket_index(value_ns)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&hist->count, 1, memory_order_relaxed);
+    if (value_ns > atomic_load_explicit(&hist->max, memory_order_relaxed)) {
+        atomic_store_explicit(&hist->max, value_ns, memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Reset a histogram
+ * @param hist Histogram
+ */
+static void hist_reset(LatencyHistogram *hist)
+{
+    for (uint32_t i = 0; i < HIST_BUCKETS; i++) {
+        atomic_store_explicit(&hist->bucket[i], 0, memory_order_relaxed);
+    }
+    atomic_store_explicit(&hist->count, 0, memory_order_relaxed);
+    atomic_store_explicit(&hist->max, 0, memory_order_relaxed);
+}
+
+/**
+ * @brief Add the samples of one histogram to another
+ * @param dst Histogram owned by the caller
+ * @param src Histogram to add
+ */
+static void hist_merge(LatencyHistogram *dst, LatencyHistogram *src)
+{
+    for (uint32_t i = 0; i < HIST_BUCKETS; i++) {
+        uint32_t cnt = atomic_load_explicit(&src->bucket[i], memory_order_relaxed);
+        atomic_fetch_add_explicit(&dst->bucket[i], cnt, memory_order_relaxed);
     }
     
-    *line_ptr = gpiod_chip_get_line(chip, cfg->group_bit);
-    if (!*line_ptr) {
-        return DIS_COMMON_ERR_API_FAIL;
+    uint64_t max = atomic_load_explicit(&src->max, memory_order_relaxed);
+    if (max > atomic_load_explicit(&dst->max, memory_order_relaxed)) {
+        atomic_store_explicit(&dst->max, max, memory_order_relaxed);
     }
+}
+
+/**
+ * @brief Summarize a histogram into percentiles
+ * @param hist Histogram
+ * @param out Output summary
+ */
+static void hist_summarize(LatencyHistogram *hist, GpioIntLatency *out)
+{
+    static const uint32_t permille[3] = {500, 990, 999};
+    uint64_t *result[3] = {&out->p50_ns, &out->p99_ns, &out->p999_ns};
+    uint64_t total = 0;
+    uint64_t seen = 0;
+    uint32_t next = 0;
     
-    if (gpiod_line_request_input(*line_ptr, cfg->consumer) != 0) {
-        return DIS_COMMON_ERR_API_FAIL;
+    for (uint32_t i = 0; i < HIST_BUCKETS; i++) {
+        total += atomic_load_explicit(&hist->bucket[i], memory_order_relaxed);
     }
     
-    return DIS_COMMON_ERR_OK;
+    out->count = total;
+    out->max_ns = atomic_load_explicit(&hist->max, memory_order_relaxed);
+    out->p50_ns = out->p99_ns = out->p999_ns = 0;
+    
+    for (uint32_t i = 0; i < HIST_BUCKETS && next < 3 && total > 0; i++) {
+        seen += atomic_load_explicit(&hist->bucket[i], memory_order_relaxed);
+        while (next < 3 && seen * 1000 >= total * permille[next]) {
+            uint64_t upper = hist_bucket_upper(i);
+            *result[next++] = (upper < out->max_ns) ? upper : out->max_ns;
+        }
+    }
 }
 
 /**
- * @brief Initialize a single GPIO interrupt channel
- * @param ctx Context pointer
- * @param channel_idx Channel index
- * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * @brief Reset a channel event queue
+ * @param queue Queue to reset
+ * @param policy Overflow policy to apply
  */
-static uint8_t init_single_channel(GpioIntCtx *ctx, uint8_t channel_idx)
+static void event_queue_reset(ChannelEventQueue *queue, uint8_t policy)
 {
-    const GpioIntPinCfg *cfg = &ctx->pin_cfg[channel_idx];
-    uint8_t ret;
+    atomic_store(&queue->head, 0);
+    atomic_store(&queue->tail, 0);
+    atomic_store(&queue->policy, policy);
+    atomic_store(&queue->overflow_seq, 0);
+    atomic_store(&queue->overflow_cnt, 0);
+    atomic_store(&queue->overflow_taken, 0);
+    queue->overflow_missed = 0;
+    queue->overflow_missed_taken = 0;
+    atomic_store(&queue->drop_cnt, 0);
+}
+
+/**
+ * @brief Push an event (producer side, monitor thread only)
+ * @param queue Channel event queue
+ * @param slot Event to queue
+ * @return uint8_t 0 if queued, GPIO_INT_TRACE_DROPPED or GPIO_INT_TRACE_FOLDED on overflow
+ */
+static uint8_t event_queue_push(ChannelEventQueue *queue, const GpioIntEvent *slot)
+{
+    uint32_t folded = atomic_load_explicit(&queue->overflow_cnt, memory_order_relaxed);
+    bool fold_pending = folded != atomic_load_explicit(&queue->overflow_taken, memory_order_acquire);
     
-    /* Initialize UIO device */
-    ret = init_uio_device(cfg, &ctx->fd[channel_idx]);
-    if (ret != DIS_COMMON_ERR_OK) {
-        return ret;
+    if (!fold_pending) {
+        uint32_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+        uint32_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+        
+        if (tail - head < GPIO_INT_QUEUE_DEPTH) {
+            queue->slot[tail & (GPIO_INT_QUEUE_DEPTH - 1)] = *slot;
+            atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+            return 0;
+        }
+        
+        /* Queue is full: apply the overflow policy */
+        if (atomic_load_explicit(&queue->policy, memory_order_relaxed) == GPIO_INT_OVERFLOW_QUEUE) {
+            atomic_fetch_add_explicit(&queue->drop_cnt, 1, memory_order_relaxed);
+            return GPIO_INT_TRACE_DROPPED;
+        }
     }
     
-    /* Set GPIO pinmux */
-    gpio_setPinmux(cfg->group_id, cfg->group_bit, 1);
+    /* Fold, also behind a pending fold so it is never overtaken */
+    uint32_t seq = atomic_load_explicit(&queue->overflow_seq, memory_order_relaxed);
+    
+    atomic_store_explicit(&queue->overflow_seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    queue->overflow_value = slot->gpio_value;
+    queue->overflow_edge = slot->edge;
+    queue->overflow_icount = slot->icount;
+    queue->overflow_ts = slot->timestamp_ns;
+    queue->overflow_missed += slot->missed;
+    atomic_store_explicit(&queue->overflow_cnt, folded + 1, memory_order_relaxed);
+    atomic_store_explicit(&queue->overflow_seq, seq + 2, memory_order_release);
+    return GPIO_INT_TRACE_FOLDED;
+}
+
+/**
+ * @brief Pop an event (consumer side, channel worker only)
+ * @param queue Channel event queue
+ * @param slot Output event
+ * @param count Output: number of interrupts represented by the event
+ * @return bool true if an event was returned, false if the queue is empty
+ */
+static bool event_queue_pop(ChannelEventQueue *queue, GpioIntEvent *slot, uint32_t *count)
+{
+    uint32_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    
+    if (head != tail) {
+        *slot = queue->slot[head & (GPIO_INT_QUEUE_DEPTH - 1)];
+        atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+        *count = 1;
+        return true;
+    }
+    
+    /* Ring drained: collect events folded while it was full */
+    uint32_t taken = atomic_load_explicit(&queue->overflow_taken, memory_order_relaxed);
+    uint32_t folded;
+    uint32_t missed;
+    uint32_t seq;
+    
+    do {
+        seq = atomic_load_explicit(&queue->overflow_seq, memory_order_acquire);
+        folded = atomic_load_explicit(&queue->overflow_cnt, memory_order_relaxed);
+        slot->gpio_value = queue->overflow_value;
+        slot->edge = queue->overflow_edge;
+        slot->icount = queue->overflow_icount;
+        slot->timestamp_ns = queue->overflow_ts;
+        missed = queue->overflow_missed;
+        atomic_thread_fence(memory_order_acquire);
+    } while ((seq & 1u) || atomic_load_explicit(&queue->overflow_seq, memory_order_relaxed) != seq);
+    
+    if (folded == taken) {
+        return false;
+    }
+    
+    slot->missed = missed - queue->overflow_missed_taken;
+    queue->overflow_missed_taken = missed;
+    atomic_store_explicit(&queue->overflow_taken, folded, memory_order_release);
+    *count = folded - taken;
+    return true;
+}
+
+/**
+ * @brief Check whether a channel event queue holds pending events
+ * @param queue Channel event queue
+ * @return bool true if events are pending
+ */
+static bool event_queue_pending(ChannelEventQueue *queue)
+{
+    return atomic_load_explicit(&queue->head, memory_order_relaxed) !=
+           atomic_load_explicit(&queue->tail, memory_order_acquire) ||
+           atomic_load_explicit(&queue->overflow_cnt, memory_order_acquire) !=
+           atomic_load_explicit(&queue->overflow_taken, memory_order_relaxed);
+}
+
+/**
+ * @brief Invoke the registered callback of a channel for one event
+ * @param event Event to deliver
+ */
+static void invoke_channel_callback(const GpioIntEvent *event)
+{
+    ChannelHot *hot = &g_channel_hot[event->channel];
+    gpio_interrupt_event_callback_t event_callback = atomic_load_explicit(&hot->event_callback, memory_order_acquire);
+    gpio_interrupt_wide_callback_t wide_callback = atomic_load_explicit(&hot->wide_callback, memory_order_acquire);
+    gpio_interrupt_callback_t callback = atomic_load_explicit(&hot->callback, memory_order_acquire);
+    
+    if (!event_callback && !wide_callback && !callback) {
+        return;
+    }
+    
+    ChannelStats *stats = &g_channel_stats[event->channel];
+    uint64_t start_ns = gpio_int_now_ns();
+    
+    if (start_ns > event->dispatch_ns) {
+        hist_record(&stats->dispatch_to_callback, start_ns - event->dispatch_ns);
+    }
+    
+    if (event_callback) {
+        event_callback(event);
+    } else if (wide_callback) {
+        wide_callback(event->channel, event->gpio_value);
+    } else {
+        callback((uint8_t)event->channel, event->gpio_value);
+    }
+    
+    hist_record(&stats->callback_duration, gpio_int_now_ns() - start_ns);
+}
+
+/**
+ * @brief Take the next event to deliver from a channel queue according to its policy
+ * @param channel GPIO interrupt channel number
+ * @param event Output event
+ * @return bool true if an event was returned, false if nothing is pending
+ * 
+ * QUEUE returns the pending events one by one, LATEST and MERGE collapse
+ * everything pending into one event. Queue consumer side only.
+ */
+static bool next_channel_event(uint16_t channel, GpioIntEvent *event)
+{
+    ChannelEventQueue *queue = &g_channel_queue[channel];
+    uint8_t policy = atomic_load_explicit(&queue->policy, memory_order_relaxed);
+    GpioIntEvent slot = { .channel = channel };
+    uint32_t count;
+    uint32_t total = 0;
+    uint32_t missed = 0;
+    
+    while (event_queue_pop(queue, &slot, &count)) {
+        slot.count = count;
+        
+        if (policy == GPIO_INT_OVERFLOW_QUEUE) {
+            *event = slot;
+            return true;
+        }
+        
+        /* LATEST and MERGE collapse everything pending into one event */
+        *event = slot;
+        total += count;
+        missed += slot.missed;
+    }
+    
+    if (total == 0) {
+        return false;
+    }
+    
+    if (policy == GPIO_INT_OVERFLOW_LATEST) {
+        atomic_fetch_add_explicit(&queue->drop_cnt, total - 1, memory_order_relaxed);
+        event->count = 1;
+    } else {
+        event->count = total;
+    }
+    event->missed = missed;
+    
+    return true;
+}
+
+/**
+ * @brief Deliver all pending events of a channel according to its policy
+ * @param channel GPIO interrupt channel number
+ */
+static void deliver_channel_events(uint16_t channel)
+{
+    GpioIntEvent event;
+    
+    while (next_channel_event(channel, &event)) {
+        invoke_channel_callback(&event);
+    }
+}
+
+/**
+ * @brief Worker thread function executing callbacks for one channel
+ * @param arg Channel number cast to a pointer
+ * @return void* Thread return value
+ */
+static void* gpio_callback_worker_func(void *arg)
+{
+    uint16_t channel = (uint16_t)(uintptr_t)arg;
+    CallbackWorker *worker = &g_channel_worker[channel];
+    _Atomic uint8_t *delivery = &g_channel_hot[channel].delivery;
+    uint64_t kicks;
+    
+    prefault_thread_stack();
+    
+    while (1) {
+        /* Sleep until the monitor thread hands over an interrupt */
+        if (read(worker->wake_fd, &kicks, sizeof(kicks)) != sizeof(kicks)) {
+            if (errno == EINTR) {
+                continue;
+            }
+            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Callback worker wait failed for channel %u\n", channel);
+            break;
+        }
+        
+        if (worker->stop) {
+            break;
+        }
+        
+        /* Drain the queue until no event was queued during the drain */
+        uint8_t expected;
+        do {
+            atomic_exchange_explicit(delivery, CHANNEL_RUNNING, memory_order_acq_rel);
+            deliver_channel_events(channel);
+            expected = CHANNEL_RUNNING;
+        } while (!atomic_compare_exchange_strong_explicit(delivery, &expected, CHANNEL_IDLE,
+                                                          memory_order_acq_rel, memory_order_acquire));
+    }
+    
+    return NULL;
+}
+
+/**
+ * @brief Start the persistent callback worker of one channel
+ * @param ctx Context pointer
+ * @param channel GPIO interrupt channel number
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * Workers start when the first callback of an enabled channel is
+ * registered, so channels without callbacks never get a thread.
+ */
+static uint8_t start_callback_worker(const GpioIntCtx *ctx, uint16_t channel)
+{
+    CallbackWorker *worker = &g_channel_worker[channel];
+    
+    if (worker->started || worker->pull) {
+        return DIS_COMMON_ERR_OK;
+    }
+    
+    worker->wake_fd = eventfd(0, EFD_CLOEXEC);
+    if (worker->wake_fd < 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to create wake eventfd for channel %u\n", channel);
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    /* Critical channels get a worker above the others, real-time even without a global policy */
+    uint8_t policy = g_gpio_rt_cfg.sched_policy;
+    uint8_t priority = g_gpio_rt_cfg.worker_priority;
+    if (ctx->ch[channel].priority == GPIO_INT_PRIO_CRITICAL && g_gpio_rt_cfg.critical_priority > 0) {
+        policy = (policy == GPIO_INT_SCHED_OTHER) ? GPIO_INT_SCHED_FIFO : policy;
+        priority = g_gpio_rt_cfg.critical_priority;
+    }
+    
+    worker->stop = false;
+    if (create_interrupt_thread(&worker->thread, gpio_callback_worker_func, (void *)(uintptr_t)channel,
+                                policy, priority, g_gpio_rt_cfg.worker_cpu) != 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to create callback worker for channel %u\n", channel);
+        close(worker->wake_fd);
+        worker->wake_fd = -1;
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    worker->started = true;
+    return DIS_COMMON_ERR_OK;
+}
+
+/**
+ * @brief Stop and join the callback worker of one channel
+ * @param channel GPIO interrupt channel number
+ * 
+ * The monitor thread must no longer dispatch to the channel. Events still
+ * queued are discarded.
+ */
+static void stop_callback_worker(uint16_t channel)
+{
+    CallbackWorker *worker = &g_channel_worker[channel];
+    uint64_t one = 1;
+    
+    if (!worker->started) {
+        return;
+    }
+    
+    worker->stop = true;
+    if (write(worker->wake_fd, &one, sizeof(one)) != sizeof(one)) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to wake callback worker for channel %u\n", channel);
+    }
+    pthread_join(worker->thread, NULL);
+    
+    close(worker->wake_fd);
+    worker->wake_fd = -1;
+    worker->started = false;
+    atomic_store_explicit(&g_channel_hot[channel].delivery, CHANNEL_IDLE, memory_order_relaxed);
+}
+
+/**
+ * @brief Stop and join all callback workers
+ *
+ * Must be called after the monitor thread has stopped so that no new
+ * interrupts are handed over while the workers exit.
+ */
+static void stop_callback_workers(void)
+{
+    for (uint16_t i = 0; i < g_channel_state_cnt; i++) {
+        stop_callback_worker(i);
+    }
+}
+
+/**
+ * @brief Queue an event for the channel worker or pull consumer and wake it if idle
+ * @param event Event to queue, dispatch_ns is set here
+ * @return uint8_t Overflow flags of event_queue_push()
+ */
+static uint8_t dispatch_channel_event(GpioIntEvent *event)
+{
+    uint16_t channel = event->channel;
+    
+    event->dispatch_ns = gpio_int_now_ns();
+    if (event->dispatch_ns > event->timestamp_ns) {
+        hist_record(&g_channel_stats[channel].wake_to_dispatch, event->dispatch_ns - event->timestamp_ns);
+    }
+    
+    uint8_t flags = event_queue_push(&g_channel_queue[channel], event);
+    
+    /* Wake the consumer only if it went idle, otherwise it sees PENDING and drains again */
+    _Atomic uint8_t *delivery = &g_channel_hot[channel].delivery;
+    if (atomic_exchange_explicit(delivery, CHANNEL_PENDING, memory_order_acq_rel) == CHANNEL_IDLE) {
+        uint64_t one = 1;
+        if (write(g_channel_worker[channel].wake_fd, &one, sizeof(one)) != sizeof(one)) {
+            atomic_store_explicit(delivery, CHANNEL_IDLE, memory_order_relaxed);
+            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to wake callback worker for channel %u\n", channel);
+        }
+    }
+    
+    return flags;
+}
+
+/**
+ * @brief Run the callback of an inline critical channel in the monitor thread
+ * @param event Event to deliver, dispatch_ns is set here
+ * 
+ * Nothing is queued, so the callback must stay well within the interrupt
+ * budget: every other channel of the shard waits for it.
+ */
+static void dispatch_inline_event(GpioIntEvent *event)
+{
+    event->dispatch_ns = gpio_int_now_ns();
+    if (event->dispatch_ns > event->timestamp_ns) {
+        hist_record(&g_channel_stats[event->channel].wake_to_dispatch, event->dispatch_ns - event->timestamp_ns);
+    }
+    
+    invoke_channel_callback(event);
+}
+
+/**
+ * @brief Check whether any callback is registered for a channel
+ * @param channel GPIO interrupt channel number
+ * @return bool true if a callback is registered
+ */
+static inline bool channel_has_callback(uint16_t channel)
+{
+    const ChannelHot *hot = &g_channel_hot[channel];
+    
+    return atomic_load_explicit(&hot->callback, memory_order_acquire) != NULL ||
+           atomic_load_explicit(&hot->wide_callback, memory_order_acquire) != NULL ||
+           atomic_load_explicit(&hot->event_callback, memory_order_acquire) != NULL;
+}
+
+/**
+ * @brief Check whether the events of a channel are queued for a consumer
+ * @param channel GPIO interrupt channel number
+ * @return bool true if a callback is registered or the channel is pulled
+ */
+static inline bool channel_has_consumer(uint16_t channel)
+{
+    return channel_has_callback(channel) ||
+           atomic_load_explicit(&g_channel_worker[channel].pull, memory_order_acquire);
+}
+
+/**
+ * @brief Make sure a channel can deliver to a callback about to be registered
+ * @param channel GPIO interrupt channel number
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * Starts the channel worker on first use. Must be called with
+ * g_gpio_config_mutex held, before the callback pointer is published.
+ */
+static uint8_t prepare_callback_delivery(uint16_t channel)
+{
+    if (g_channel_worker[channel].pull) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Channel %u is pulled with gpio_int_wait(), cannot take callbacks\n", channel);
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    return start_callback_worker(&g_gpio_system_ctx, channel);
+}
+
+/**
+ * @brief Switch a channel to pull delivery
+ * @param channel GPIO interrupt channel number
+ * @return int Event fd of the channel, -1 on failure
+ * 
+ * Must be called with g_gpio_config_mutex held.
+ */
+static int open_pull_channel(uint16_t channel)
+{
+    CallbackWorker *worker = &g_channel_worker[channel];
+    
+    if (worker->pull) {
+        return worker->wake_fd;
+    }
+    
+    if (worker->started || channel_has_callback(channel)) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Channel %u delivers to callbacks, cannot be pulled\n", channel);
+        return -1;
+    }
+    
+    int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd < 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to create event fd for channel %u\n", channel);
+        return -1;
+    }
+    
+    /* Nothing was queued without a consumer, the queue starts empty */
+    worker->wake_fd = fd;
+    atomic_store_explicit(&g_channel_hot[channel].delivery, CHANNEL_IDLE, memory_order_relaxed);
+    atomic_store_explicit(&worker->pull, true, memory_order_release);
+    
+    DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 2, "Channel %u switched to pull delivery\n", channel);
+    return fd;
+}
+
+/**
+ * @brief Hand the events collected on a shard to the batch subscribers
+ * @param shard Monitor shard
+ * 
+ * Each subscriber receives the subset of the batch it subscribed to, in
+ * arrival order, in a single call.
+ */
+static void batch_flush(MonitorShard *shard)
+{
+    uint8_t active = atomic_load_explicit(&g_batch_active, memory_order_acquire);
+    
+    while (active && shard->batch_cnt > 0) {
+        uint8_t sub = (uint8_t)__builtin_ctz(active);
+        uint8_t bit = (uint8_t)(1u << sub);
+        uint32_t n = 0;
+        
+        active &= (uint8_t)~bit;
+        for (uint32_t i = 0; i < shard->batch_cnt; i++) {
+            if (shard->batch_subs[i] & bit) {
+                shard->batch_out[n++] = shard->batch[i];
+            }
+        }
+        
+        if (n > 0) {
+            g_batch_subscriber[sub].callback(shard->batch_out, n, g_batch_subscriber[sub].arg);
+        }
+    }
+    
+    shard->batch_cnt = 0;
+}
+
+/**
+ * @brief Collect an event for the batch subscribers of its channel
+ * @param shard Monitor shard servicing the channel
+ * @param event Event to collect
+ */
+static inline void batch_append(MonitorShard *shard, const GpioIntEvent *event)
+{
+    uint8_t subs = atomic_load_explicit(&g_channel_batch_subs[event->channel], memory_order_acquire);
+    
+    if (!subs) {
+        return;
+    }
+    
+    if (shard->batch_cnt == GPIO_INT_BATCH_MAX) {
+        batch_flush(shard);
+    }
+    
+    shard->batch[shard->batch_cnt] = *event;
+    shard->batch_subs[shard->batch_cnt] = subs;
+    shard->batch_cnt++;
+}
+
+/**
+ * @brief Count the interrupts coalesced into a UIO wakeup
+ * @param channel GPIO interrupt channel number
+ * @param icount UIO interrupt count read on this wakeup
+ * @return uint32_t Interrupts since the previous wakeup beyond the one reported
+ * 
+ * The UIO count keeps running while the IRQ is masked between the read and
+ * the re-enable, so any gap in consecutive counts is an interrupt that never
+ * produced its own wakeup. The first wakeup only establishes the baseline.
+ */
+static uint32_t track_missed_interrupts(uint16_t channel, uint32_t icount)
+{
+    uint64_t last = g_channel_hot[channel].last_icount;
+    uint32_t missed = 0;
+    
+    if (last != NO_ICOUNT) {
+        uint32_t delta = icount - (uint32_t)last;  /* Wraps with the 32-bit UIO counter */
+        if (delta > 1) {
+            missed = delta - 1;
+            atomic_fetch_add_explicit(&g_channel_stats[channel].missed, missed, memory_order_relaxed);
+        }
+    }
+    
+    g_channel_hot[channel].last_icount = icount;
+    return missed;
+}
+
+/**
+ * @brief Read the GPIO line value of a channel
+ * @param gpio_ctx Pointer to GPIO interrupt context
+ * @param channel GPIO interrupt channel number
+ * @return int GPIO value, < 0 on failure
+ * 
+ * Channels with a mapped data-in register are read with a single load,
+ * all others through the backend.
+ */
+static inline int channel_read_value(GpioIntCtx *gpio_ctx, uint16_t channel)
+{
+    const GpioIntChannel *ch = &gpio_ctx->ch[channel];
+    
+    if (ch->datain) {
+        return (int)((*ch->datain >> (ch->pin_cfg.group_bit % 32u)) & 1u);
+    }
+    
+    return g_gpio_backend->get_value(gpio_ctx, channel);
+}
+
+/**
+ * @brief Append an event to the trace file if recording
+ * @param event Dispatched event
+ * @param flags GPIO_INT_TRACE_* flags
+ * 
+ * Monitor shards reserve slots with an atomic add on the header. A record is
+ * valid once its seq matches its position, so readers can skip torn records.
+ */
+static inline void trace_record(const GpioIntEvent *event, uint8_t flags)
+{
+    GpioIntTraceHeader *trace = atomic_load_explicit(&g_gpio_trace, memory_order_acquire);
+    
+    if (!trace) {
+        return;
+    }
+    
+    uint64_t n = __atomic_fetch_add(&trace->head, 1, __ATOMIC_RELAXED);
+    GpioIntTraceRecord *rec = (GpioIntTraceRecord *)(trace + 1) + (n & (trace->capacity - 1));
+    uint64_t latency = (event->dispatch_ns > event->timestamp_ns) ? event->dispatch_ns - event->timestamp_ns : 0;
+    
+    __atomic_store_n(&rec->seq, 0, __ATOMIC_RELAXED);
+    atomic_thread_fence(memory_order_release);
+    
+    rec->timestamp_ns = event->timestamp_ns;
+    rec->icount = event->icount;
+    rec->missed = event->missed;
+    rec->latency_ns = (latency > UINT32_MAX) ? UINT32_MAX : (uint32_t)latency;
+    rec->channel = event->channel;
+    rec->gpio_value = (uint8_t)event->gpio_value;
+    rec->edge = event->edge;
+    rec->flags = flags;
+    
+    __atomic_store_n(&rec->seq, (uint32_t)(n + 1), __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Publish an event to the cross-process bus
+ * @param shard Monitor shard publishing the event
+ * @param event Dispatched event
+ * 
+ * Subscribers are woken once at the end of the pass, see bus_wake().
+ */
+static inline void bus_publish(MonitorShard *shard, const GpioIntEvent *event)
+{
+    GpioIntBusHeader *bus = atomic_load_explicit(&g_gpio_bus, memory_order_acquire);
+    
+    if (!bus) {
+        return;
+    }
+    
+    uint64_t n = __atomic_fetch_add(&bus->head, 1, __ATOMIC_RELAXED);
+    GpioIntBusSlot *slot = gpio_int_bus_slot(bus, n);
+    
+    __atomic_store_n(&slot->seq, 2 * n + 1, __ATOMIC_RELAXED);
+    atomic_thread_fence(memory_order_release);
+    slot->event = *event;
+    __atomic_store_n(&slot->seq, 2 * n + 2, __ATOMIC_RELEASE);
+    
+    shard->bus_pending = true;
+}
+
+/**
+ * @brief Wake the subscribers sleeping on the bus
+ * @param bus Mapped bus
+ * 
+ * The futex syscall is skipped while no subscriber sleeps.
+ */
+static void bus_wake(GpioIntBusHeader *bus)
+{
+    __atomic_fetch_add(&bus->wake, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&bus->waiters, __ATOMIC_SEQ_CST) > 0) {
+        syscall(SYS_futex, &bus->wake, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+    }
+}
+
+/**
+ * @brief Publish the state of a channel to the state cache
+ * @param channel GPIO interrupt channel number
+ * @param value GPIO value, -1 if unknown
+ * @param edge GpioIntEdge of the event
+ * @param timestamp_ns Event timestamp, 0 if not from an event
+ * @param events Events since the channel was brought up
+ */
+static inline void state_store(uint16_t channel, int value, uint8_t edge, uint64_t timestamp_ns, uint64_t events)
+{
+    ChannelState *state = &g_channel_cache[channel];
+    uint32_t seq = atomic_load_explicit(&state->seq, memory_order_relaxed);
+    
+    atomic_store_explicit(&state->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    state->value = value;
+    state->edge = edge;
+    state->timestamp_ns = timestamp_ns;
+    state->events = events;
+    atomic_store_explicit(&state->seq, seq + 2, memory_order_release);
+}
+
+/**
+ * @brief Read a consistent copy of the cached state of a channel
+ * @param channel GPIO interrupt channel number
+ * @param out Output state
+ */
+static inline void state_load(uint16_t channel, GpioIntState *out)
+{
+    const ChannelState *state = &g_channel_cache[channel];
+    uint32_t seq;
+    
+    do {
+        seq = atomic_load_explicit(&state->seq, memory_order_acquire);
+        out->gpio_value = state->value;
+        out->edge = state->edge;
+        out->timestamp_ns = state->timestamp_ns;
+        out->seq = state->events;
+        atomic_thread_fence(memory_order_acquire);
+    } while ((seq & 1u) || atomic_load_explicit(&state->seq, memory_order_relaxed) != seq);
+}
+
+/**
+ * @brief Check a rule configuration against a channel table
+ * @param cfg Rule configuration
+ * @param int_cnt Number of channels
+ * @return bool true if valid, an unused rule (term_cnt 0) included
+ */
+static bool rule_cfg_valid(const GpioIntRuleCfg *cfg, uint16_t int_cnt)
+{
+    if (cfg->op > GPIO_INT_RULE_SEQ || cfg->term_cnt > GPIO_INT_RULE_MAX_TERMS) {
+        return false;
+    }
+    
+    for (uint8_t i = 0; i < cfg->term_cnt; i++) {
+        if (cfg->term[i].channel >= int_cnt || cfg->term[i].level > 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Check whether a rule term is asserted in the state cache
+ * @param term Rule term
+ * @param state Output cached state of the term channel
+ * @return bool true if the channel is at the term level
+ */
+static inline bool rule_term_true(const GpioIntRuleTerm *term, GpioIntState *state)
+{
+    state_load(term->channel, state);
+    return state->gpio_value == (int)term->level;
+}
+
+/**
+ * @brief Check whether an event asserted a rule term
+ * @param term Rule term
+ * @param event Event of the term channel
+ * @param prev_value Value of the channel before the event
+ * @return bool true if the channel moved to the term level
+ */
+static inline bool rule_term_rose(const GpioIntRuleTerm *term, const GpioIntEvent *event, int prev_value)
+{
+    return term->channel == event->channel && event->gpio_value == (int)term->level &&
+           prev_value != (int)term->level;
+}
+
+/**
+ * @brief Evaluate the condition of a rule on the state cache
+ * @param cfg Rule configuration
+ * @param first_ns Output earliest assertion among the asserted terms
+ * @return bool true if the condition holds
+ * 
+ * A SEQ rule holds while its last term is asserted, the order of the terms
+ * is tracked by rule_seq_event().
+ */
+static bool rule_condition(const GpioIntRuleCfg *cfg, uint64_t *first_ns)
+{
+    GpioIntState state;
+    uint64_t first = UINT64_MAX;
+    uint64_t last = 0;
+    
+    if (cfg->op == GPIO_INT_RULE_SEQ) {
+        bool asserted = rule_term_true(&cfg->term[cfg->term_cnt - 1], &state);
+        *first_ns = state.timestamp_ns;
+        return asserted;
+    }
+    
+    for (uint8_t i = 0; i < cfg->term_cnt; i++) {
+        if (!rule_term_true(&cfg->term[i], &state)) {
+            if (cfg->op == GPIO_INT_RULE_AND) {
+                return false;
+            }
+            continue;
+        }
+        first = (state.timestamp_ns < first) ? state.timestamp_ns : first;
+        last = (state.timestamp_ns > last) ? state.timestamp_ns : last;
+    }
+    
+    if (first == UINT64_MAX) {
+        return false;
+    }
+    
+    *first_ns = first;
+    return cfg->op != GPIO_INT_RULE_AND || cfg->window_us == 0 ||
+           last - first <= (uint64_t)cfg->window_us * 1000u;
+}
+
+/**
+ * @brief Report a match of a rule
+ * @param rule Rule index
+ * @param match_ns CLOCK_MONOTONIC time of the match
+ */
+static void rule_fire(uint8_t rule, uint64_t match_ns)
+{
+    RuleState *st = &g_rule_state[rule];
+    gpio_interrupt_rule_callback_t callback = atomic_load_explicit(&st->callback, memory_order_acquire);
+    GpioIntRuleEvent event = {
+        .rule = rule,
+        .op = g_gpio_system_ctx.rule[rule].op,
+        .channel = st->channel,
+        .first_ns = st->first_ns,
+        .timestamp_ns = st->rise_ns,
+        .match_ns = match_ns,
+        .matches = atomic_fetch_add_explicit(&st->matches, 1, memory_order_relaxed) + 1,
+    };
+    
+    if (callback) {
+        callback(&event, st->arg);
+    }
+}
+
+/**
+ * @brief Handle a rule condition becoming true
+ * @param rule Rule index
+ * @param channel Channel whose event made the condition true
+ * @param timestamp_ns Timestamp of that event
+ * @param first_ns Earliest term assertion taking part
+ * 
+ * Matches at once, or arms the hold timer to match hold_us after the event
+ * unless the condition drops first.
+ */
+static void rule_rise(uint8_t rule, uint16_t channel, uint64_t timestamp_ns, uint64_t first_ns)
+{
+    const GpioIntRuleCfg *cfg = &g_gpio_system_ctx.rule[rule];
+    RuleState *st = &g_rule_state[rule];
+    
+    st->active = true;
+    st->channel = channel;
+    st->rise_ns = timestamp_ns;
+    st->first_ns = first_ns;
+    
+    if (cfg->hold_us == 0) {
+        rule_fire(rule, gpio_int_now_ns());
+        return;
+    }
+    
+    /* An absolute deadline already passed expires at once */
+    uint64_t deadline_ns = timestamp_ns + (uint64_t)cfg->hold_us * 1000u;
+    struct itimerspec its = { .it_value = { .tv_sec = (time_t)(deadline_ns / 1000000000u),
+                                            .tv_nsec = (long)(deadline_ns % 1000000000u) } };
+    if (timerfd_settime(st->timer_fd, TFD_TIMER_ABSTIME, &its, NULL) != 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to arm hold timer of rule %u\n", rule);
+        return;
+    }
+    st->held = true;
+}
+
+/**
+ * @brief Handle a rule condition dropping, cancelling a pending hold
+ * @param rule Rule index
+ */
+static void rule_fall(uint8_t rule)
+{
+    RuleState *st = &g_rule_state[rule];
+    
+    st->active = false;
+    if (st->held) {
+        struct itimerspec its = { 0 };
+        if (timerfd_settime(st->timer_fd, 0, &its, NULL) != 0) {
+            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to stop hold timer of rule %u\n", rule);
+        }
+        st->held = false;
+    }
+}
+
+/**
+ * @brief Advance a SEQ rule on an event of one of its channels
+ * @param rule Rule index
+ * @param event Event of a term channel
+ * @param prev_value Value of the channel before the event
+ * 
+ * The terms must be asserted in order, the last one within window_us of the
+ * first when a window is set. An assertion of the first term out of order
+ * restarts the sequence.
+ */
+static void rule_seq_event(uint8_t rule, const GpioIntEvent *event, int prev_value)
+{
+    const GpioIntRuleCfg *cfg = &g_gpio_system_ctx.rule[rule];
+    RuleState *st = &g_rule_state[rule];
+    const GpioIntRuleTerm *last = &cfg->term[cfg->term_cnt - 1];
+    uint64_t timestamp_ns = event->timestamp_ns;
+    
+    if (st->active && last->channel == event->channel && event->gpio_value != (int)last->level) {
+        rule_fall(rule);
+    }
+    
+    if (st->next > 0 && cfg->window_us != 0 &&
+        timestamp_ns - st->seq_start_ns > (uint64_t)cfg->window_us * 1000u) {
+        st->next = 0;
+    }
+    
+    if (rule_term_rose(&cfg->term[st->next], event, prev_value)) {
+        if (st->next == 0) {
+            st->seq_start_ns = timestamp_ns;
+        }
+        st->next++;
+    } else if (st->next > 0 && rule_term_rose(&cfg->term[0], event, prev_value)) {
+        st->seq_start_ns = timestamp_ns;
+        st->next = 1;
+    } else {
+        return;
+    }
+    
+    if (st->next == cfg->term_cnt) {
+        st->next = 0;
+        if (!st->active) {
+            rule_rise(rule, event->channel, timestamp_ns, st->seq_start_ns);
+        }
+    }
+}
+
+/**
+ * @brief Evaluate the rules with a term on the channel of an event
+ * @param shard Monitor shard servicing the channel
+ * @param event Event just stored in the state cache
+ * @param prev_value Value of the channel before the event
+ * @param rules Mask of the rules to evaluate
+ */
+static void rule_channel_event(MonitorShard *shard, const GpioIntEvent *event, int prev_value, uint16_t rules)
+{
+    uint64_t first_ns;
+    
+    while (rules != 0) {
+        uint8_t rule = (uint8_t)__builtin_ctz(rules);
+        const GpioIntRuleCfg *cfg = &g_gpio_system_ctx.rule[rule];
+        RuleState *st = &g_rule_state[rule];
+        
+        rules &= (uint16_t)(rules - 1u);
+        
+        /* A channel moving to another shard restarts its rules, skip events of the old one */
+        if (st->shard != shard->index) {
+            continue;
+        }
+        
+        if (cfg->op == GPIO_INT_RULE_SEQ) {
+            rule_seq_event(rule, event, prev_value);
+            continue;
+        }
+        
+        bool asserted = rule_condition(cfg, &first_ns);
+        if (asserted && !st->active) {
+            rule_rise(rule, event->channel, event->timestamp_ns, first_ns);
+        } else if (!asserted && st->active) {
+            rule_fall(rule);
+        }
+    }
+}
+
+/**
+ * @brief Match a held rule once its hold timer expired
+ * @param rule Rule index
+ * @param now_ns CLOCK_MONOTONIC time of the wakeup
+ * 
+ * Every change of a term channel is evaluated before the timer, so the
+ * condition is only rechecked for channels taken down meanwhile.
+ */
+static void rule_timer_expired(uint8_t rule, uint64_t now_ns)
+{
+    RuleState *st = &g_rule_state[rule];
+    uint64_t expirations;
+    uint64_t first_ns;
+    
+    if (read(st->timer_fd, &expirations, sizeof(expirations)) != sizeof(expirations) || !st->held) {
+        return;
+    }
+    
+    st->held = false;
+    if (rule_condition(&g_gpio_system_ctx.rule[rule], &first_ns)) {
+        rule_fire(rule, now_ns);
+    } else {
+        st->active = false;
+    }
+}
+
+/**
+ * @brief Deliver an event to the channel callback and collect it for batch subscribers
+ * @param shard Monitor shard servicing the channel
+ * @param event Event to deliver
+ * 
+ * The rules with a term on the channel are evaluated last, on the updated
+ * state cache.
+ */
+static inline void emit_channel_event(MonitorShard *shard, GpioIntEvent *event)
+{
+    uint8_t flags = GPIO_INT_TRACE_UNQUEUED;
+    const GpioIntChannel *ch = &g_gpio_system_ctx.ch[event->channel];
+    
+    if (!channel_has_consumer(event->channel)) {
+        event->dispatch_ns = gpio_int_now_ns();
+    } else if (ch->priority == GPIO_INT_PRIO_CRITICAL && ch->dispatch == GPIO_INT_DISPATCH_INLINE &&
+               channel_has_callback(event->channel)) {
+        dispatch_inline_event(event);
+    } else {
+        flags = dispatch_channel_event(event);
+    }
+    
+    int prev_value = g_channel_cache[event->channel].value;
+    state_store(event->channel, event->gpio_value, event->edge, event->timestamp_ns,
+                g_channel_cache[event->channel].events + 1);
+    trace_record(event, flags);
+    bus_publish(shard, event);
+    batch_append(shard, event);
+    
+    uint16_t rules = atomic_load_explicit(&g_channel_rules[event->channel], memory_order_acquire);
+    if (rules != 0) {
+        rule_channel_event(shard, event, prev_value, rules);
+    }
+}
+
+/**
+ * @brief Reset the event queue, edge sequence and statistics of a channel being brought up
+ * @param ctx Context pointer
+ * @param channel GPIO interrupt channel number
+ */
+static void reset_channel_runtime(GpioIntCtx *ctx, uint16_t channel)
+{
+    CallbackWorker *worker = &g_channel_worker[channel];
+    
+    event_queue_reset(&g_channel_queue[channel], ctx->ch[channel].overflow_policy);
+    g_channel_hot[channel].edge_seq = 0;
+    g_channel_hot[channel].last_icount = NO_ICOUNT;
+    atomic_store_explicit(&g_channel_hot[channel].delivery, CHANNEL_IDLE, memory_order_relaxed);
+    gpio_int_reset_stats(channel);
+    
+    /* Seed the state cache, the monitor thread does not own the channel yet */
+    state_store(channel, channel_read_value(ctx, channel), GPIO_INT_EDGE_NONE, 0, 0);
+    
+    /* A pull consumer's fd must not stay readable for events discarded above */
+    if (worker->pull) {
+        uint64_t kicks;
+        if (read(worker->wake_fd, &kicks, sizeof(kicks)) < 0 && errno != EAGAIN) {
+            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "Failed to reset event fd of channel %u\n", channel);
+        }
+    }
+}
+
+/**
+ * @brief Check whether a channel filter needs a timer
+ * @param filter Filter configuration
+ * @return bool true if debounce or minimum pulse width is configured
+ */
+static inline bool filter_is_timed(const GpioIntFilterCfg *filter)
+{
+    return filter->debounce_us != 0 || filter->min_pulse_us != 0;
+}
+
+/**
+ * @brief Check a transition against the edge direction filter
+ * @param filter Filter configuration
+ * @param value Line level after the transition
+ * @return bool true if the transition is passed on
+ */
+static inline bool filter_edge_passes(const GpioIntFilterCfg *filter, int value)
+{
+    return filter->edge_filter == GPIO_INT_FILTER_BOTH ||
+           (filter->edge_filter == GPIO_INT_FILTER_RISING) == (value != 0);
+}
+
+/**
+ * @brief Feed a raw interrupt into the channel's timed filter
+ * @param channel GPIO interrupt channel number
+ * @param value Line level after the edge, -1 if not sampled (UIO mode)
+ * @param icount Interrupt count of the raw interrupt
+ * @param missed Interrupts coalesced into this one
+ * @param timestamp_ns Event timestamp of the raw interrupt
+ * @param now_ns CLOCK_MONOTONIC time of the wakeup
+ * 
+ * (Re)arms the filter timer for the later of last edge + debounce_us and
+ * first edge + min_pulse_us. The transition is judged when it expires.
+ */
+static void filter_raw_interrupt(uint16_t channel, int value, uint32_t icount, uint32_t missed,
+                                 uint64_t timestamp_ns, uint64_t now_ns)
+{
+    const GpioIntFilterCfg *cfg = &g_gpio_system_ctx.ch[channel].filter;
+    ChannelFilter *filter = &g_channel_filter[channel];
+    
+    if (!filter->armed) {
+        filter->start_ns = now_ns;
+        filter->first_ts = timestamp_ns;
+        filter->raw_cnt = 0;
+        filter->missed = 0;
+    }
+    
+    filter->last_value = value;
+    filter->icount = icount;
+    filter->raw_cnt++;
+    filter->missed += missed;
+    
+    uint64_t deadline = now_ns + (uint64_t)cfg->debounce_us * 1000u;
+    uint64_t pulse_end = filter->start_ns + (uint64_t)cfg->min_pulse_us * 1000u;
+    if (pulse_end > deadline) {
+        deadline = pulse_end;
+    }
+    
+    struct itimerspec its = {
+        .it_value = { .tv_sec = (time_t)(deadline / 1000000000u), .tv_nsec = (long)(deadline % 1000000000u) },
+    };
+    if (timerfd_settime(filter->timer_fd, TFD_TIMER_ABSTIME, &its, NULL) != 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to arm filter timer for channel %u\n", channel);
+        return;
+    }
+    
+    filter->armed = true;
+}
+
+/**
+ * @brief Judge the pending transition of a channel once its filter timer expired
+ * @param channel GPIO interrupt channel number
+ * @param gpio_ctx Pointer to GPIO interrupt context
+ * @param shard Monitor shard servicing the channel
+ * 
+ * The transition is reported only if the line now differs from the last
+ * reported level and the edge direction passes. All raw interrupts that did
+ * not become an event are counted as filtered.
+ */
+static void filter_timer_expired(uint16_t channel, GpioIntCtx *gpio_ctx, MonitorShard *shard)
+{
+    const GpioIntChannel *ch = &gpio_ctx->ch[channel];
+    ChannelFilter *filter = &g_channel_filter[channel];
+    uint64_t expirations;
+    
+    /* Nothing to read if the timer was re-armed after it fired */
+    if (read(filter->timer_fd, &expirations, sizeof(expirations)) != sizeof(expirations) || !filter->armed) {
+        return;
+    }
+    filter->armed = false;
+    
+    int value = filter->last_value;
+    if (ch->pin_cfg.mode != GPIO_INT_MODE_EDGE || value < 0) {
+        value = channel_read_value(gpio_ctx, channel);
+        if (value < 0) {
+            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to read GPIO value for channel %u\n", channel);
+            return;
+        }
+    }
+    
+    uint32_t absorbed = filter->raw_cnt;
+    
+    if (value != filter->stable_value) {
+        filter->stable_value = value;
+        
+        if (filter_edge_passes(&ch->filter, value)) {
+            GpioIntEvent event = {
+                .channel = channel,
+                .edge = value ? GPIO_INT_EDGE_RISING : GPIO_INT_EDGE_FALLING,
+                .gpio_value = value,
+                .icount = filter->icount,
+                .count = 1,
+                .missed = filter->missed,
+                .timestamp_ns = filter->first_ts,
+            };
+            
+            emit_channel_event(shard, &event);
+            absorbed--;
+        }
+    }
+    
+    if (absorbed > 0) {
+        atomic_fetch_add_explicit(&g_channel_stats[channel].filtered, absorbed, memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Get the poll period of a channel's storm protection
+ * @param cfg Storm protection configuration
+ * @return uint32_t Poll period in microseconds
+ */
+static inline uint32_t storm_poll_us(const GpioIntStormCfg *cfg)
+{
+    return cfg->poll_us ? cfg->poll_us : GPIO_INT_STORM_POLL_US;
+}
+
+/**
+ * @brief Check a storm protection configuration
+ * @param cfg Storm protection configuration
+ * @return bool true if disabled, or if polling is slower than the storm rate
+ */
+static inline bool storm_cfg_valid(const GpioIntStormCfg *cfg)
+{
+    return cfg->max_rate == 0 || (uint64_t)cfg->max_rate * storm_poll_us(cfg) > 1000000u;
+}
+
+/**
+ * @brief Set the epoll events of an edge mode channel's event fd
+ * @param shard Monitor shard servicing the channel
+ * @param channel GPIO interrupt channel number
+ * @param events EPOLLIN for interrupt mode, EPOLLIN | EPOLLONESHOT to arm one
+ *               poll, EPOLLONESHOT alone to mask the fd
+ */
+static void storm_edge_arm(MonitorShard *shard, uint16_t channel, uint32_t events)
+{
+    struct epoll_event ev = { .events = events, .data.u32 = channel };
+    int fd = g_gpio_backend->get_event_fd(&g_gpio_system_ctx, channel);
+    
+    if (epoll_ctl(shard->epoll_fd, EPOLL_CTL_MOD, fd, &ev) != 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to re-arm edge events of channel %u\n", channel);
+    }
+}
+
+/**
+ * @brief Re-arm the UIO interrupt of a storm polling channel
+ * @param shard Monitor shard servicing the channel
+ * @param channel GPIO interrupt channel number
+ */
+static void storm_enable_irq(MonitorShard *shard, uint16_t channel)
+{
+    if (shard->use_uring) {
+        uring_post_enable(shard, channel);
+    } else if (g_gpio_backend->enable_irq(&g_gpio_system_ctx, channel) != 0) {
+        atomic_fetch_add_explicit(&g_channel_stats[channel].reenable_failures, 1, memory_order_relaxed);
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to re-enable IRQ for channel %u\n", channel);
+    }
+}
+
+/**
+ * @brief Report a storm transition
+ * @param channel GPIO interrupt channel number
+ * @param storm 1 when polling starts, 0 when it ends
+ * @param cnt Interrupts in the window
+ * @param elapsed_ns Length of the window
+ */
+static void storm_notify(uint16_t channel, uint8_t storm, uint32_t cnt, uint64_t elapsed_ns)
+{
+    gpio_interrupt_storm_callback_t callback = atomic_load(&g_gpio_storm_callback);
+    uint64_t elapsed_us = (elapsed_ns > 1000u) ? elapsed_ns / 1000u : 1u;
+    uint64_t rate = (uint64_t)cnt * 1000000u / elapsed_us;
+    
+    if (rate > UINT32_MAX) {
+        rate = UINT32_MAX;
+    }
+    
+    DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "Channel %u %s storm polling (%llu/s)\n", channel,
+                     storm ? "entered" : "left", (unsigned long long)rate);
+    if (callback) {
+        callback(channel, storm, (uint32_t)rate);
+    }
+}
+
+/**
+ * @brief Account a wakeup of a channel against its storm limit
+ * @param shard Monitor shard servicing the channel
+ * @param channel GPIO interrupt channel number
+ * @param cnt Interrupts taken in the wakeup
+ * @param now_ns CLOCK_MONOTONIC time of the wakeup
+ * @return bool true if the UIO interrupt must stay disabled until the next poll
+ * 
+ * Switches the channel to storm polling once it exceeds its limit within
+ * the window. Edge mode channels are masked here; UIO channels are masked
+ * by the caller skipping the re-enable. While polling, the interrupts are
+ * still counted so the timer can measure the rate.
+ */
+static bool storm_wakeup(MonitorShard *shard, uint16_t channel, uint32_t cnt, uint64_t now_ns)
+{
+    ChannelStorm *storm = &g_channel_storm[channel];
+    
+    if (storm->timer_fd < 0) {
+        return false;
+    }
+    
+    if (atomic_load_explicit(&storm->polling, memory_order_relaxed)) {
+        storm->fired = true;
+        storm->window_cnt += cnt;
+        if (cnt >= GPIO_INT_EVENT_BATCH &&
+            g_gpio_system_ctx.ch[channel].pin_cfg.mode == GPIO_INT_MODE_EDGE) {
+            storm->saturated = true;
+        }
+        return true;
+    }
+    
+    if (now_ns - storm->window_start >= storm->window_ns) {
+        storm->window_start = now_ns;
+        storm->window_cnt = 0;
+    }
+    
+    storm->window_cnt += cnt;
+    if (storm->window_cnt <= storm->limit) {
+        return false;
+    }
+    
+    uint32_t poll_us = storm_poll_us(&g_gpio_system_ctx.ch[channel].storm);
+    struct timespec period = { .tv_sec = (time_t)(poll_us / 1000000u), .tv_nsec = (long)(poll_us % 1000000u) * 1000L };
+    struct itimerspec its = { .it_value = period, .it_interval = period };
+    if (timerfd_settime(storm->timer_fd, 0, &its, NULL) != 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to arm storm poll timer for channel %u\n", channel);
+        return false;
+    }
+    
+    if (g_gpio_system_ctx.ch[channel].pin_cfg.mode == GPIO_INT_MODE_EDGE) {
+        storm_edge_arm(shard, channel, EPOLLONESHOT);
+    }
+    
+    uint32_t window_cnt = storm->window_cnt;
+    uint64_t elapsed_ns = now_ns - storm->window_start;
+    
+    atomic_store_explicit(&storm->polling, true, memory_order_relaxed);
+    storm->fired = true;
+    storm->saturated = false;
+    storm->window_start = now_ns;
+    storm->window_cnt = 0;
+    atomic_fetch_add_explicit(&g_channel_stats[channel].storms, 1, memory_order_relaxed);
+    
+    storm_notify(channel, 1, window_cnt, elapsed_ns);
+    return true;
+}
+
+/**
+ * @brief Account a UIO wakeup of a channel against its storm limit
+ * @param shard Monitor shard servicing the channel
+ * @param channel GPIO interrupt channel number
+ * @param icount UIO interrupt count read on this wakeup
+ * @param now_ns CLOCK_MONOTONIC time of the wakeup
+ * @return bool true if the UIO interrupt must stay disabled until the next poll
+ * 
+ * Counts the icount delta since the previous wakeup. While the IRQ is
+ * masked for polling the line is disabled and icount stands still, so each
+ * polled wakeup counts one interrupt however often the line toggled.
+ */
+static bool storm_uio_wakeup(MonitorShard *shard, uint16_t channel, uint32_t icount, uint64_t now_ns)
+{
+    ChannelStorm *storm = &g_channel_storm[channel];
+    uint32_t cnt = 1;
+    
+    if (storm->timer_fd < 0) {
+        return false;
+    }
+    
+    if (storm->last_icount != NO_ICOUNT && icount - (uint32_t)storm->last_icount > 1) {
+        cnt = icount - (uint32_t)storm->last_icount;   /* Wraps with the 32-bit UIO counter */
+    }
+    storm->last_icount = icount;
+    
+    return storm_wakeup(shard, channel, cnt, now_ns);
+}
+
+/**
+ * @brief Poll a storm polling channel once its poll timer expired
+ * @param channel GPIO interrupt channel number
+ * @param shard Monitor shard servicing the channel
+ * @param now_ns CLOCK_MONOTONIC time of the wakeup
+ * 
+ * Re-arms the source if it fired during the last period. An edge channel
+ * returns to interrupt mode after a window whose measured interrupt rate
+ * fell below half of max_rate; the gap to max_rate keeps a line running
+ * close to the limit from flapping between the two modes. A UIO channel
+ * cannot measure its rate while masked and returns after a window in which
+ * no poll found it fired.
+ */
+static void storm_timer_expired(uint16_t channel, MonitorShard *shard, uint64_t now_ns)
+{
+    ChannelStorm *storm = &g_channel_storm[channel];
+    uint64_t expirations;
+    
+    if (read(storm->timer_fd, &expirations, sizeof(expirations)) != sizeof(expirations) ||
+        !atomic_load_explicit(&storm->polling, memory_order_relaxed)) {
+        return;
+    }
+    
+    bool fired = storm->fired;
+    storm->fired = false;
+    
+    bool edge = (g_gpio_system_ctx.ch[channel].pin_cfg.mode == GPIO_INT_MODE_EDGE);
+    uint64_t elapsed_ns = now_ns - storm->window_start;
+    bool quiet = elapsed_ns >= storm->window_ns;
+    
+    if (quiet && edge) {
+        quiet = !storm->saturated && (uint64_t)storm->window_cnt * 2000000000u <
+                (uint64_t)g_gpio_system_ctx.ch[channel].storm.max_rate * elapsed_ns;
+    } else if (quiet) {
+        quiet = (storm->window_cnt == 0);
+    }
+    
+    if (!quiet) {
+        if (elapsed_ns >= storm->window_ns) {
+            storm->window_start = now_ns;
+            storm->window_cnt = 0;
+            storm->saturated = false;
+        }
+        if (fired && edge) {
+            storm_edge_arm(shard, channel, EPOLLIN | EPOLLONESHOT);
+        } else if (fired) {
+            storm_enable_irq(shard, channel);
+        }
+        return;
+    }
+    
+    struct itimerspec its = { 0 };
+    if (timerfd_settime(storm->timer_fd, 0, &its, NULL) != 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to stop storm poll timer for channel %u\n", channel);
+    }
+    
+    uint32_t window_cnt = storm->window_cnt;
+    
+    atomic_store_explicit(&storm->polling, false, memory_order_relaxed);
+    storm->window_start = now_ns;
+    storm->window_cnt = 0;
+    
+    /* An edge fd may still be armed one-shot, a UIO interrupt is still enabled unless it fired */
+    if (edge) {
+        storm_edge_arm(shard, channel, EPOLLIN);
+    } else if (fired) {
+        storm_enable_irq(shard, channel);
+    }
+    
+    storm_notify(channel, 0, window_cnt, elapsed_ns);
+}
+
+/**
+ * @brief Account the time a counter channel spent at its latest level
+ * @param counter Counter state
+ * @param now_ns End of the interval
+ */
+static inline void counter_account_level(ChannelCounter *counter, uint64_t now_ns)
+{
+    if (now_ns <= counter->level_ns) {
+        return;
+    }
+    
+    if (counter->level == 1) {
+        counter->window.high_ns += now_ns - counter->level_ns;
+    } else if (counter->level == 0) {
+        counter->window.low_ns += now_ns - counter->level_ns;
+    }
+    counter->level_ns = now_ns;
+}
+
+/**
+ * @brief Account an edge or wakeup of a counter channel
+ * @param channel GPIO interrupt channel number
+ * @param value Level after the edge, -1 if it could not be read
+ * @param edge GpioIntEdge, GPIO_INT_EDGE_NONE in UIO mode
+ * @param edges Interrupts represented, missed ones included
+ * @param timestamp_ns Kernel edge time or UIO wakeup time
+ */
+static void counter_edge(uint16_t channel, int value, uint8_t edge, uint32_t edges, uint64_t timestamp_ns)
+{
+    ChannelCounter *counter = &g_channel_counter[channel];
+    GpioIntCounterReport *window = &counter->window;
+    
+    /* The time since the previous edge belongs to the previous level */
+    window->edges += edges;
+    counter_account_level(counter, timestamp_ns);
+    
+    /* A UIO wakeup is only known to be a rising edge for a single interrupt from low to high */
+    bool uio = (edge == GPIO_INT_EDGE_NONE);
+    bool rising = uio ? (edges == 1 && counter->level == 0 && value == 1) : (edge == GPIO_INT_EDGE_RISING);
+    
+    if (rising) {
+        if (counter->rise_ns != 0 && timestamp_ns > counter->rise_ns) {
+            uint64_t period_ns = timestamp_ns - counter->rise_ns;
+            
+            if (window->periods == 0 || period_ns < window->min_period_ns) {
+                window->min_period_ns = period_ns;
+            }
+            if (period_ns > window->max_period_ns) {
+                window->max_period_ns = period_ns;
+            }
+            window->periods++;
+        }
+        counter->rise_ns = timestamp_ns;
+    } else if (uio && (edges > 1 || value == counter->level)) {
+        /* Coalesced or unseen edges, the next rising edge starts a new period */
+        counter->rise_ns = 0;
+    }
+    
+    counter->level = value;
+    counter->edge = edge;
+    counter->edge_ns = timestamp_ns;
+}
+
+/**
+ * @brief Close the window of a counter channel once its timer expired
+ * @param channel GPIO interrupt channel number
+ * @param now_ns CLOCK_MONOTONIC time of the wakeup
+ * 
+ * Publishes the report for gpio_int_get_counter(), updates the state cache
+ * and hands the report to the counter callback.
+ */
+static void counter_timer_expired(uint16_t channel, uint64_t now_ns)
+{
+    ChannelCounter *counter = &g_channel_counter[channel];
+    GpioIntCounterReport *window = &counter->window;
+    uint64_t expirations;
+    
+    if (read(counter->timer_fd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+        return;
+    }
+    
+    counter_account_level(counter, now_ns);
+    
+    uint64_t elapsed_ns = now_ns - window->start_ns;
+    uint64_t known_ns = window->high_ns + window->low_ns;
+    uint64_t rate = elapsed_ns ? (uint64_t)window->edges * 1000000000u / elapsed_ns : 0;
+    
+    window->gpio_value = counter->level;
+    window->end_ns = now_ns;
+    window->rate = (rate > UINT32_MAX) ? UINT32_MAX : (uint32_t)rate;
+    window->duty_permille = known_ns ? (uint16_t)(window->high_ns * 1000u / known_ns) : 0;
+    
+    uint32_t seq = atomic_load_explicit(&counter->seq, memory_order_relaxed);
+    atomic_store_explicit(&counter->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    counter->report = *window;
+    atomic_store_explicit(&counter->seq, seq + 2, memory_order_release);
+    
+    if (window->edges != 0) {
+        state_store(channel, counter->level, counter->edge, counter->edge_ns,
+                    g_channel_cache[channel].events + window->edges);
+    }
+    
+    gpio_interrupt_counter_callback_t callback = atomic_load_explicit(&counter->callback, memory_order_acquire);
+    if (callback) {
+        callback(window, counter->arg);
+    }
+    
+    memset(window, 0, sizeof(*window));
+    window->channel = channel;
+    window->start_ns = now_ns;
+}
+
+/**
+ * @brief GPIO interrupt service routine
+ * @param channel GPIO interrupt channel number
+ * @param gpio_ctx Pointer to GPIO interrupt context
+ * @param shard Monitor shard servicing the channel
+ * @param icount UIO interrupt count read on wakeup
+ * @param timestamp_ns CLOCK_MONOTONIC time of the wakeup
+ * 
+ * This function reads GPIO value, queues it for the channel worker and
+ * collects it for batch subscribers. Channels with a timed filter hand the
+ * interrupt to the filter instead and skip the value read. Counter channels
+ * only account the wakeup.
+ */
+static void gpio_interrupt_handler(uint16_t channel, GpioIntCtx *gpio_ctx, MonitorShard *shard,
+                                   uint32_t icount, uint64_t timestamp_ns)
+{    
+    if (channel >= g_channel_state_cnt) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Invalid GPIO interrupt channel: %u\n", channel);
+        return;
+    }
+    
+    atomic_fetch_add_explicit(&g_channel_stats[channel].interrupts, 1, memory_order_relaxed);
+    uint32_t missed = track_missed_interrupts(channel, icount);
+    
+    /* Counter channels are only accounted, nothing is dispatched */
+    if (g_channel_counter[channel].timer_fd >= 0) {
+        counter_edge(channel, channel_read_value(gpio_ctx, channel), GPIO_INT_EDGE_NONE, 1 + missed, timestamp_ns);
+        return;
+    }
+    
+    /* Bounces only re-arm the filter timer, the line is sampled once it settles */
+    const GpioIntFilterCfg *filter = &gpio_ctx->ch[channel].filter;
+    if (filter_is_timed(filter)) {
+        filter_raw_interrupt(channel, -1, icount, missed, timestamp_ns, timestamp_ns);
+        return;
+    }
+    
+    /* Read current GPIO value */
+    int gpio_value = channel_read_value(gpio_ctx, channel);
+    if (gpio_value < 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to read GPIO value for channel %u\n", channel);
+        return;
+    }
+    
+    if (!filter_edge_passes(filter, gpio_value)) {
+        atomic_fetch_add_explicit(&g_channel_stats[channel].filtered, 1, memory_order_relaxed);
+        return;
+    }
+ 
+    GpioIntEvent event = {
+        .channel = channel,
+        .edge = GPIO_INT_EDGE_NONE,
+        .gpio_value = gpio_value,
+        .icount = icount,
+        .count = 1,
+        .missed = missed,
+        .timestamp_ns = timestamp_ns,
+    };
+    
+    emit_channel_event(shard, &event);
+}
+
+/**
+ * @brief GPIO edge event service routine for GPIO_INT_MODE_EDGE channels
+ * @param channel GPIO interrupt channel number
+ * @param gpio_ctx Pointer to GPIO interrupt context
+ * @param shard Monitor shard servicing the channel
+ * 
+ * Reads a batch of pending gpiod line events and queues one event per edge
+ * with the kernel timestamp. The value is derived from the edge type, so no
+ * extra syscall is needed to sample the line. Edges of a channel with a
+ * timed filter go through the filter instead, edges of a counter channel
+ * are only accounted.
+ */
+static void gpio_edge_event_handler(uint16_t channel, GpioIntCtx *gpio_ctx, MonitorShard *shard)
+{
+    GpioIntEvent events[GPIO_INT_EVENT_BATCH];
+    
+    int n = g_gpio_backend->read_events(gpio_ctx, channel, events, GPIO_INT_EVENT_BATCH);
+    if (n < 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to read GPIO edge events for channel %u\n", channel);
+        return;
+    }
+    
+    atomic_fetch_add_explicit(&g_channel_stats[channel].interrupts, (uint64_t)n, memory_order_relaxed);
+    
+    const GpioIntFilterCfg *filter = &gpio_ctx->ch[channel].filter;
+    bool timed = filter_is_timed(filter);
+    uint64_t now_ns = (timed || g_channel_storm[channel].timer_fd >= 0) ? gpio_int_now_ns() : 0;
+    
+    storm_wakeup(shard, channel, (uint32_t)n, now_ns);
+    
+    if (g_channel_counter[channel].timer_fd >= 0) {
+        for (int i = 0; i < n; i++) {
+            counter_edge(channel, events[i].gpio_value, events[i].edge, 1, events[i].timestamp_ns);
+        }
+        return;
+    }
+    
+    uint64_t rejected = 0;
+    
+    for (int i = 0; i < n; i++) {
+        events[i].channel = channel;
+        events[i].icount = ++g_channel_hot[channel].edge_seq;
+        events[i].count = 1;
+        events[i].missed = 0;
+        
+        if (timed) {
+            filter_raw_interrupt(channel, events[i].gpio_value, events[i].icount, 0,
+                                 events[i].timestamp_ns, now_ns);
+        } else if (!filter_edge_passes(filter, events[i].gpio_value)) {
+            rejected++;
+        } else {
+            emit_channel_event(shard, &events[i]);
+        }
+    }
+    
+    if (rejected > 0) {
+        atomic_fetch_add_explicit(&g_channel_stats[channel].filtered, rejected, memory_order_relaxed);
+    }
+}
+
+/* ========== Hardware Backend ========== */
+
+/**
+ * @brief gpiochip handle shared by all lines of a GPIO group
+ */
+typedef struct {
+    struct gpiod_chip   *chip;
+    uint16_t            refs;       /* Lines obtained through the handle */
+} HwChip;
+
+/**
+ * @brief Lines of one chip and consumer requested together as a gpiod bulk
+ *
+ * While every member is still requested, the whole group is sampled with a
+ * single GPIOHANDLE_GET_LINE_VALUES ioctl. Releasing a member breaks the
+ * group, its remaining members are then read one by one.
+ */
+typedef struct {
+    struct gpiod_line_bulk  bulk;
+    uint16_t                channel[GPIOD_LINE_BULK_MAX_LINES];
+    uint16_t                live;       /* Members still requested */
+    bool                    intact;     /* No member released yet */
+} HwLineGroup;
+
+static HwChip g_hw_chip[UINT8_MAX + 1];
+static HwLineGroup *g_hw_group = NULL;
+static uint16_t g_hw_group_cnt = 0;
+static uint32_t g_hw_group_live = 0;
+
+/* Line group of each channel, HW_NO_GROUP or HW_GROUP_FAILED for lines requested on their own */
+#define HW_NO_GROUP     (-1)
+#define HW_GROUP_FAILED (-2)
+static int16_t *g_hw_channel_group = NULL;
+static uint16_t g_hw_channel_cnt = 0;
+
+/**
+ * @brief Get the shared handle of a gpiochip, opening it on first use
+ * @param group_id GPIO group number (gpiochip<group_id>)
+ * @return struct gpiod_chip* Chip handle with a reference taken, NULL on failure
+ */
+static struct gpiod_chip *hw_chip_get(uint8_t group_id)
+{
+    HwChip *ref = &g_hw_chip[group_id];
+    
+    if (!ref->chip) {
+        char chipname[16];
+        snprintf(chipname, sizeof(chipname), "gpiochip%u", group_id);
+        
+        ref->chip = gpiod_chip_open_by_name(chipname);
+        if (!ref->chip) {
+            return NULL;
+        }
+    }
+    
+    ref->refs++;
+    return ref->chip;
+}
+
+/**
+ * @brief Drop a reference to a gpiochip, closing it with the last one
+ * @param group_id GPIO group number
+ */
+static void hw_chip_put(uint8_t group_id)
+{
+    HwChip *ref = &g_hw_chip[group_id];
+    
+    if (ref->refs > 0 && --ref->refs == 0) {
+        gpiod_chip_close(ref->chip);
+        ref->chip = NULL;
+    }
+}
+
+/**
+ * @brief Free the line group table once no group member is requested anymore
+ */
+static void hw_free_line_groups(void)
+{
+    free(g_hw_group);
+    free(g_hw_channel_group);
+    g_hw_group = NULL;
+    g_hw_channel_group = NULL;
+    g_hw_group_cnt = 0;
+    g_hw_group_live = 0;
+    g_hw_channel_cnt = 0;
+}
+
+/**
+ * @brief Get the line group of a channel
+ * @param channel Channel index
+ * @return HwLineGroup* Group, NULL if the line was requested on its own
+ */
+static HwLineGroup *hw_channel_group(uint16_t channel)
+{
+    if (channel >= g_hw_channel_cnt || g_hw_channel_group[channel] < 0) {
+        return NULL;
+    }
+    return &g_hw_group[g_hw_channel_group[channel]];
+}
+
+/**
+ * @brief Initialize UIO device for a channel
+ * @param cfg Pin configuration
+ * @param fd_ptr Pointer to file descriptor to set
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ */
+static uint8_t init_uio_device(const GpioIntPinCfg *cfg, int *fd_ptr)
+{
+    char dev_path[32];
+    snprintf(dev_path, sizeof(dev_path), "/dev/uio%u", cfg->uio_index);
+    
+    *fd_ptr = open(dev_path, O_RDWR);
+    if (*fd_ptr < 0) {
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    return DIS_COMMON_ERR_OK;
+}
+
+/**
+ * @brief Initialize GPIO line for a channel
+ * @param cfg Pin configuration  
+ * @param line_ptr Pointer to gpiod line to set, left NULL on failure
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ */
+static uint8_t init_gpio_line(const GpioIntPinCfg *cfg, struct gpiod_line **line_ptr)
+{
+    struct gpiod_chip *chip = hw_chip_get(cfg->group_id);
+    if (!chip) {
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    struct gpiod_line *line = gpiod_chip_get_line(chip, cfg->group_bit);
+    int rc = -1;
+    
+    if (line && cfg->mode == GPIO_INT_MODE_EDGE) {
+        rc = gpiod_line_request_both_edges_events(line, cfg->consumer);
+    } else if (line) {
+        rc = gpiod_line_request_input(line, cfg->consumer);
+    }
+    
+    if (rc != 0) {
+        hw_chip_put(cfg->group_id);
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    *line_ptr = line;
+    return DIS_COMMON_ERR_OK;
+}
+
+/**
+ * @brief Get the bulk-requested line of a group member
+ * @param group Line group
+ * @param channel Channel index
+ * @return struct gpiod_line* Line, NULL if the channel is not a member
+ */
+static struct gpiod_line *hw_group_line(const HwLineGroup *group, uint16_t channel)
+{
+    for (unsigned int k = 0; k < group->bulk.num_lines; k++) {
+        if (group->channel[k] == channel) {
+            return group->bulk.lines[k];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Request the lines of a chip and consumer as one gpiod bulk
+ * @param ctx Context pointer
+ * @param group Group with the members in channel[]
+ * @param cnt Number of members
+ * 
+ * Failure is not fatal, the members are then requested one by one.
+ */
+static void hw_request_line_group(GpioIntCtx *ctx, HwLineGroup *group, unsigned int cnt)
+{
+    const GpioIntPinCfg *first = &ctx->ch[group->channel[0]].pin_cfg;
+    
+    gpiod_line_bulk_init(&group->bulk);
+    
+    struct gpiod_chip *chip = hw_chip_get(first->group_id);
+    if (!chip) {
+        return;
+    }
+    
+    for (unsigned int k = 0; k < cnt; k++) {
+        const GpioIntPinCfg *cfg = &ctx->ch[group->channel[k]].pin_cfg;
+        struct gpiod_line *line = gpiod_chip_get_line(chip, cfg->group_bit);
+        
+        if (!line) {
+            break;
+        }
+        gpio_setPinmux(cfg->group_id, cfg->group_bit, 1);
+        gpiod_line_bulk_add(&group->bulk, line);
+    }
+    
+    if (group->bulk.num_lines != cnt || gpiod_line_request_bulk_input(&group->bulk, first->consumer) != 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "Bulk request of %u lines on gpiochip%u failed, requesting one by one\n",
+                         cnt, first->group_id);
+        hw_chip_put(first->group_id);
+        group->bulk.num_lines = 0;
+        return;
+    }
+    
+    /* Every member holds its own chip reference, released with its line */
+    for (unsigned int k = 1; k < cnt; k++) {
+        hw_chip_get(first->group_id);
+    }
+    group->live = (uint16_t)cnt;
+    group->intact = true;
+    g_hw_group_live += cnt;
+}
+
+/* gpiod v1 edge events are stamped with CLOCK_REALTIME before Linux 5.7 */
+static bool g_hw_edge_ts_realtime = false;
+
+/**
+ * @brief Detect the clock the kernel stamps gpiod edge events with (hardware backend)
+ */
+static void hw_detect_edge_clock(void)
+{
+    struct utsname uts;
+    unsigned int major = 0;
+    unsigned int minor = 0;
+    
+    if (uname(&uts) != 0 || sscanf(uts.release, "%u.%u", &major, &minor) != 2) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "Unknown kernel release, assuming monotonic edge timestamps\n");
+        return;
+    }
+    
+    g_hw_edge_ts_realtime = (major < 5 || (major == 5 && minor < 7));
+    if (g_hw_edge_ts_realtime) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "Kernel %s stamps edge events with CLOCK_REALTIME, converting\n",
+                         uts.release);
+    }
+}
+
+/**
+ * @brief Request the UIO mode lines of all enabled channels per chip and consumer (hardware backend)
+ * @param ctx Context pointer
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * Lines sharing a gpiochip and consumer become one bulk request, which opens
+ * the chip once and lets gpio_int_read_all() sample them with one ioctl.
+ * Edge mode lines need an event request each and are left to hw_init_line().
+ */
+static uint8_t hw_init_lines(GpioIntCtx *ctx)
+{
+    hw_detect_edge_clock();
+    
+    /* Groups can only be rebuilt once every line of the previous ones is gone */
+    if (g_hw_group_live > 0) {
+        return DIS_COMMON_ERR_OK;
+    }
+    hw_free_line_groups();
+    
+    g_hw_channel_group = malloc(ctx->int_cnt * sizeof(*g_hw_channel_group));
+    g_hw_group = calloc(ctx->int_cnt / 2u + 1u, sizeof(*g_hw_group));  /* Groups have two or more members */
+    if (!g_hw_channel_group || !g_hw_group) {
+        hw_free_line_groups();
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    g_hw_channel_cnt = ctx->int_cnt;
+    for (uint16_t i = 0; i < ctx->int_cnt; i++) {
+        g_hw_channel_group[i] = HW_NO_GROUP;
+    }
+    
+    FOR_EACH_ENABLED_CHANNEL(ctx, i) {
+        const GpioIntPinCfg *cfg = &ctx->ch[i].pin_cfg;
+        HwLineGroup *group = &g_hw_group[g_hw_group_cnt];
+        unsigned int cnt = 0;
+        
+        if (cfg->mode == GPIO_INT_MODE_EDGE || g_hw_channel_group[i] != HW_NO_GROUP) {
+            continue;
+        }
+        
+        /* Collect the not yet grouped UIO mode lines with the same chip and consumer */
+        for (int j = i; j >= 0 && cnt < GPIOD_LINE_BULK_MAX_LINES; j = next_enabled_channel(ctx, (uint32_t)j + 1)) {
+            const GpioIntPinCfg *other = &ctx->ch[j].pin_cfg;
+            
+            if (other->mode != GPIO_INT_MODE_EDGE && g_hw_channel_group[j] == HW_NO_GROUP &&
+                other->group_id == cfg->group_id &&
+                strncmp(other->consumer, cfg->consumer, sizeof(cfg->consumer)) == 0) {
+                group->channel[cnt++] = (uint16_t)j;
+            }
+        }
+        
+        if (cnt < 2) {
+            continue;
+        }
+        
+        hw_request_line_group(ctx, group, cnt);
+        
+        for (unsigned int k = 0; k < cnt; k++) {
+            g_hw_channel_group[group->channel[k]] = group->live ? (int16_t)g_hw_group_cnt : HW_GROUP_FAILED;
+        }
+        if (group->live) {
+            g_hw_group_cnt++;
+        }
+    }
+    
+    return DIS_COMMON_ERR_OK;
+}
+
+/**
+ * @brief Map the start of UIO map 0 up to the channel's data-in register
+ * @param ch Channel with an open UIO fd
+ * 
+ * Failure is not fatal, the channel then keeps reading through gpiod.
+ */
+static void map_uio_regs(GpioIntChannel *ch)
+{
+    long page = sysconf(_SC_PAGESIZE);
+    size_t end = GPIO_INT_DATAIN_OFFSET(&ch->pin_cfg) + sizeof(uint32_t);
+    size_t len = (end + (size_t)page - 1) & ~((size_t)page - 1);
+    
+    /* UIO selects map N through an mmap offset of N pages */
+    void *regs = mmap(NULL, len, PROT_READ, MAP_SHARED, ch->fd, 0);
+    if (regs == MAP_FAILED) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "Failed to map registers of /dev/uio%u, reading %s through gpiod\n",
+                         ch->pin_cfg.uio_index, ch->pin_cfg.consumer);
+        return;
+    }
+    
+    ch->regs = regs;
+    ch->regs_len = len;
+}
+
+/**
+ * @brief Open the UIO device of a channel (hardware backend)
+ * @param ctx Context pointer
+ * @param channel Channel index
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ */
+static uint8_t hw_init_irq(GpioIntCtx *ctx, uint16_t channel)
+{
+    GpioIntChannel *ch = &ctx->ch[channel];
+    
+    uint8_t ret = init_uio_device(&ch->pin_cfg, &ch->fd);
+    if (ret == DIS_COMMON_ERR_OK && ch->pin_cfg.datain_mmio) {
+        map_uio_regs(ch);
+    }
+    
+    return ret;
+}
+
+/**
+ * @brief Set pinmux and request the GPIO line of a channel (hardware backend)
+ * @param ctx Context pointer
+ * @param channel Channel index
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ */
+static uint8_t hw_init_line(GpioIntCtx *ctx, uint16_t channel)
+{
+    const GpioIntPinCfg *cfg = &ctx->ch[channel].pin_cfg;
+    HwLineGroup *group = hw_channel_group(channel);
+    
+    /* Already muxed and requested by hw_init_lines() */
+    if (group) {
+        ctx->ch[channel].line = hw_group_line(group, channel);
+        return DIS_COMMON_ERR_OK;
+    }
+    
+    /* Set GPIO pinmux */
+    gpio_setPinmux(cfg->group_id, cfg->group_bit, 1);
+    
+    return init_gpio_line(cfg, &ctx->ch[channel].line);
+}
+
+/**
+ * @brief Release the GPIO line and UIO device of a channel (hardware backend)
+ * @param ctx Context pointer
+ * @param channel Channel index
+ */
+static void hw_release(GpioIntCtx *ctx, uint16_t channel)
+{
+    GpioIntChannel *ch = &ctx->ch[channel];
+    HwLineGroup *group = hw_channel_group(channel);
+    
+    /* A group member owns its bulk-requested line even if it never got handed out */
+    if (group) {
+        ch->line = hw_group_line(group, channel);
+    }
+    
+    if (ch->line) {
+        gpiod_line_release(ch->line);
+        hw_chip_put(ch->pin_cfg.group_id);
+        ch->line = NULL;
+    }
+    
+    /* A released member breaks the group, a restart requests the line on its own */
+    if (group) {
+        g_hw_channel_group[channel] = HW_NO_GROUP;
+        group->intact = false;
+        group->live--;
+        if (--g_hw_group_live == 0) {
+            hw_free_line_groups();
+        }
+    }
+    
+    if (ch->regs) {
+        munmap(ch->regs, ch->regs_len);
+        ch->regs = NULL;
+        ch->regs_len = 0;
+    }
+    ch->datain = NULL;
+    
+    if (ch->fd >= 0) {
+        close(ch->fd);
+        ch->fd = -1;
+    }
+}
+
+/**
+ * @brief Read the UIO interrupt count, clearing the interrupt (hardware backend)
+ * @param ctx Context pointer
+ * @param channel Channel index
+ * @param icount Output: UIO interrupt count
+ * @return int Bytes read, <= 0 on failure
+ */
+static int hw_read_irq(GpioIntCtx *ctx, uint16_t channel, uint32_t *icount)
+{
+    return (int)read(ctx->ch[channel].fd, icount, sizeof(*icount));
+}
+
+/**
+ * @brief Re-enable the UIO interrupt (hardware backend)
+ * @param ctx Context pointer
+ * @param channel Channel index
+ * @return int 0 on success, -1 on failure
+ */
+static int hw_enable_irq(GpioIntCtx *ctx, uint16_t channel)
+{
+    int irq_on = 1;
+    return (write(ctx->ch[channel].fd, &irq_on, sizeof(irq_on)) == sizeof(irq_on)) ? 0 : -1;
+}
+
+/**
+ * @brief Read the GPIO line value (hardware backend)
+ * @param ctx Context pointer
+ * @param channel Channel index
+ * @return int GPIO value, < 0 on failure
+ */
+static int hw_get_value(GpioIntCtx *ctx, uint16_t channel)
+{
+    return gpiod_line_get_value(ctx->ch[channel].line);
+}
+
+/**
+ * @brief Get the gpiod line event fd (hardware backend)
+ * @param ctx Context pointer
+ * @param channel Channel index
+ * @return int File descriptor, < 0 on failure
+ */
+static int hw_get_event_fd(GpioIntCtx *ctx, uint16_t channel)
+{
+    return gpiod_line_event_get_fd(ctx->ch[channel].line);
+}
+
+/**
+ * @brief Read pending gpiod edge events (hardware backend)
+ * @param ctx Context pointer
+ * @param channel Channel index
+ * @param events Output events (edge, gpio_value and timestamp_ns filled)
+ * @param max Maximum number of events
+ * @return int Number of events read, < 0 on failure
+ */
+static int hw_read_events(GpioIntCtx *ctx, uint16_t channel, GpioIntEvent *events, unsigned int max)
+{
+    struct gpiod_line_event line_events[GPIO_INT_EVENT_BATCH];
+    
+    if (max > GPIO_INT_EVENT_BATCH) {
+        max = GPIO_INT_EVENT_BATCH;
+    }
+    
+    int n = gpiod_line_event_read_multiple(ctx->ch[channel].line, line_events, max);
+    
+    /* Shift realtime stamps of older kernels onto CLOCK_MONOTONIC */
+    uint64_t offset_ns = 0;
+    if (n > 0 && g_hw_edge_ts_realtime) {
+        struct timespec real;
+        clock_gettime(CLOCK_REALTIME, &real);
+        offset_ns = (uint64_t)real.tv_sec * 1000000000ull + (uint64_t)real.tv_nsec - gpio_int_now_ns();
+    }
+    
+    for (int i = 0; i < n; i++) {
+        bool rising = (line_events[i].event_type == GPIOD_LINE_EVENT_RISING_EDGE);
+        
+        events[i].edge = rising ? GPIO_INT_EDGE_RISING : GPIO_INT_EDGE_FALLING;
+        events[i].gpio_value = rising ? 1 : 0;
+        events[i].timestamp_ns = (uint64_t)line_events[i].ts.tv_sec * 1000000000ull +
+                                 (uint64_t)line_events[i].ts.tv_nsec - offset_ns;
+    }
+    
+    return n;
+}
+
+/**
+ * @brief Sample every intact line group with one ioctl each (hardware backend)
+ * @param ctx Context pointer
+ * @param values Values indexed by channel, entries of sampled lines are set
+ */
+static void hw_read_all(GpioIntCtx *ctx, int *values)
+{
+    int bulk_values[GPIOD_LINE_BULK_MAX_LINES];
+    (void)ctx;
+    
+    for (uint16_t g = 0; g < g_hw_group_cnt; g++) {
+        HwLineGroup *group = &g_hw_group[g];
+        
+        if (!group->intact || gpiod_line_get_value_bulk(&group->bulk, bulk_values) != 0) {
+            continue;
+        }
+        
+        for (unsigned int k = 0; k < group->bulk.num_lines; k++) {
+            values[group->channel[k]] = bulk_values[k];
+        }
+    }
+}
+
+const GpioIntBackendOps g_gpio_int_hw_backend = {
+    .name         = "hw",
+    .init_irq     = hw_init_irq,
+    .init_line    = hw_init_line,
+    .release      = hw_release,
+    .read_irq     = hw_read_irq,
+    .enable_irq   = hw_enable_irq,
+    .get_value    = hw_get_value,
+    .get_event_fd = hw_get_event_fd,
+    .read_events  = hw_read_events,
+    .init_lines   = hw_init_lines,
+    .read_all     = hw_read_all,
+    .raw_uio_fd   = 1,
+};
+
+/* ========== Channel Setup ========== */
+
+/**
+ * @brief Initialize a single GPIO interrupt channel
+ * @param ctx Context pointer
+ * @param channel_idx Channel index
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * Must be called with g_gpio_line_lock held for writing.
+ */
+static uint8_t init_single_channel(GpioIntCtx *ctx, uint16_t channel_idx)
+{
+    const GpioIntPinCfg *cfg = &ctx->ch[channel_idx].pin_cfg;
+    uint8_t ret;
+    
+    /* Initialize interrupt source, edge mode channels do not need one */
+    GpioIntChannel *ch = &ctx->ch[channel_idx];
+    ch->fd = -1;
+    ch->line = NULL;
+    ch->datain = NULL;
+    ch->regs = NULL;
+    ch->regs_len = 0;
+    if (cfg->mode != GPIO_INT_MODE_EDGE) {
+        ret = g_gpio_backend->init_irq(ctx, channel_idx);
+        if (ret != DIS_COMMON_ERR_OK) {
+            return ret;
+        }
+    }
+    
+    /* Read the value straight from the data-in register when it got mapped */
+    if (ch->regs && GPIO_INT_DATAIN_OFFSET(cfg) + sizeof(uint32_t) <= ch->regs_len) {
+        ch->datain = (volatile uint32_t *)((uint8_t *)ch->regs + GPIO_INT_DATAIN_OFFSET(cfg));
+    }
+    
+    /* Initialize GPIO line */
+    ret = g_gpio_backend->init_line(ctx, channel_idx);
+    if (ret != DIS_COMMON_ERR_OK) {
+        g_gpio_backend->release(ctx, channel_idx);
+        return ret;
+    }
+    
+    return DIS_COMMON_ERR_OK;
+}
+
+/**
+ * @brief Release the GPIO line and interrupt source of a channel
+ * @param ctx Context pointer
+ * @param channel_idx Channel index
+ */
+static void release_single_channel(GpioIntCtx *ctx, uint16_t channel_idx)
+{
+    pthread_rwlock_wrlock(&g_gpio_line_lock);
+    g_gpio_backend->release(ctx, channel_idx);
+    pthread_rwlock_unlock(&g_gpio_line_lock);
+}
+
+/**
+ * @brief Wait for interrupt events, spinning first when busy-poll is enabled
+ * @param shard Monitor shard
+ * @return int Number of events in shard->events, < 0 on failure
+ * 
+ * With busy_poll_us set, the interrupt fds are polled without sleeping for
+ * that window after every pass, which removes the scheduler wakeup from the
+ * latency of back-to-back interrupts at the cost of a busy CPU.
+ */
+static int monitor_wait(MonitorShard *shard)
+{
+    uint32_t window_us = g_gpio_rt_cfg.busy_poll_us;
+    
+    if (window_us > 0) {
+        uint64_t deadline_ns = gpio_int_now_ns() + (uint64_t)window_us * 1000ull;
+        
+        do {
+            int n = epoll_wait(shard->epoll_fd, shard->events, shard->event_cap, 0);
+            if (n != 0) {
+                return n;
+            }
+        } while (gpio_int_now_ns() < deadline_ns);
+    }
+    
+    return epoll_wait(shard->epoll_fd, shard->events, shard->event_cap, -1);
+}
+
+/**
+ * @brief Check whether an epoll or ring tag belongs to a critical channel
+ * @param tag Channel number, optionally with FILTER_TIMER_TAG, STORM_TIMER_TAG or
+ *            COUNTER_TIMER_TAG, RULE_TIMER_TAG with a rule index, or MONITOR_WAKE_TAG
+ * @return bool true for the interrupt source and filter timer of a critical channel
+ */
+static inline bool monitor_tag_is_critical(uint32_t tag)
+{
+    return tag != MONITOR_WAKE_TAG && !(tag & RULE_TIMER_TAG) &&
+           g_gpio_system_ctx.ch[(uint16_t)tag].priority == GPIO_INT_PRIO_CRITICAL;
+}
+
+/**
+ * @brief Handle one epoll event
+ * @param shard Monitor shard
+ * @param tag epoll data of the event
+ * @param now_ns CLOCK_MONOTONIC time of the wakeup
+ */
+static void monitor_handle_event(MonitorShard *shard, uint32_t tag, uint64_t now_ns)
+{
+    uint32_t icount;
+    
+    if (tag == MONITOR_WAKE_TAG) {
+        uint64_t kicks;
+        if (read(shard->wake_fd, &kicks, sizeof(kicks)) != sizeof(kicks)) {
+            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to drain GPIO monitor wake eventfd\n");
+        }
+        return;
+    }
+    
+    if (tag & FILTER_TIMER_TAG) {
+        filter_timer_expired((uint16_t)tag, &g_gpio_system_ctx, shard);
+        return;
+    }
+    
+    if (tag & STORM_TIMER_TAG) {
+        storm_timer_expired((uint16_t)tag, shard, now_ns);
+        return;
+    }
+    
+    if (tag & RULE_TIMER_TAG) {
+        rule_timer_expired((uint8_t)tag, now_ns);
+        return;
+    }
+    
+    if (tag & COUNTER_TIMER_TAG) {
+        counter_timer_expired((uint16_t)tag, now_ns);
+        return;
+    }
+    
+    uint16_t channel = (uint16_t)tag;
+    
+    /* Edge mode channels deliver timestamped events through gpiod */
+    if (g_gpio_system_ctx.ch[channel].pin_cfg.mode == GPIO_INT_MODE_EDGE) {
+        gpio_edge_event_handler(channel, &g_gpio_system_ctx, shard);
+        return;
+    }
+    
+    /* Read interrupt count to clear the interrupt */
+    if (g_gpio_backend->read_irq(&g_gpio_system_ctx, channel, &icount) > 0) {
+        /* Call interrupt handler */
+        gpio_interrupt_handler(channel, &g_gpio_system_ctx, shard, icount, now_ns);
+        
+        /* Re-enable interrupt, during a storm the poll timer does */
+        if (!storm_uio_wakeup(shard, channel, icount, now_ns) &&
+            g_gpio_backend->enable_irq(&g_gpio_system_ctx, channel) != 0) {
+            atomic_fetch_add_explicit(&g_channel_stats[channel].reenable_failures, 1,
+                                      memory_order_relaxed);
+            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to re-enable IRQ for channel %u\n", channel);
+        }
+    }
+}
+
+/**
+ * @brief Handle the epoll events of one monitor pass, critical channels first
+ * @param shard Monitor shard
+ * @param n Number of events in shard->events
+ * @param now_ns CLOCK_MONOTONIC time of the wakeup
+ */
+static void monitor_handle_events(MonitorShard *shard, int n, uint64_t now_ns)
+{
+    struct epoll_event *events = shard->events;
+    
+    /* epoll reports in readiness order, pull the critical channels forward */
+    if (atomic_load_explicit(&shard->critical_cnt, memory_order_relaxed) > 0) {
+        for (int i = 0; i < n; i++) {
+            if (monitor_tag_is_critical(events[i].data.u32)) {
+                monitor_handle_event(shard, events[i].data.u32, now_ns);
+                events[i].events = 0;
+            }
+        }
+    }
+    
+    for (int i = 0; i < n; i++) {
+        if (events[i].events != 0) {
+            monitor_handle_event(shard, events[i].data.u32, now_ns);
+        }
+    }
+}
+
+/**
+ * @brief Finish a monitor pass: deliver batches and release pass waiters
+ * @param shard Monitor shard
+ */
+static void monitor_pass_done(MonitorShard *shard)
+{
+    /* Deliver everything collected from this wakeup at once */
+    batch_flush(shard);
+    
+    if (shard->bus_pending) {
+        GpioIntBusHeader *bus = atomic_load_explicit(&g_gpio_bus, memory_order_acquire);
+        if (bus) {
+            bus_wake(bus);
+        }
+        shard->bus_pending = false;
+    }
+    
+    /* Events of this pass are done, release anyone removing a channel */
+    atomic_fetch_add(&shard->pass, 1);
+    if (atomic_load(&g_gpio_monitor_pass_waiters) > 0) {
+        pthread_mutex_lock(&g_gpio_monitor_pass_mutex);
+        pthread_cond_broadcast(&g_gpio_monitor_pass_cond);
+        pthread_mutex_unlock(&g_gpio_monitor_pass_mutex);
+    }
+}
+
+/**
+ * @brief GPIO interrupt monitoring thread function
+ * @param arg Monitor shard
+ * @return void* Thread return value
+ */
+static void* gpio_interrupt_monitor_thread(void *arg)
+{
+    MonitorShard *shard = arg;
+    
+    prefault_thread_stack();
+    
+    while (g_gpio_monitor_running) {
+        /* Wait for interrupt events */
+        int n = monitor_wait(shard);
+        
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (g_gpio_monitor_running) {
+                DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "epoll_wait failed in GPIO monitor shard %u\n", shard->index);
+            }
+            break;
+        }
+        
+        /* Process interrupt events */
+        monitor_handle_events(shard, n, gpio_int_now_ns());
+        monitor_pass_done(shard);
+    }
+    
+    DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 2, "GPIO interrupt monitor shard %u stopped\n", shard->index);
+    return NULL;
+}
+
+/* ========== io_uring Monitor Loop ========== */
+
+#ifdef GPIO_INT_USE_IO_URING
+
+/* user_data of a ring request: operation in the upper word, channel in the lower */
+#define URING_OP_READ       0u
+#define URING_OP_ENABLE     1u
+#define URING_OP_CANCEL     2u
+#define URING_USER_DATA(op, channel) (((uint64_t)(op) << 32) | (channel))
+
+/* user_data of the poll on the shard's epoll set */
+#define URING_EPOLL_TAG     UINT64_MAX
+
+/* Written to a UIO fd to re-enable its interrupt */
+static const int g_uring_irq_on = 1;
+
+/**
+ * @brief Get a submission slot, flushing the queue once if it is full
+ * @param shard Monitor shard
+ * @return struct io_uring_sqe* Slot, NULL if the queue stays full
+ */
+static struct io_uring_sqe *uring_get_sqe(MonitorShard *shard)
+{
+    struct io_uring_sqe *sqe = io_uring_get_sqe(&shard->ring);
+    
+    if (!sqe) {
+        io_uring_submit(&shard->ring);
+        sqe = io_uring_get_sqe(&shard->ring);
+    }
+    
+    return sqe;
+}
+
+/**
+ * @brief Post a read of the UIO interrupt count of a channel
+ * @param shard Monitor shard
+ * @param channel GPIO interrupt channel number
+ */
+static void uring_post_read(MonitorShard *shard, uint16_t channel)
+{
+    UringChannel *uch = &shard->uring_ch[channel];
+    struct io_uring_sqe *sqe = uring_get_sqe(shard);
+    
+    /* Left disarmed, the next uring_sync_channels() retries */
+    if (!sqe) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "io_uring full, cannot post read for channel %u\n", channel);
+        return;
+    }
+    
+    io_uring_prep_read(sqe, g_gpio_system_ctx.ch[channel].fd, &uch->icount, sizeof(uch->icount), 0);
+    io_uring_sqe_set_data64(sqe, URING_USER_DATA(URING_OP_READ, channel));
+    uch->armed = true;
+    atomic_fetch_add(&uch->inflight, 1);
+}
+
+/**
+ * @brief Queue the write that re-enables the UIO interrupt of a channel
+ * @param shard Monitor shard
+ * @param channel GPIO interrupt channel number
+ */
+static void uring_post_enable(MonitorShard *shard, uint16_t channel)
+{
+    struct io_uring_sqe *sqe = uring_get_sqe(shard);
+    
+    if (!sqe) {
+        atomic_fetch_add_explicit(&g_channel_stats[channel].reenable_failures, 1, memory_order_relaxed);
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "io_uring full, cannot re-enable IRQ for channel %u\n", channel);
+        return;
+    }
+    
+    io_uring_prep_write(sqe, g_gpio_system_ctx.ch[channel].fd, &g_uring_irq_on, sizeof(g_uring_irq_on), 0);
+    io_uring_sqe_set_data64(sqe, URING_USER_DATA(URING_OP_ENABLE, channel));
+    atomic_fetch_add(&shard->uring_ch[channel].inflight, 1);
+}
+
+/**
+ * @brief Cancel the posted read of a channel being removed
+ * @param shard Monitor shard
+ * @param channel GPIO interrupt channel number
+ */
+static void uring_post_cancel(MonitorShard *shard, uint16_t channel)
+{
+    struct io_uring_sqe *sqe = uring_get_sqe(shard);
+    
+    if (!sqe) {
+        return;
+    }
+    
+    io_uring_prep_cancel64(sqe, URING_USER_DATA(URING_OP_READ, channel), 0);
+    io_uring_sqe_set_data64(sqe, URING_USER_DATA(URING_OP_CANCEL, channel));
+    shard->uring_ch[channel].cancel_sent = true;
+}
+
+/**
+ * @brief Post a one-shot poll on the shard's epoll set
+ * @param shard Monitor shard
+ */
+static void uring_post_epoll_poll(MonitorShard *shard)
+{
+    struct io_uring_sqe *sqe = uring_get_sqe(shard);
+    
+    if (!sqe) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "io_uring full, cannot poll epoll set of shard %u\n", shard->index);
+        return;
+    }
+    
+    io_uring_prep_poll_add(sqe, shard->epoll_fd, POLLIN);
+    io_uring_sqe_set_data64(sqe, URING_EPOLL_TAG);
+}
+
+/**
+ * @brief Arm reads of added or disarmed channels and cancel reads of removed ones
+ * @param shard Monitor shard
+ * 
+ * Only scans the shard's channels and queues requests, the submit happens
+ * with the next wait.
+ */
+static void uring_sync_channels(MonitorShard *shard)
+{
+    for (uint16_t i = 0; i < shard->uring_ch_cnt; i++) {
+        UringChannel *uch = &shard->uring_ch[i];
+        bool want = atomic_load(&uch->want);
+        
+        if (want && !uch->armed) {
+            uring_post_read(shard, i);
+        } else if (!want && uch->armed && !uch->cancel_sent) {
+            uring_post_cancel(shard, i);
+        }
+    }
+}
+
+/**
+ * @brief Handle one ring completion
+ * @param shard Monitor shard
+ * @param user_data Request tag
+ * @param res Request result
+ * @param now_ns CLOCK_MONOTONIC time of the wakeup
+ * 
+ * A completed read queues the re-enable write and the next read before the
+ * handler runs, so both go out with the submit that ends this pass.
+ */
+static void uring_complete(MonitorShard *shard, uint64_t user_data, int res, uint64_t now_ns)
+{
+    uint16_t channel = (uint16_t)user_data;
+    uint32_t op = (uint32_t)(user_data >> 32);
+    UringChannel *uch = &shard->uring_ch[channel];
+    
+    if (op == URING_OP_CANCEL) {
+        return;
+    }
+    
+    atomic_fetch_sub(&uch->inflight, 1);
+    
+    if (op == URING_OP_ENABLE) {
+        if (res != (int)sizeof(g_uring_irq_on)) {
+            atomic_fetch_add_explicit(&g_channel_stats[channel].reenable_failures, 1, memory_order_relaxed);
+            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to re-enable IRQ for channel %u\n", channel);
+        }
+        return;
+    }
+    
+    uch->armed = false;
+    uch->cancel_sent = false;
+    if (!atomic_load(&uch->want)) {
+        return;
+    }
+    
+    /* Failed reads are re-posted by the next uring_sync_channels() */
+    if (res != (int)sizeof(uch->icount)) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "UIO read failed for channel %u (%d)\n", channel, res);
+        return;
+    }
+    
+    uint32_t icount = uch->icount;
+    if (!storm_uio_wakeup(shard, channel, icount, now_ns)) {
+        uring_post_enable(shard, channel);
+    }
+    uring_post_read(shard, channel);
+    gpio_interrupt_handler(channel, &g_gpio_system_ctx, shard, icount, now_ns);
+}
+
+/**
+ * @brief Check whether a completion is an interrupt of a critical channel
+ * @param cqe Completion
+ * @return bool true for a read completion of a critical channel
+ */
+static inline bool uring_cqe_is_critical(const struct io_uring_cqe *cqe)
+{
+    uint64_t user_data = io_uring_cqe_get_data64(cqe);
+    
+    return user_data != URING_EPOLL_TAG && (uint32_t)(user_data >> 32) == URING_OP_READ &&
+           g_gpio_system_ctx.ch[(uint16_t)user_data].priority == GPIO_INT_PRIO_CRITICAL;
+}
+
+/**
+ * @brief Submit queued requests and wait for completions, spinning first when busy-poll is enabled
+ * @param shard Monitor shard
+ * @return int >= 0 on success, negative errno on failure
+ */
+static int uring_wait(MonitorShard *shard)
+{
+    uint32_t window_us = g_gpio_rt_cfg.busy_poll_us;
+    
+    if (window_us > 0) {
+        int ret = io_uring_submit(&shard->ring);
+        if (ret < 0) {
+            return ret;
+        }
+        
+        uint64_t deadline_ns = gpio_int_now_ns() + (uint64_t)window_us * 1000ull;
+        do {
+            if (io_uring_cq_ready(&shard->ring) > 0) {
+                return 0;
+            }
+        } while (gpio_int_now_ns() < deadline_ns);
+    }
+    
+    return io_uring_submit_and_wait(&shard->ring, 1);
+}
+
+/**
+ * @brief io_uring monitoring thread function
+ * @param arg Monitor shard
+ * @return void* Thread return value
+ * 
+ * Each pass costs one io_uring_enter() that submits all re-enable writes and
+ * re-posted reads of the previous pass and waits for the next completions,
+ * instead of an epoll_wait() plus a read() and write() per interrupt.
+ */
+static void* gpio_uring_monitor_thread(void *arg)
+{
+    MonitorShard *shard = arg;
+    struct io_uring_cqe **cqes = shard->cqes;
+    
+    prefault_thread_stack();
+    
+    uring_post_epoll_poll(shard);
+    uring_sync_channels(shard);
+    
+    while (g_gpio_monitor_running) {
+        int ret = uring_wait(shard);
+        
+        if (ret < 0) {
+            if (ret == -EINTR) {
+                continue;
+            }
+            if (g_gpio_monitor_running) {
+                DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "io_uring wait failed in GPIO monitor shard %u (%s)\n",
+                                 shard->index, strerror(-ret));
+            }
+            break;
+        }
+        
+        uint64_t now_ns = gpio_int_now_ns();
+        bool epoll_ready = false;
+        
+        /* Take a fixed set, completions of requests submitted below wait for the next pass */
+        unsigned int n = io_uring_peek_batch_cqe(&shard->ring, cqes, shard->cqe_cap);
+        
+        /* Critical interrupts first, then the epoll set, then everything else */
+        bool critical = atomic_load_explicit(&shard->critical_cnt, memory_order_relaxed) > 0;
+        for (unsigned int i = 0; critical && i < n; i++) {
+            if (uring_cqe_is_critical(cqes[i])) {
+                uring_complete(shard, io_uring_cqe_get_data64(cqes[i]), cqes[i]->res, now_ns);
+            }
+        }
+        
+        for (unsigned int i = 0; i < n; i++) {
+            if (io_uring_cqe_get_data64(cqes[i]) == URING_EPOLL_TAG) {
+                epoll_ready = true;
+            }
+        }
+        
+        /* Edge channels, filter timers and wake kicks, which may add or remove channels */
+        if (epoll_ready) {
+            int cnt = epoll_wait(shard->epoll_fd, shard->events, shard->event_cap, 0);
+            if (cnt > 0) {
+                monitor_handle_events(shard, cnt, now_ns);
+            }
+        }
+        
+        for (unsigned int i = 0; i < n; i++) {
+            uint64_t user_data = io_uring_cqe_get_data64(cqes[i]);
+            
+            if (user_data != URING_EPOLL_TAG && !(critical && uring_cqe_is_critical(cqes[i]))) {
+                uring_complete(shard, user_data, cqes[i]->res, now_ns);
+            }
+        }
+        io_uring_cq_advance(&shard->ring, n);
+        
+        /* Every pass, so a read that failed or found the ring full is re-posted
+         * even while the epoll set stays quiet */
+        uring_sync_channels(shard);
+        if (epoll_ready) {
+            uring_post_epoll_poll(shard);
+        }
+        
+        monitor_pass_done(shard);
+    }
+    
+    DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 2, "GPIO interrupt monitor shard %u stopped\n", shard->index);
+    return NULL;
+}
+
+/**
+ * @brief Set up the ring of a shard
+ * @param shard Monitor shard
+ * @return bool true if the shard runs the io_uring loop
+ */
+static bool uring_init_shard(MonitorShard *shard)
+{
+    uint16_t cnt = g_gpio_system_ctx.int_cnt;
+    
+    /* A read, a re-enable write and a cancel per channel, plus the epoll poll */
+    unsigned int entries = 3u * cnt + 1u;
+    
+    shard->uring_ch = calloc(cnt, sizeof(*shard->uring_ch));
+    shard->cqes = calloc(entries, sizeof(*shard->cqes));
+    if (!shard->uring_ch || !shard->cqes) {
+        free(shard->uring_ch);
+        free(shard->cqes);
+        shard->uring_ch = NULL;
+        shard->cqes = NULL;
+        return false;
+    }
+    
+    int ret = io_uring_queue_init(entries, &shard->ring, 0);
+    if (ret < 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "io_uring unavailable (%s), monitor shard %u uses epoll\n",
+                         strerror(-ret), shard->index);
+        free(shard->uring_ch);
+        free(shard->cqes);
+        shard->uring_ch = NULL;
+        shard->cqes = NULL;
+        return false;
+    }
+    
+    shard->uring_ch_cnt = cnt;
+    shard->cqe_cap = entries;
+    return true;
+}
+
+/**
+ * @brief Tear down the ring of a shard, cancelling everything still posted
+ * @param shard Monitor shard
+ */
+static void uring_close_shard(MonitorShard *shard)
+{
+    if (shard->use_uring) {
+        io_uring_queue_exit(&shard->ring);
+    }
+    free(shard->uring_ch);
+    free(shard->cqes);
+    shard->uring_ch = NULL;
+    shard->cqes = NULL;
+}
+
+/**
+ * @brief Hand a UIO channel to the ring of its shard
+ * @param shard Monitor shard
+ * @param channel GPIO interrupt channel number (initialized, IRQ enabled)
+ */
+static void uring_add_channel(MonitorShard *shard, uint16_t channel)
+{
+    uint64_t one = 1;
+    
+    atomic_store(&shard->uring_ch[channel].want, true);
+    
+    /* A running monitor posts the read on its next pass, a starting one on entry */
+    if (shard->started && write(shard->wake_fd, &one, sizeof(one)) != sizeof(one)) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to wake GPIO monitor shard %u\n", shard->index);
+    }
+}
+
+/**
+ * @brief Take a UIO channel off the ring of its shard
+ * @param shard Monitor shard
+ * @param channel GPIO interrupt channel number
+ * 
+ * Returns once the posted read and any re-enable write have completed, so
+ * the channel's fd can be closed.
+ */
+static void uring_remove_channel(MonitorShard *shard, uint16_t channel)
+{
+    UringChannel *uch = &shard->uring_ch[channel];
+    
+    atomic_store(&uch->want, false);
+    while (atomic_load(&uch->inflight) > 0 && g_gpio_monitor_running && shard->started) {
+        wait_monitor_pass(shard);
+    }
+}
+
+#else /* !GPIO_INT_USE_IO_URING */
+
+static void* gpio_uring_monitor_thread(void *arg)
+{
+    return gpio_interrupt_monitor_thread(arg);
+}
+
+static bool uring_init_shard(MonitorShard *shard)
+{
+    DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "Built without GPIO_INT_USE_IO_URING, monitor shard %u uses epoll\n",
+                     shard->index);
+    return false;
+}
+
+static void uring_close_shard(MonitorShard *shard)
+{
+    (void)shard;
+}
+
+static void uring_add_channel(MonitorShard *shard, uint16_t channel)
+{
+    (void)shard;
+    (void)channel;
+}
+
+static void uring_remove_channel(MonitorShard *shard, uint16_t channel)
+{
+    (void)shard;
+    (void)channel;
+}
+
+static void uring_post_enable(MonitorShard *shard, uint16_t channel)
+{
+    (void)shard;
+    (void)channel;
+}
+
+#endif /* GPIO_INT_USE_IO_URING */
+
+/* ========== Public API Functions ========== */
+
+void gpio_int_debug_init(uint8_t enable)
+{
+    setModuleTraceEn(GPIOINTSERVICE, enable);
+}
+
+uint8_t gpio_int_ctx_alloc(GpioIntCtx *ctx, uint16_t int_cnt)
+{
+    if (!ctx || int_cnt == 0 || int_cnt > GPIO_INT_MAX_CHANNELS) {
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
+    
+    ctx->ch = calloc(int_cnt, sizeof(*ctx->ch));
+    ctx->enable_mask = calloc(GPIO_INT_MASK_WORDS(int_cnt), sizeof(*ctx->enable_mask));
+    if (!ctx->ch || !ctx->enable_mask) {
+        gpio_int_ctx_free(ctx);
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    for (uint16_t i = 0; i < int_cnt; i++) {
+        ctx->ch[i].fd = -1;
+    }
+    memset(ctx->rule, 0, sizeof(ctx->rule));
+    
+    ctx->int_cnt = int_cnt;
+    return DIS_COMMON_ERR_OK;
+}
+
+void gpio_int_ctx_free(GpioIntCtx *ctx)
+{
+    if (!ctx) {
+        return;
+    }
+    
+    free(ctx->ch);
+    free(ctx->enable_mask);
+    ctx->ch = NULL;
+    ctx->enable_mask = NULL;
+    ctx->int_cnt = 0;
+    memset(ctx->rule, 0, sizeof(ctx->rule));
+}
+
+void gpio_int_ctx_set_enabled(GpioIntCtx *ctx, uint16_t channel, uint8_t enable)
+{
+    if (!ctx || channel >= ctx->int_cnt) {
+        return;
+    }
+    
+    if (enable) {
+        ctx->enable_mask[channel / 64u] |= 1ull << (channel % 64u);
+    } else {
+        ctx->enable_mask[channel / 64u] &= ~(1ull << (channel % 64u));
+    }
+}
+
+uint8_t gpio_int_ctx_is_enabled(const GpioIntCtx *ctx, uint16_t channel)
+{
+    if (!ctx || !ctx->enable_mask || channel >= ctx->int_cnt) {
+        return 0;
+    }
+    
+    return (ctx->enable_mask[channel / 64u] >> (channel % 64u)) & 1u;
+}
+
+/**
+ * @brief Deep-copy a context configuration
+ * @param dst Destination context (must not own a table)
+ * @param src Source context
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ */
+static uint8_t gpio_int_ctx_copy(GpioIntCtx *dst, const GpioIntCtx *src)
+{
+    uint8_t ret = gpio_int_ctx_alloc(dst, src->int_cnt);
+    if (ret != DIS_COMMON_ERR_OK) {
+        return ret;
+    }
+    
+    memcpy(dst->ch, src->ch, src->int_cnt * sizeof(*src->ch));
+    memcpy(dst->enable_mask, src->enable_mask, GPIO_INT_MASK_WORDS(src->int_cnt) * sizeof(*src->enable_mask));
+    memcpy(dst->rule, src->rule, sizeof(dst->rule));
+    return DIS_COMMON_ERR_OK;
+}
+
+/**
+ * @brief Load the optional /GPIOINT/ruleN/ composite rule keys
+ * @param ctx Context pointer, channel table already allocated
+ * @param db_region Database region
+ * 
+ * terms holds term_cnt (channel, level) byte pairs, window_us and hold_ms
+ * are big-endian. A rule that does not fit the channel table is dropped.
+ */
+static void gpio_int_rules_from_db(GpioIntCtx *ctx, uint32_t db_region)
+{
+    char path[64];
+    uint8_t rule_cnt;
+    uint8_t value;
+    uint8_t reg[2];
+    uint8_t terms[2 * GPIO_INT_RULE_MAX_TERMS];
+    
+    if (dis_dfe8219_dataBaseGetU8(DFE8219, db_region, "/GPIOINT/RuleCount", &rule_cnt, 1) != NO_ERROR) {
+        return;
+    }
+    
+    for (uint8_t r = 0; r < rule_cnt && r < GPIO_INT_MAX_RULES; r++) {
+        GpioIntRuleCfg *cfg = &ctx->rule[r];
+        
+        snprintf(path, sizeof(path), "/GPIOINT/rule%u/op", r);
+        if (dis_dfe8219_dataBaseGetU8(DFE8219, db_region, path, &value, 1) != NO_ERROR) {
+            continue;
+        }
+        cfg->op = value;
+        
+        snprintf(path, sizeof(path), "/GPIOINT/rule%u/term_cnt", r);
+        if (dis_dfe8219_dataBaseGetU8(DFE8219, db_region, path, &value, 1) != NO_ERROR ||
+            value == 0 || value > GPIO_INT_RULE_MAX_TERMS) {
+            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Invalid term count of rule %u, rule disabled\n", r);
+            memset(cfg, 0, sizeof(*cfg));
+            continue;
+        }
+        
+        snprintf(path, sizeof(path), "/GPIOINT/rule%u/terms", r);
+        if (dis_dfe8219_dataBaseGetU8(DFE8219, db_region, path, terms, 2u * value) != NO_ERROR) {
+            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Missing terms of rule %u, rule disabled\n", r);
+            memset(cfg, 0, sizeof(*cfg));
+            continue;
+        }
+        cfg->term_cnt = value;
+        for (uint8_t i = 0; i < cfg->term_cnt; i++) {
+            cfg->term[i].channel = terms[2 * i];
+            cfg->term[i].level = terms[2 * i + 1];
+        }
+        
+        snprintf(path, sizeof(path), "/GPIOINT/rule%u/window_us", r);
+        if (dis_dfe8219_dataBaseGetU8(DFE8219, db_region, path, reg, 2) == NO_ERROR) {
+            cfg->window_us = (uint32_t)((reg[0] << 8) | reg[1]);
+        }
+        snprintf(path, sizeof(path), "/GPIOINT/rule%u/hold_ms", r);
+        if (dis_dfe8219_dataBaseGetU8(DFE8219, db_region, path, reg, 2) == NO_ERROR) {
+            cfg->hold_us = (uint32_t)((reg[0] << 8) | reg[1]) * 1000u;
+        }
+        
+        if (!rule_cfg_valid(cfg, ctx->int_cnt)) {
+            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Invalid configuration of rule %u, rule disabled\n", r);
+            memset(cfg, 0, sizeof(*cfg));
+        }
+    }
+}
+
+uint8_t gpio_int_ctx_from_db(GpioIntCtx *ctx, uint32_t db_region)
+{
+    if (!ctx) {
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
+    
+    /* Initialize database */
+    uint32_t ret = dis_dfe8219_dataBaseInitWithRegion(DFE8219, db_region);
+    if (ret != NO_ERROR) {
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    /* Read interrupt count */
+    char path[64];
+    uint8_t int_cnt;
+    uint8_t value;
+    uint8_t reg[2];
+    snprintf(path, sizeof(path), "/GPIOINT/IntCount");
+    ret = dis_dfe8219_dataBaseGetU8(DFE8219, db_region, path, &int_cnt, 1);
+    if (ret != NO_ERROR) {
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    if (gpio_int_ctx_alloc(ctx, int_cnt) != DIS_COMMON_ERR_OK) {
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
+    
+    /* Read enable list into the enable bitmap */
+    uint8_t *enable_list = malloc(int_cnt);
+    if (!enable_list) {
+        gpio_int_ctx_free(ctx);
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    snprintf(path, sizeof(path), "/GPIOINT/enable_list");
+    ret = dis_dfe8219_dataBaseGetU8(DFE8219, db_region, path, enable_list, int_cnt);
+    if (ret != NO_ERROR) {
+        free(enable_list);
+        gpio_int_ctx_free(ctx);
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    for (uint16_t i = 0; i < int_cnt; ++i) {
+        gpio_int_ctx_set_enabled(ctx, i, enable_list[i]);
+    }
+    free(enable_list);
+    
+    /* Read channel configurations */
+    FOR_EACH_ENABLED_CHANNEL(ctx, i) {
+        GpioIntChannel *ch = &ctx->ch[i];
+        
+        /* Read pin configuration */
+        snprintf(path, sizeof(path), "/GPIOINT/ch%d/pin_cfg", i);
+        ret = dis_dfe8219_dataBaseGetU8(DFE8219, db_region, path, (uint8_t*)&ch->pin_cfg, 3);
+        if (ret != NO_ERROR) {
+            gpio_int_ctx_free(ctx);
+            return DIS_COMMON_ERR_API_FAIL;
+        }
+        
+        /* Read consumer string */
+        snprintf(path, sizeof(path), "/GPIOINT/ch%d/consumer", i);
+        ret = dis_dfe8219_dataBaseGet(DFE8219, db_region, path, ch->pin_cfg.consumer);
+        if (ret != NO_ERROR) {
+            gpio_int_ctx_free(ctx);
+            return DIS_COMMON_ERR_API_FAIL;
+        }
+        
+        /* Read optional acquisition mode, default to UIO */
+        snprintf(path, sizeof(path), "/GPIOINT/ch%d/mode", i);
+        ret = dis_dfe8219_dataBaseGetU8(DFE8219, db_region, path, &ch->pin_cfg.mode, 1);
+        if (ret != NO_ERROR || ch->pin_cfg.mode > GPIO_INT_MODE_EDGE) {
+            ch->pin_cfg.mode = GPIO_INT_MODE_UIO;
+        }
+        
+        /* Read optional overflow policy, default to queueing every event */
+        snprintf(path, sizeof(path), "/GPIOINT/ch%d/overflow_policy", i);
+        ret = dis_dfe8219_dataBaseGetU8(DFE8219, db_region, path, &ch->overflow_policy, 1);
+        if (ret != NO_ERROR || ch->overflow_policy > GPIO_INT_OVERFLOW_MERGE) {
+            ch->overflow_policy = GPIO_INT_OVERFLOW_QUEUE;
+        }
+        
+        /* Read optional monitor shard, default to the first one */
+        snprintf(path, sizeof(path), "/GPIOINT/ch%d/shard", i);
+        ret = dis_dfe8219_dataBaseGetU8(DFE8219, db_region, path, &ch->shard, 1);
+        if (ret != NO_ERROR) {
+            ch->shard = 0;
+        }
+        
+        /* Read optional dispatch class, default to normal priority on the worker */
+        snprintf(path, sizeof(path), "/GPIOINT/ch%d/priority", i);
+        ret = dis_dfe8219_dataBaseGetU8(DFE8219, db_region, path, &ch->priority, 1);
+        if (ret != NO_ERROR || ch->priority > GPIO_INT_PRIO_CRITICAL) {
+            ch->priority = GPIO_INT_PRIO_NORMAL;
+        }
+        snprintf(path, sizeof(path), "/GPIOINT/ch%d/dispatch", i);
+        ret = dis_dfe8219_dataBaseGetU8(DFE8219, db_region, path, &ch->dispatch, 1);
+        if (ret != NO_ERROR || ch->dispatch > GPIO_INT_DISPATCH_INLINE) {
+            ch->dispatch = GPIO_INT_DISPATCH_WORKER;
+        }
+        
+        /* Read optional data-in register offset (big-endian), enables register reads */
+        snprintf(path, sizeof(path), "/GPIOINT/ch%d/datain_reg", i);
+        if (dis_dfe8219_dataBaseGetU8(DFE8219, db_region, path, reg, 2) == NO_ERROR) {
+            ch->pin_cfg.datain_reg = (uint16_t)((reg[0] << 8) | reg[1]);
+            ch->pin_cfg.datain_mmio = 1;
+        }
+        
+        /* Read optional glitch filter, default to passing every interrupt */
+        snprintf(path, sizeof(path), "/GPIOINT/ch%d/debounce_ms", i);
+        if (dis_dfe8219_dataBaseGetU8(DFE8219, db_region, path, &value, 1) == NO_ERROR) {
+            ch->filter.debounce_us = value * 1000u;
+        }
+        snprintf(path, sizeof(path), "/GPIOINT/ch%d/min_pulse_us", i);
+        if (dis_dfe8219_dataBaseGetU8(DFE8219, db_region, path, &value, 1) == NO_ERROR) {
+            ch->filter.min_pulse_us = value;
+        }
+        snprintf(path, sizeof(path), "/GPIOINT/ch%d/edge_filter", i);
+        if (dis_dfe8219_dataBaseGetU8(DFE8219, db_region, path, &value, 1) == NO_ERROR &&
+            value <= GPIO_INT_FILTER_FALLING) {
+            ch->filter.edge_filter = value;
+        }
+        
+        /* Read optional storm protection (rate big-endian), default to off */
+        snprintf(path, sizeof(path), "/GPIOINT/ch%d/storm_rate", i);
+        if (dis_dfe8219_dataBaseGetU8(DFE8219, db_region, path, reg, 2) == NO_ERROR) {
+            ch->storm.max_rate = (uint32_t)((reg[0] << 8) | reg[1]);
+        }
+        snprintf(path, sizeof(path), "/GPIOINT/ch%d/storm_window_ms", i);
+        if (dis_dfe8219_dataBaseGetU8(DFE8219, db_region, path, &value, 1) == NO_ERROR) {
+            ch->storm.window_us = value * 1000u;
+        }
+        snprintf(path, sizeof(path), "/GPIOINT/ch%d/storm_poll_ms", i);
+        if (dis_dfe8219_dataBaseGetU8(DFE8219, db_region, path, &value, 1) == NO_ERROR) {
+            ch->storm.poll_us = value * 1000u;
+        }
+        if (!storm_cfg_valid(&ch->storm)) {
+            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Storm poll rate of channel %d not below storm_rate, disabled\n", i);
+            memset(&ch->storm, 0, sizeof(ch->storm));
+        }
+        
+        /* Read optional counter mode window (big-endian), default to per-edge dispatch */
+        snprintf(path, sizeof(path), "/GPIOINT/ch%d/counter_window_ms", i);
+        if (dis_dfe8219_dataBaseGetU8(DFE8219, db_region, path, reg, 2) == NO_ERROR) {
+            ch->counter.window_us = (uint32_t)((reg[0] << 8) | reg[1]) * 1000u;
+        }
+    }
+    
+    gpio_int_rules_from_db(ctx, db_region);
+    return DIS_COMMON_ERR_OK;
+}
+
+/**
+ * @brief Load the optional /GPIOINT/rt/ real-time keys
+ * @param cfg Real-time configuration, fields without a key are left unchanged
+ * @param db_region Database region
+ */
+static void gpio_int_rt_cfg_from_db(GpioIntRtCfg *cfg, uint32_t db_region)
+{
+    uint8_t value;
+    
+    if (dis_dfe8219_dataBaseGetU8(DFE8219, db_region, "/GPIOINT/rt/policy", &value, 1) == NO_ERROR &&
+        value <= GPIO_INT_SCHED_RR) {
+        cfg->sched_policy = value;
+    }
+    if (dis_dfe8219_dataBaseGetU8(DFE8219, db_region, "/GPIOINT/rt/monitor_prio", &value, 1) == NO_ERROR) {
+        cfg->monitor_priority = value;
+    }
+    if (dis_dfe8219_dataBaseGetU8(DFE8219, db_region, "/GPIOINT/rt/worker_prio", &value, 1) == NO_ERROR) {
+        cfg->worker_priority = value;
+    }
+    if (dis_dfe8219_dataBaseGetU8(DFE8219, db_region, "/GPIOINT/rt/critical_prio", &value, 1) == NO_ERROR) {
+        cfg->critical_priority = value;
+    }
+    
+    /* CPU 255 leaves the thread unpinned */
+    if (dis_dfe8219_dataBaseGetU8(DFE8219, db_region, "/GPIOINT/rt/monitor_cpu", &value, 1) == NO_ERROR) {
+        cfg->monitor_cpu = (value == 0xFF) ? GPIO_INT_CPU_ANY : value;
+    }
+    if (dis_dfe8219_dataBaseGetU8(DFE8219, db_region, "/GPIOINT/rt/worker_cpu", &value, 1) == NO_ERROR) {
+        cfg->worker_cpu = (value == 0xFF) ? GPIO_INT_CPU_ANY : value;
+    }
+    
+    if (dis_dfe8219_dataBaseGetU8(DFE8219, db_region, "/GPIOINT/rt/mlock", &value, 1) == NO_ERROR) {
+        cfg->lock_memory = value ? 1 : 0;
+    }
+    if (dis_dfe8219_dataBaseGetU8(DFE8219, db_region, "/GPIOINT/rt/busy_poll_us", &value, 1) == NO_ERROR) {
+        cfg->busy_poll_us = value;
+    }
+    
+    if (dis_dfe8219_dataBaseGetU8(DFE8219, db_region, "/GPIOINT/rt/monitor_shards", &value, 1) == NO_ERROR &&
+        value <= GPIO_INT_MAX_MONITORS) {
+        cfg->monitor_shards = value;
+    }
+    if (dis_dfe8219_dataBaseGetU8(DFE8219, db_region, "/GPIOINT/rt/shard_by_group", &value, 1) == NO_ERROR) {
+        cfg->shard_by_group = value ? 1 : 0;
+    }
+    if (dis_dfe8219_dataBaseGetU8(DFE8219, db_region, "/GPIOINT/rt/monitor_loop", &value, 1) == NO_ERROR &&
+        value <= GPIO_INT_LOOP_IO_URING) {
+        cfg->monitor_loop = value;
+    }
+}
+
+uint8_t gpio_int_init(GpioIntCtx *ctx)
+{
+    if (!ctx || !ctx->ch || ctx->int_cnt == 0 || ctx->int_cnt > GPIO_INT_MAX_CHANNELS) {
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
+    
+    for (uint16_t i = 0; i < ctx->int_cnt; ++i) {
+        /* Mark as uninitialized */
+        ctx->ch[i].fd = -1;
+        ctx->ch[i].line = NULL;
+    }
+    
+    pthread_rwlock_wrlock(&g_gpio_line_lock);
+    
+    /* Let the backend request lines sharing a chip together */
+    uint8_t ret = g_gpio_backend->init_lines ? g_gpio_backend->init_lines(ctx) : DIS_COMMON_ERR_OK;
+    
+    FOR_EACH_ENABLED_CHANNEL(ctx, i) {
+        if (ret != DIS_COMMON_ERR_OK) {
+            break;
+        }
+        ret = init_single_channel(ctx, (uint16_t)i);
+    }
+    
+    pthread_rwlock_unlock(&g_gpio_line_lock);
+    return ret;
+}
+
+uint8_t gpio_int_enable_irq(GpioIntCtx *ctx, uint16_t idx)
+{
+    if (!ctx || idx >= ctx->int_cnt) {
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
+    
+    /* Check if channel is enabled */
+    if (!gpio_int_ctx_is_enabled(ctx, idx)) {
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
+    
+    /* Edge mode channels are armed by the gpiod event request */
+    if (ctx->ch[idx].pin_cfg.mode == GPIO_INT_MODE_EDGE) {
+        return DIS_COMMON_ERR_OK;
+    }
+    
+    /* Check if file descriptor is valid */
+    if (ctx->ch[idx].fd < 0) {
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    // /* Clear any pending interrupt */
+    // int count = 0;
+    // read(ctx->ch[idx].fd, &count, sizeof(count));
+    
+    /* Enable interrupt */
+    if (g_gpio_backend->enable_irq(ctx, idx) != 0) {
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    return DIS_COMMON_ERR_OK;
+}
+
+uint8_t gpio_int_deinit(GpioIntCtx *ctx)
+{
+    if (!ctx) {
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
+    
+    if (ctx->ch) {
+        FOR_EACH_ENABLED_CHANNEL(ctx, i) {
+            release_single_channel(ctx, (uint16_t)i);
+        }
+    }
+    
+    ctx->int_cnt = 0;
+    return DIS_COMMON_ERR_OK;
+}
+
+void gpio_int_print_info(const GpioIntCtx *ctx)
+{
+    if (!ctx) {
+        return;
+    }
+    
+    DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 2, "GPIO Interrupt Configuration: %u channels\n", ctx->int_cnt);
+    
+    FOR_EACH_ENABLED_CHANNEL(ctx, i) {
+        const GpioIntPinCfg *cfg = &ctx->ch[i].pin_cfg;
+        if (cfg->mode == GPIO_INT_MODE_EDGE) {
+            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 2, "  Ch[%d]: group%u.bit%u -> gpiod edge events (%s)\n", 
+                           i, cfg->group_id, cfg->group_bit, cfg->consumer);
+        } else {
+            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 2, "  Ch[%d]: group%u.bit%u -> uio%u (%s)\n", 
+                           i, cfg->group_id, cfg->group_bit, cfg->uio_index, cfg->consumer);
+        }
+    }
+}
+
+/**
+ * @brief Bring up channels, workers and the monitor thread from g_gpio_system_ctx
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ */
+static uint8_t gpio_int_system_start(void)
+{
+    uint8_t ret;
+    
+    /* Lock memory before any thread stack is mapped */
+    if (g_gpio_rt_cfg.lock_memory && !g_gpio_memory_locked) {
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0) {
+            g_gpio_memory_locked = true;
+        } else {
+            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "mlockall failed (%s), continuing without locked memory\n",
+                             strerror(errno));
+        }
+    }
+    
+    /* Allocate per-channel runtime state sized to the channel table */
+    ret = init_channel_state(g_gpio_system_ctx.int_cnt);
+    if (ret != DIS_COMMON_ERR_OK) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to allocate GPIO channel state\n");
+        gpio_int_ctx_free(&g_gpio_system_ctx);
+        return ret;
+    }
+    
+    /* Initialize all enabled GPIO interrupt channels */
+    ret = gpio_int_init(&g_gpio_system_ctx);
+    if (ret != DIS_COMMON_ERR_OK) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to initialize GPIO interrupt channels\n");
+        gpio_int_deinit(&g_gpio_system_ctx);
+        gpio_int_ctx_free(&g_gpio_system_ctx);
+        cleanup_channel_state();
+        return ret;
+    }
+    
+    /* Print configuration information */
+    gpio_int_print_info(&g_gpio_system_ctx);
+    
+    /* Callback workers start once callbacks are registered */
+    FOR_EACH_ENABLED_CHANNEL(&g_gpio_system_ctx, i) {
+        reset_channel_runtime(&g_gpio_system_ctx, (uint16_t)i);
+    }
+    
+    g_gpio_system_initialized = true;
+    
+    /* Start GPIO interrupt monitoring threads */
+    ret = gpio_int_start_monitor_threads();
+    if (ret != DIS_COMMON_ERR_OK) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to start GPIO interrupt monitor threads\n");
+        stop_callback_workers();
+        gpio_int_deinit(&g_gpio_system_ctx);
+        gpio_int_ctx_free(&g_gpio_system_ctx);
+        cleanup_channel_state();
+        g_gpio_system_initialized = false;
+        return ret;
+    }
+    
+    DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 2, "GPIO interrupt system initialized successfully (%s backend)\n",
+                     g_gpio_backend->name);
+    
+    return DIS_COMMON_ERR_OK;
+}
+
+uint8_t gpio_int_set_backend(const GpioIntBackendOps *ops)
+{
+    if (g_gpio_system_initialized) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Cannot change backend while GPIO system is initialized\n");
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    g_gpio_backend = ops ? ops : &g_gpio_int_hw_backend;
+    return DIS_COMMON_ERR_OK;
+}
+
+uint8_t gpio_int_set_rt_config(const GpioIntRtCfg *cfg)
+{
+    if (g_gpio_system_initialized) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Cannot change real-time config while GPIO system is initialized\n");
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    if (!cfg) {
+        memset(&g_gpio_rt_cfg, 0, sizeof(g_gpio_rt_cfg));
+        g_gpio_rt_cfg.monitor_cpu = GPIO_INT_CPU_ANY;
+        g_gpio_rt_cfg.worker_cpu = GPIO_INT_CPU_ANY;
+        return DIS_COMMON_ERR_OK;
+    }
+    
+    if (cfg->sched_policy > GPIO_INT_SCHED_RR || cfg->monitor_shards > GPIO_INT_MAX_MONITORS ||
+        cfg->monitor_cpu < GPIO_INT_CPU_ANY || cfg->monitor_cpu >= CPU_SETSIZE ||
+        cfg->worker_cpu < GPIO_INT_CPU_ANY || cfg->worker_cpu >= CPU_SETSIZE ||
+        cfg->monitor_loop > GPIO_INT_LOOP_IO_URING) {
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
+    
+    g_gpio_rt_cfg = *cfg;
+    return DIS_COMMON_ERR_OK;
+}
+
+uint8_t gpio_int_system_init(void)
+{
+    uint8_t ret;
+    
+    pthread_mutex_lock(&g_gpio_config_mutex);
+    
+    if (g_gpio_system_initialized) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "GPIO interrupt system already initialized\n");
+        pthread_mutex_unlock(&g_gpio_config_mutex);
+        return DIS_COMMON_ERR_OK;
+    }
+    
+    /* Load GPIO interrupt configuration from database */
+    ret = gpio_int_ctx_from_db(&g_gpio_system_ctx, GPIOINTERRUPT);
+    if (ret != DIS_COMMON_ERR_OK) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to load GPIO interrupt config from database\n");
+        pthread_mutex_unlock(&g_gpio_config_mutex);
+        return ret;
+    }
+    gpio_int_rt_cfg_from_db(&g_gpio_rt_cfg, GPIOINTERRUPT);
+    
+    ret = gpio_int_system_start();
+    pthread_mutex_unlock(&g_gpio_config_mutex);
+    return ret;
+}
+
+uint8_t gpio_int_system_init_static(void)
+{
+    /* Read-only view of the generated table, gpio_int_system_init_with_ctx() copies it */
+    GpioIntCtx table = {
+        .int_cnt = g_gpio_int_static_cnt,
+        .enable_mask = (uint64_t *)g_gpio_int_static_enable,
+        .ch = (GpioIntChannel *)g_gpio_int_static_ch,
+    };
+    
+    memcpy(table.rule, g_gpio_int_static_rule, sizeof(table.rule));
+    return gpio_int_system_init_with_ctx(&table);
+}
+
+uint8_t gpio_int_system_init_with_ctx(const GpioIntCtx *cfg)
+{
+    uint8_t ret;
+    
+    if (!cfg || !cfg->ch || !cfg->enable_mask) {
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
+    
+    for (uint8_t r = 0; r < GPIO_INT_MAX_RULES; r++) {
+        if (!rule_cfg_valid(&cfg->rule[r], cfg->int_cnt)) {
+            return DIS_COMMON_ERR_INV_PARAM;
+        }
+    }
+    
+    pthread_mutex_lock(&g_gpio_config_mutex);
+    
+    if (g_gpio_system_initialized) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "GPIO interrupt system already initialized\n");
+        pthread_mutex_unlock(&g_gpio_config_mutex);
+        return DIS_COMMON_ERR_OK;
+    }
+    
+    ret = gpio_int_ctx_copy(&g_gpio_system_ctx, cfg);
+    if (ret == DIS_COMMON_ERR_OK) {
+        ret = gpio_int_system_start();
+    }
+    
+    pthread_mutex_unlock(&g_gpio_config_mutex);
+    return ret;
+}
+
+/**
+ * @brief Close the epoll instances and wake eventfds of all shards, free the shard table
+ */
+static void close_monitor_fds(void)
+{
+    rules_close();
+    
+    for (uint8_t i = 0; i < g_gpio_monitor_cnt; i++) {
+        MonitorShard *shard = &g_gpio_monitor[i];
+        
+        uring_close_shard(shard);
+        free(shard->events);
+        free(shard->batch);
+        free(shard->batch_subs);
+        free(shard->batch_out);
+        
+        if (shard->epoll_fd >= 0) {
+            close(shard->epoll_fd);
+        }
+        
+        if (shard->wake_fd >= 0) {
+            close(shard->wake_fd);
+        }
+    }
+    
+    free(g_gpio_monitor);
+    g_gpio_monitor = NULL;
+    g_gpio_monitor_cnt = 0;
+}
+
+/**
+ * @brief Get the monitor shard servicing a channel
+ * @param channel GPIO interrupt channel number
+ * @return MonitorShard* Shard of the channel
+ */
+static MonitorShard *channel_shard(uint16_t channel)
+{
+    const GpioIntChannel *ch = &g_gpio_system_ctx.ch[channel];
+    uint8_t index = g_gpio_rt_cfg.shard_by_group ? ch->pin_cfg.group_id : ch->shard;
+    
+    return &g_gpio_monitor[index % g_gpio_monitor_cnt];
+}
+
+/**
+ * @brief Check whether a channel is serviced by its shard's ring rather than its epoll set
+ * @param shard Monitor shard of the channel
+ * @param channel GPIO interrupt channel number
+ * @return bool true for UIO channels of an io_uring shard
+ */
+static inline bool channel_on_ring(const MonitorShard *shard, uint16_t channel)
+{
+    return shard->use_uring && g_gpio_system_ctx.ch[channel].pin_cfg.mode == GPIO_INT_MODE_UIO;
+}
+
+/**
+ * @brief Reset the glitch filter of a channel, creating its timer if needed
+ * @param channel GPIO interrupt channel number (enabled and initialized)
+ * @param shard Monitor shard servicing the channel
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * The current line level becomes the reference for the first transition.
+ */
+static uint8_t filter_start(uint16_t channel, MonitorShard *shard)
+{
+    GpioIntChannel *ch = &g_gpio_system_ctx.ch[channel];
+    ChannelFilter *filter = &g_channel_filter[channel];
+    struct epoll_event ev;
+    
+    memset(filter, 0, sizeof(*filter));
+    filter->timer_fd = -1;
+    filter->last_value = -1;
+    filter->stable_value = -1;
+    
+    if (!filter_is_timed(&ch->filter)) {
+        return DIS_COMMON_ERR_OK;
+    }
+    
+    filter->stable_value = channel_read_value(&g_gpio_system_ctx, channel);
+    
+    filter->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (filter->timer_fd < 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to create filter timer for channel %u\n", channel);
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    ev.events = EPOLLIN;
+    ev.data.u32 = FILTER_TIMER_TAG | channel;
+    if (epoll_ctl(shard->epoll_fd, EPOLL_CTL_ADD, filter->timer_fd, &ev) != 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to add filter timer of channel %u to epoll\n", channel);
+        close(filter->timer_fd);
+        filter->timer_fd = -1;
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    return DIS_COMMON_ERR_OK;
+}
+
+/**
+ * @brief Remove the filter timer of a channel from its shard's epoll set
+ * @param channel GPIO interrupt channel number
+ * @param shard Monitor shard servicing the channel
+ * 
+ * The timer is closed by filter_close() once the monitor pass completed.
+ */
+static void filter_stop(uint16_t channel, MonitorShard *shard)
+{
+    ChannelFilter *filter = &g_channel_filter[channel];
+    
+    if (filter->timer_fd >= 0 && epoll_ctl(shard->epoll_fd, EPOLL_CTL_DEL, filter->timer_fd, NULL) != 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "Failed to remove filter timer of channel %u from epoll\n", channel);
+    }
+}
+
+/**
+ * @brief Close the filter timer of a channel
+ * @param channel GPIO interrupt channel number
+ */
+static void filter_close(uint16_t channel)
+{
+    ChannelFilter *filter = &g_channel_filter[channel];
+    
+    if (filter->timer_fd >= 0) {
+        close(filter->timer_fd);
+        filter->timer_fd = -1;
+    }
+    filter->armed = false;
+}
+
+/**
+ * @brief Reset the storm state of a channel, creating its poll timer if needed
+ * @param channel GPIO interrupt channel number (enabled and initialized)
+ * @param shard Monitor shard servicing the channel
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ */
+static uint8_t storm_start(uint16_t channel, MonitorShard *shard)
+{
+    const GpioIntStormCfg *cfg = &g_gpio_system_ctx.ch[channel].storm;
+    ChannelStorm *storm = &g_channel_storm[channel];
+    struct epoll_event ev;
+    
+    atomic_store(&storm->polling, false);
+    storm->timer_fd = -1;
+    storm->fired = false;
+    storm->saturated = false;
+    storm->window_start = 0;
+    storm->window_cnt = 0;
+    storm->last_icount = NO_ICOUNT;
+    
+    if (cfg->max_rate == 0) {
+        return DIS_COMMON_ERR_OK;
+    }
+    
+    uint32_t window_us = cfg->window_us ? cfg->window_us : GPIO_INT_STORM_WINDOW_US;
+    uint64_t limit = (uint64_t)cfg->max_rate * window_us / 1000000u;
+    storm->window_ns = (uint64_t)window_us * 1000u;
+    storm->limit = (limit == 0) ? 1 : (limit > UINT32_MAX) ? UINT32_MAX : (uint32_t)limit;
+    
+    storm->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (storm->timer_fd < 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to create storm poll timer for channel %u\n", channel);
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    ev.events = EPOLLIN;
+    ev.data.u32 = STORM_TIMER_TAG | channel;
+    if (epoll_ctl(shard->epoll_fd, EPOLL_CTL_ADD, storm->timer_fd, &ev) != 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to add storm poll timer of channel %u to epoll\n", channel);
+        close(storm->timer_fd);
+        storm->timer_fd = -1;
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    return DIS_COMMON_ERR_OK;
+}
+
+/**
+ * @brief Remove the storm poll timer of a channel from its shard's epoll set
+ * @param channel GPIO interrupt channel number
+ * @param shard Monitor shard servicing the channel
+ * 
+ * The timer is closed by storm_close() once the monitor pass completed.
+ */
+static void storm_stop(uint16_t channel, MonitorShard *shard)
+{
+    ChannelStorm *storm = &g_channel_storm[channel];
+    
+    if (storm->timer_fd >= 0 && epoll_ctl(shard->epoll_fd, EPOLL_CTL_DEL, storm->timer_fd, NULL) != 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "Failed to remove storm poll timer of channel %u from epoll\n", channel);
+    }
+}
+
+/**
+ * @brief Close the storm poll timer of a channel
+ * @param channel GPIO interrupt channel number
+ */
+static void storm_close(uint16_t channel)
+{
+    ChannelStorm *storm = &g_channel_storm[channel];
+    
+    if (storm->timer_fd >= 0) {
+        close(storm->timer_fd);
+        storm->timer_fd = -1;
+    }
+    atomic_store(&storm->polling, false);
+}
+
+/**
+ * @brief Start the counter window of a channel in counter mode
+ * @param channel GPIO interrupt channel number (enabled and initialized)
+ * @param shard Monitor shard servicing the channel
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * The current line level is the level the first window starts at.
+ */
+static uint8_t counter_start(uint16_t channel, MonitorShard *shard)
+{
+    const GpioIntCounterCfg *cfg = &g_gpio_system_ctx.ch[channel].counter;
+    ChannelCounter *counter = &g_channel_counter[channel];
+    struct epoll_event ev;
+    
+    counter->timer_fd = -1;
+    if (cfg->window_us == 0) {
+        return DIS_COMMON_ERR_OK;
+    }
+    
+    uint64_t now_ns = gpio_int_now_ns();
+    memset(&counter->window, 0, sizeof(counter->window));
+    counter->window.channel = channel;
+    counter->window.start_ns = now_ns;
+    counter->level = channel_read_value(&g_gpio_system_ctx, channel);
+    counter->edge = GPIO_INT_EDGE_NONE;
+    counter->level_ns = now_ns;
+    counter->edge_ns = 0;
+    counter->rise_ns = 0;
+    
+    counter->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (counter->timer_fd < 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to create counter timer for channel %u\n", channel);
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    struct timespec period = { .tv_sec = (time_t)(cfg->window_us / 1000000u),
+                               .tv_nsec = (long)(cfg->window_us % 1000000u) * 1000L };
+    struct itimerspec its = { .it_value = period, .it_interval = period };
+    ev.events = EPOLLIN;
+    ev.data.u32 = COUNTER_TIMER_TAG | channel;
+    if (timerfd_settime(counter->timer_fd, 0, &its, NULL) != 0 ||
+        epoll_ctl(shard->epoll_fd, EPOLL_CTL_ADD, counter->timer_fd, &ev) != 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to set up counter timer of channel %u\n", channel);
+        close(counter->timer_fd);
+        counter->timer_fd = -1;
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    return DIS_COMMON_ERR_OK;
+}
+
+/**
+ * @brief Remove the counter timer of a channel from its shard's epoll set
+ * @param channel GPIO interrupt channel number
+ * @param shard Monitor shard servicing the channel
+ * 
+ * The timer is closed by counter_close() once the monitor pass completed.
+ */
+static void counter_stop(uint16_t channel, MonitorShard *shard)
+{
+    ChannelCounter *counter = &g_channel_counter[channel];
+    
+    if (counter->timer_fd >= 0 && epoll_ctl(shard->epoll_fd, EPOLL_CTL_DEL, counter->timer_fd, NULL) != 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "Failed to remove counter timer of channel %u from epoll\n", channel);
+    }
+}
+
+/**
+ * @brief Close the counter timer of a channel, the last report is kept
+ * @param channel GPIO interrupt channel number
+ */
+static void counter_close(uint16_t channel)
+{
+    ChannelCounter *counter = &g_channel_counter[channel];
+    
+    if (counter->timer_fd >= 0) {
+        close(counter->timer_fd);
+        counter->timer_fd = -1;
+    }
+}
+
+/**
+ * @brief Compare two rule configurations
+ * @param a First configuration
+ * @param b Second configuration
+ * @return bool true if equal
+ */
+static bool rule_cfg_equal(const GpioIntRuleCfg *a, const GpioIntRuleCfg *b)
+{
+    if (a->op != b->op || a->term_cnt != b->term_cnt || a->window_us != b->window_us || a->hold_us != b->hold_us) {
+        return false;
+    }
+    
+    for (uint8_t i = 0; i < a->term_cnt; i++) {
+        if (a->term[i].channel != b->term[i].channel || a->term[i].level != b->term[i].level) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Start evaluating a rule of g_gpio_system_ctx on the shard of its channels
+ * @param rule Rule index (term_cnt not 0)
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * A condition already true is latched without matching, except for SEQ
+ * rules which only match on their channel events. Must be called with
+ * g_gpio_config_mutex held and the rule stopped.
+ */
+static uint8_t rule_start(uint8_t rule)
+{
+    const GpioIntRuleCfg *cfg = &g_gpio_system_ctx.rule[rule];
+    RuleState *st = &g_rule_state[rule];
+    MonitorShard *shard = channel_shard(cfg->term[0].channel);
+    struct epoll_event ev;
+    uint64_t first_ns;
+    
+    for (uint8_t i = 1; i < cfg->term_cnt; i++) {
+        if (channel_shard(cfg->term[i].channel) != shard) {
+            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Channels of rule %u are not on one monitor shard\n", rule);
+            return DIS_COMMON_ERR_INV_PARAM;
+        }
+    }
+    
+    st->shard = shard->index;
+    st->active = false;
+    st->held = false;
+    st->next = 0;
+    atomic_store(&st->matches, 0);
+    
+    st->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (st->timer_fd < 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to create hold timer for rule %u\n", rule);
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    ev.events = EPOLLIN;
+    ev.data.u32 = RULE_TIMER_TAG | rule;
+    if (epoll_ctl(shard->epoll_fd, EPOLL_CTL_ADD, st->timer_fd, &ev) != 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to add hold timer of rule %u to epoll\n", rule);
+        close(st->timer_fd);
+        st->timer_fd = -1;
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    if (cfg->op != GPIO_INT_RULE_SEQ) {
+        st->active = rule_condition(cfg, &first_ns);
+    }
+    st->started = true;
+    
+    /* Publish the rule to the monitor once its state is set up */
+    for (uint8_t i = 0; i < cfg->term_cnt; i++) {
+        atomic_fetch_or(&g_channel_rules[cfg->term[i].channel], (uint16_t)(1u << rule));
+    }
+    
+    return DIS_COMMON_ERR_OK;
+}
+
+/**
+ * @brief Stop evaluating a rule and close its hold timer
+ * @param rule Rule index
+ * 
+ * Returns once the monitor no longer evaluates the rule. Must be called
+ * with g_gpio_config_mutex held.
+ */
+static void rule_stop(uint8_t rule)
+{
+    const GpioIntRuleCfg *cfg = &g_gpio_system_ctx.rule[rule];
+    RuleState *st = &g_rule_state[rule];
+    MonitorShard *shard = &g_gpio_monitor[st->shard];
+    
+    if (!st->started) {
+        return;
+    }
+    
+    for (uint8_t i = 0; i < cfg->term_cnt; i++) {
+        atomic_fetch_and(&g_channel_rules[cfg->term[i].channel], (uint16_t)~(1u << rule));
+    }
+    if (epoll_ctl(shard->epoll_fd, EPOLL_CTL_DEL, st->timer_fd, NULL) != 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "Failed to remove hold timer of rule %u from epoll\n", rule);
+    }
+    
+    wait_monitor_pass(shard);
+    close(st->timer_fd);
+    st->timer_fd = -1;
+    st->started = false;
+}
+
+/**
+ * @brief Close the hold timers of all rules once the monitor threads are gone
+ */
+static void rules_close(void)
+{
+    for (uint8_t i = 0; i < GPIO_INT_MAX_RULES; i++) {
+        RuleState *st = &g_rule_state[i];
+        
+        if (st->started) {
+            close(st->timer_fd);
+            st->timer_fd = -1;
+            st->started = false;
+        }
+    }
+}
+
+/**
+ * @brief Add a channel's interrupt source to its shard's epoll set and arm it
+ * @param channel GPIO interrupt channel number (enabled and initialized)
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ */
+static uint8_t monitor_add_channel(uint16_t channel)
+{
+    GpioIntChannel *ch = &g_gpio_system_ctx.ch[channel];
+    MonitorShard *shard = channel_shard(channel);
+    struct epoll_event ev;
+    
+    /* The timers go in first, so the first interrupt finds them set up */
+    uint8_t ret = filter_start(channel, shard);
+    if (ret == DIS_COMMON_ERR_OK) {
+        ret = storm_start(channel, shard);
+        if (ret == DIS_COMMON_ERR_OK) {
+            ret = counter_start(channel, shard);
+            if (ret != DIS_COMMON_ERR_OK) {
+                storm_stop(channel, shard);
+                storm_close(channel);
+            }
+        }
+        if (ret != DIS_COMMON_ERR_OK) {
+            filter_stop(channel, shard);
+            filter_close(channel);
+        }
+    }
+    if (ret != DIS_COMMON_ERR_OK) {
+        return ret;
+    }
+    
+    ev.events = EPOLLIN;
+    ev.data.u32 = channel; /* Store channel number */
+    
+    /* UIO channels of an io_uring shard get a posted read instead */
+    bool on_ring = channel_on_ring(shard, channel);
+    int fd = ch->fd;
+    if (ch->pin_cfg.mode == GPIO_INT_MODE_EDGE) {
+        fd = g_gpio_backend->get_event_fd(&g_gpio_system_ctx, channel);
+    }
+    if (!on_ring && epoll_ctl(shard->epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to add channel %u to epoll\n", channel);
+        filter_stop(channel, shard);
+        filter_close(channel);
+        storm_stop(channel, shard);
+        storm_close(channel);
+        counter_stop(channel, shard);
+        counter_close(channel);
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    /* Enable interrupt for this channel */
+    ret = gpio_int_enable_irq(&g_gpio_system_ctx, channel);
+    if (ret != DIS_COMMON_ERR_OK) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to enable IRQ for channel %u\n", channel);
+        if (!on_ring) {
+            epoll_ctl(shard->epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+        }
+        filter_stop(channel, shard);
+        filter_close(channel);
+        storm_stop(channel, shard);
+        storm_close(channel);
+        counter_stop(channel, shard);
+        counter_close(channel);
+        return ret;
+    }
+    
+    if (on_ring) {
+        uring_add_channel(shard, channel);
+    }
+    if (ch->priority == GPIO_INT_PRIO_CRITICAL) {
+        atomic_fetch_add(&shard->critical_cnt, 1);
+    }
+    
+    /* Let bus subscribers select the channel by consumer */
+    GpioIntBusHeader *bus = atomic_load(&g_gpio_bus);
+    if (bus) {
+        memcpy(bus->consumer[channel], ch->pin_cfg.consumer, sizeof(bus->consumer[channel]));
+    }
+    
+    DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 2, "Added channel %u (%s) to interrupt monitoring on shard %u\n", 
+                   channel, ch->pin_cfg.consumer, shard->index);
+    return DIS_COMMON_ERR_OK;
+}
+
+/**
+ * @brief Wait until a monitor shard has finished its current pass
+ * @param shard Monitor shard
+ * 
+ * Events returned by epoll_wait() before a channel was removed from the
+ * epoll set are handled within that pass, so afterwards the monitor holds
+ * no reference to the channel. Kicks the wake eventfd so an idle monitor
+ * completes a pass immediately.
+ */
+static void wait_monitor_pass(MonitorShard *shard)
+{
+    uint64_t one = 1;
+    
+    if (!g_gpio_monitor_running || !shard->started) {
+        return;
+    }
+    
+    atomic_fetch_add(&g_gpio_monitor_pass_waiters, 1);
+    uint64_t target = atomic_load(&shard->pass) + 1;
+    
+    if (write(shard->wake_fd, &one, sizeof(one)) != sizeof(one)) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to wake GPIO monitor shard %u\n", shard->index);
+    }
+    
+    pthread_mutex_lock(&g_gpio_monitor_pass_mutex);
+    while (atomic_load(&shard->pass) < target) {
+        pthread_cond_wait(&g_gpio_monitor_pass_cond, &g_gpio_monitor_pass_mutex);
+    }
+    pthread_mutex_unlock(&g_gpio_monitor_pass_mutex);
+    
+    atomic_fetch_sub(&g_gpio_monitor_pass_waiters, 1);
+}
+
+/**
+ * @brief Remove a channel's interrupt source from its shard's epoll set
+ * @param channel GPIO interrupt channel number
+ * 
+ * Returns once the monitor thread can no longer touch the channel.
+ */
+static void monitor_remove_channel(uint16_t channel)
+{
+    GpioIntChannel *ch = &g_gpio_system_ctx.ch[channel];
+    MonitorShard *shard = channel_shard(channel);
+    
+    int fd = ch->fd;
+    if (ch->pin_cfg.mode == GPIO_INT_MODE_EDGE) {
+        fd = g_gpio_backend->get_event_fd(&g_gpio_system_ctx, channel);
+    }
+    
+    /* A poll may re-enable the interrupt, so the timer goes before the ring drains */
+    storm_stop(channel, shard);
+    if (channel_on_ring(shard, channel)) {
+        uring_remove_channel(shard, channel);
+    } else if (fd >= 0 && epoll_ctl(shard->epoll_fd, EPOLL_CTL_DEL, fd, NULL) != 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "Failed to remove channel %u from epoll\n", channel);
+    }
+    filter_stop(channel, shard);
+    counter_stop(channel, shard);
+    if (ch->priority == GPIO_INT_PRIO_CRITICAL) {
+        atomic_fetch_sub(&shard->critical_cnt, 1);
+    }
+    
+    wait_monitor_pass(shard);
+    filter_close(channel);
+    storm_close(channel);
+    counter_close(channel);
+}
+
+/**
+ * @brief Create the epoll instance, wake eventfd and event buffer of a shard
+ * @param shard Monitor shard
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ */
+static uint8_t init_monitor_shard(MonitorShard *shard)
+{
+    struct epoll_event ev;
+    
+    /* Create epoll instance */
+    shard->epoll_fd = epoll_create1(0);
+    if (shard->epoll_fd < 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to create epoll instance\n");
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    /* Wake eventfd lets shutdown and reconfiguration interrupt a blocking epoll_wait */
+    ev.events = EPOLLIN;
+    ev.data.u32 = MONITOR_WAKE_TAG;
+    shard->wake_fd = eventfd(0, EFD_CLOEXEC);
+    if (shard->wake_fd < 0 ||
+        epoll_ctl(shard->epoll_fd, EPOLL_CTL_ADD, shard->wake_fd, &ev) != 0) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to set up GPIO monitor wake eventfd\n");
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    /* Four epoll slots per channel (source, filter, storm and counter timers),
+     * so channels enabled at runtime fit, plus the rule hold timers and the
+     * wake eventfd */
+    shard->event_cap = 4 * g_gpio_system_ctx.int_cnt + GPIO_INT_MAX_RULES + 1;
+    shard->events = calloc((size_t)shard->event_cap, sizeof(*shard->events));
+    if (!shard->events) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to allocate GPIO monitor event buffer\n");
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    shard->batch = calloc(GPIO_INT_BATCH_MAX, sizeof(*shard->batch));
+    shard->batch_subs = calloc(GPIO_INT_BATCH_MAX, sizeof(*shard->batch_subs));
+    shard->batch_out = calloc(GPIO_INT_BATCH_MAX, sizeof(*shard->batch_out));
+    if (!shard->batch || !shard->batch_subs || !shard->batch_out) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to allocate GPIO monitor batch buffer\n");
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    /* The ring reads and writes ch[].fd directly, bypassing read_irq/enable_irq */
+    if (g_gpio_rt_cfg.monitor_loop == GPIO_INT_LOOP_IO_URING) {
+        if (g_gpio_backend->raw_uio_fd) {
+            shard->use_uring = uring_init_shard(shard);
+        } else {
+            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "%s backend has no raw UIO fds, monitor shard %u uses epoll\n",
+                             g_gpio_backend->name, shard->index);
+        }
+    }
+    
+    return DIS_COMMON_ERR_OK;
+}
+
+static uint8_t gpio_int_start_monitor_threads(void)
+{
+    uint8_t shard_cnt = g_gpio_rt_cfg.monitor_shards ? g_gpio_rt_cfg.monitor_shards : 1;
+    uint8_t ret;
+    
+    if (g_gpio_monitor_running) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "GPIO monitor threads already running\n");
+        return DIS_COMMON_ERR_OK;
+    }
+    
+    g_gpio_monitor = calloc(shard_cnt, sizeof(*g_gpio_monitor));
+    if (!g_gpio_monitor) {
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    g_gpio_monitor_cnt = shard_cnt;
+    for (uint8_t i = 0; i < shard_cnt; i++) {
+        g_gpio_monitor[i].index = i;
+        g_gpio_monitor[i].epoll_fd = -1;
+        g_gpio_monitor[i].wake_fd = -1;
+    }
+    
+    for (uint8_t i = 0; i < shard_cnt; i++) {
+        ret = init_monitor_shard(&g_gpio_monitor[i]);
+        if (ret != DIS_COMMON_ERR_OK) {
+            close_monitor_fds();
+            return ret;
+        }
+    }
+    
+    /* Add all enabled GPIO interrupt channels to the epoll set of their shard */
+    FOR_EACH_ENABLED_CHANNEL(&g_gpio_system_ctx, i) {
+        ret = monitor_add_channel((uint16_t)i);
+        if (ret != DIS_COMMON_ERR_OK) {
+            close_monitor_fds();
+            return ret;
+        }
+    }
+    
+    /* A rule that cannot be evaluated is dropped without failing the start */
+    for (uint8_t i = 0; i < GPIO_INT_MAX_RULES; i++) {
+        if (g_gpio_system_ctx.rule[i].term_cnt != 0 && rule_start(i) != DIS_COMMON_ERR_OK) {
+            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to start rule %u, removed\n", i);
+            memset(&g_gpio_system_ctx.rule[i], 0, sizeof(g_gpio_system_ctx.rule[i]));
+        }
+    }
+    
+    /* Start one monitoring thread per shard, on consecutive CPUs when pinned */
+    g_gpio_monitor_running = true;
+    for (uint8_t i = 0; i < shard_cnt; i++) {
+        MonitorShard *shard = &g_gpio_monitor[i];
+        int16_t cpu = g_gpio_rt_cfg.monitor_cpu;
+        
+        if (cpu != GPIO_INT_CPU_ANY) {
+            cpu = (int16_t)(cpu + i);
+        }
+        
+        if (create_interrupt_thread(&shard->thread,
+                                    shard->use_uring ? gpio_uring_monitor_thread : gpio_interrupt_monitor_thread,
+                                    shard, g_gpio_rt_cfg.sched_policy, g_gpio_rt_cfg.monitor_priority, cpu) != 0) {
+            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to create GPIO monitor thread for shard %u\n", i);
+            gpio_int_stop_monitor_threads();
+            return DIS_COMMON_ERR_API_FAIL;
+        }
+        shard->started = true;
+    }
+    
+    return DIS_COMMON_ERR_OK;
+}
+
+static uint8_t gpio_int_stop_monitor_threads(void)
+{
+    uint64_t one = 1;
+    
+    if (!g_gpio_monitor_running) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "GPIO monitor threads not running\n");
+        return DIS_COMMON_ERR_OK;
+    }
+    
+    /* Signal threads to stop and wake them from epoll_wait */
+    g_gpio_monitor_running = false;
+    for (uint8_t i = 0; i < g_gpio_monitor_cnt; i++) {
+        MonitorShard *shard = &g_gpio_monitor[i];
+        
+        if (!shard->started) {
+            continue;
+        }
+        
+        if (write(shard->wake_fd, &one, sizeof(one)) != sizeof(one)) {
+            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to wake GPIO monitor shard %u\n", i);
+        }
+        
+        /* Wait for thread to finish */
+        if (pthread_join(shard->thread, NULL) != 0) {
+            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to join GPIO monitor shard %u\n", i);
+        }
+        shard->started = false;
+    }
+    
+    /* Close epoll and wake file descriptors */
+    close_monitor_fds();
+    
+    DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 2, "GPIO interrupt monitor threads stopped\n");
+    return DIS_COMMON_ERR_OK;
+}
+
+/**
+ * @brief Compare two pin configurations
+ * @param a First configuration
+ * @param b Second configuration
+ * @return bool true if both select the same pin, interrupt source and mode
+ */
+static bool pin_cfg_equal(const GpioIntPinCfg *a, const GpioIntPinCfg *b)
+{
+    return a->group_id == b->group_id &&
+           a->group_bit == b->group_bit &&
+           a->uio_index == b->uio_index &&
+           a->mode == b->mode &&
+           a->datain_mmio == b->datain_mmio &&
+           a->datain_reg == b->datain_reg &&
+           strncmp(a->consumer, b->consumer, sizeof(a->consumer)) == 0;
+}
+
+/**
+ * @brief Compare two filter configurations
+ * @param a First configuration
+ * @param b Second configuration
+ * @return bool true if both filter identically
+ */
+static bool filter_cfg_equal(const GpioIntFilterCfg *a, const GpioIntFilterCfg *b)
+{
+    return a->debounce_us == b->debounce_us &&
+           a->min_pulse_us == b->min_pulse_us &&
+           a->edge_filter == b->edge_filter;
+}
+
+/**
+ * @brief Compare two storm protection configurations
+ * @param a First configuration
+ * @param b Second configuration
+ * @return bool true if equal
+ */
+static bool storm_cfg_equal(const GpioIntStormCfg *a, const GpioIntStormCfg *b)
+{
+    return a->max_rate == b->max_rate && a->window_us == b->window_us && a->poll_us == b->poll_us;
+}
+
+/**
+ * @brief Compare two counter mode configurations
+ * @param a First configuration
+ * @param b Second configuration
+ * @return bool true if equal
+ */
+static bool counter_cfg_equal(const GpioIntCounterCfg *a, const GpioIntCounterCfg *b)
+{
+    return a->window_us == b->window_us;
+}
+
+/**
+ * @brief Bring up a disabled channel of the running system
+ * @param channel GPIO interrupt channel number, pin_cfg already set
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * Opens the interrupt source, starts the worker and only then adds the
+ * channel to the live epoll set. Must be called with g_gpio_config_mutex held.
+ */
+static uint8_t channel_bring_up(uint16_t channel)
+{
+    GpioIntCtx *ctx = &g_gpio_system_ctx;
+    
+    pthread_rwlock_wrlock(&g_gpio_line_lock);
+    uint8_t ret = init_single_channel(ctx, channel);
+    pthread_rwlock_unlock(&g_gpio_line_lock);
+    if (ret != DIS_COMMON_ERR_OK) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to initialize GPIO interrupt channel %u\n", channel);
+        return ret;
+    }
+    
+    /* Callbacks stay registered while a channel is down */
+    reset_channel_runtime(ctx, channel);
+    if (channel_has_callback(channel)) {
+        ret = start_callback_worker(ctx, channel);
+        if (ret != DIS_COMMON_ERR_OK) {
+            release_single_channel(ctx, channel);
+            return ret;
+        }
+    }
+    
+    gpio_int_ctx_set_enabled(ctx, channel, 1);
+    ret = monitor_add_channel(channel);
+    if (ret != DIS_COMMON_ERR_OK) {
+        gpio_int_ctx_set_enabled(ctx, channel, 0);
+        stop_callback_worker(channel);
+        release_single_channel(ctx, channel);
+        return ret;
+    }
+    
+    return DIS_COMMON_ERR_OK;
+}
+
+/**
+ * @brief Take an enabled channel of the running system down
+ * @param channel GPIO interrupt channel number
+ * 
+ * Other channels keep being serviced throughout. Must be called with
+ * g_gpio_config_mutex held.
+ */
+static void channel_tear_down(uint16_t channel)
+{
+    GpioIntCtx *ctx = &g_gpio_system_ctx;
+    
+    monitor_remove_channel(channel);
+    gpio_int_ctx_set_enabled(ctx, channel, 0);
+    stop_callback_worker(channel);
+    release_single_channel(ctx, channel);
+    state_store(channel, -1, GPIO_INT_EDGE_NONE, 0, 0);
+    
+    /* Let a consumer blocked in gpio_int_wait() see the channel is gone */
+    if (g_channel_worker[channel].pull) {
+        uint64_t one = 1;
+        if (write(g_channel_worker[channel].wake_fd, &one, sizeof(one)) != sizeof(one)) {
+            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "Failed to wake pull consumer of channel %u\n", channel);
+        }
+    }
+    
+    DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 2, "Removed channel %u (%s) from interrupt monitoring\n",
+                     channel, ctx->ch[channel].pin_cfg.consumer);
+}
+
+uint8_t gpio_int_channel_add(uint16_t channel, const GpioIntPinCfg *cfg, GpioIntOverflowPolicy policy)
+{
+    uint8_t ret;
+    
+    if (!cfg || cfg->mode > GPIO_INT_MODE_EDGE || policy > GPIO_INT_OVERFLOW_MERGE) {
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
+    
+    pthread_mutex_lock(&g_gpio_config_mutex);
+    
+    if (!g_gpio_system_initialized) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "GPIO system not initialized\n");
+        pthread_mutex_unlock(&g_gpio_config_mutex);
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    if (channel >= g_gpio_system_ctx.int_cnt) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Channel %u exceeds configured channel count (%u)\n", 
+                         channel, g_gpio_system_ctx.int_cnt);
+        pthread_mutex_unlock(&g_gpio_config_mutex);
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
+    
+    if (gpio_int_ctx_is_enabled(&g_gpio_system_ctx, channel)) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Channel %u is already enabled\n", channel);
+        pthread_mutex_unlock(&g_gpio_config_mutex);
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    g_gpio_system_ctx.ch[channel].pin_cfg = *cfg;
+    g_gpio_system_ctx.ch[channel].overflow_policy = (uint8_t)policy;
+    ret = channel_bring_up(channel);
+    
+    pthread_mutex_unlock(&g_gpio_config_mutex);
+    return ret;
+}
+
+uint8_t gpio_int_channel_remove(uint16_t channel)
+{
+    pthread_mutex_lock(&g_gpio_config_mutex);
+    
+    if (!g_gpio_system_initialized || channel >= g_gpio_system_ctx.int_cnt) {
+        pthread_mutex_unlock(&g_gpio_config_mutex);
+        return g_gpio_system_initialized ? DIS_COMMON_ERR_INV_PARAM : DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    if (gpio_int_ctx_is_enabled(&g_gpio_system_ctx, channel)) {
+        channel_tear_down(channel);
+    }
+    
+    /* The pull consumer was woken on tear down, the channel may take callbacks again */
+    CallbackWorker *worker = &g_channel_worker[channel];
+    if (atomic_exchange_explicit(&worker->pull, false, memory_order_acq_rel)) {
+        close(worker->wake_fd);
+        worker->wake_fd = -1;
+    }
+    
+    /* Forget the configuration and registrations of the channel */
+    atomic_store_explicit(&g_channel_hot[channel].callback, NULL, memory_order_release);
+    atomic_store_explicit(&g_channel_hot[channel].wide_callback, NULL, memory_order_release);
+    atomic_store_explicit(&g_channel_hot[channel].event_callback, NULL, memory_order_release);
+    memset(&g_gpio_system_ctx.ch[channel].pin_cfg, 0, sizeof(g_gpio_system_ctx.ch[channel].pin_cfg));
+    g_gpio_system_ctx.ch[channel].overflow_policy = GPIO_INT_OVERFLOW_QUEUE;
+    g_gpio_system_ctx.ch[channel].shard = 0;
+    g_gpio_system_ctx.ch[channel].priority = GPIO_INT_PRIO_NORMAL;
+    g_gpio_system_ctx.ch[channel].dispatch = GPIO_INT_DISPATCH_WORKER;
+    memset(&g_gpio_system_ctx.ch[channel].filter, 0, sizeof(g_gpio_system_ctx.ch[channel].filter));
+    memset(&g_gpio_system_ctx.ch[channel].storm, 0, sizeof(g_gpio_system_ctx.ch[channel].storm));
+    memset(&g_gpio_system_ctx.ch[channel].counter, 0, sizeof(g_gpio_system_ctx.ch[channel].counter));
+    
+    /* A monitor pass that loaded the counter callback may still be calling it */
+    if (atomic_exchange(&g_channel_counter[channel].callback, NULL)) {
+        for (uint8_t i = 0; i < g_gpio_monitor_cnt; i++) {
+            wait_monitor_pass(&g_gpio_monitor[i]);
+        }
+    }
+    g_channel_counter[channel].arg = NULL;
+    
+    pthread_mutex_unlock(&g_gpio_config_mutex);
+    return DIS_COMMON_ERR_OK;
+}
+
+uint8_t gpio_int_channel_set_enabled(uint16_t channel, uint8_t enable)
+{
+    uint8_t ret = DIS_COMMON_ERR_OK;
+    
+    pthread_mutex_lock(&g_gpio_config_mutex);
+    
+    if (!g_gpio_system_initialized || channel >= g_gpio_system_ctx.int_cnt) {
+        pthread_mutex_unlock(&g_gpio_config_mutex);
+        return g_gpio_system_initialized ? DIS_COMMON_ERR_INV_PARAM : DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    uint8_t enabled = gpio_int_ctx_is_enabled(&g_gpio_system_ctx, channel);
+    if (enable && !enabled) {
+        if (g_gpio_system_ctx.ch[channel].pin_cfg.consumer[0] == '\0') {
+            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Channel %u has no configuration, use gpio_int_channel_add()\n", channel);
+            ret = DIS_COMMON_ERR_INV_PARAM;
+        } else {
+            ret = channel_bring_up(channel);
+        }
+    } else if (!enable && enabled) {
+        channel_tear_down(channel);
+    }
+    
+    pthread_mutex_unlock(&g_gpio_config_mutex);
+    return ret;
+}
+
+uint8_t gpio_int_set_filter(uint16_t channel, const GpioIntFilterCfg *filter)
+{
+    static const GpioIntFilterCfg no_filter = { 0 };
+    uint8_t ret = DIS_COMMON_ERR_OK;
+    
+    if (!filter) {
+        filter = &no_filter;
+    }
+    if (filter->edge_filter > GPIO_INT_FILTER_FALLING) {
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
+    
+    pthread_mutex_lock(&g_gpio_config_mutex);
+    
+    if (!g_gpio_system_initialized || channel >= g_gpio_system_ctx.int_cnt) {
+        pthread_mutex_unlock(&g_gpio_config_mutex);
+        return g_gpio_system_initialized ? DIS_COMMON_ERR_INV_PARAM : DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    GpioIntChannel *ch = &g_gpio_system_ctx.ch[channel];
+    if (filter_cfg_equal(&ch->filter, filter)) {
+        pthread_mutex_unlock(&g_gpio_config_mutex);
+        return DIS_COMMON_ERR_OK;
+    }
+    
+    /* The monitor reads the filter without locking, so swap it while the channel is down */
+    if (gpio_int_ctx_is_enabled(&g_gpio_system_ctx, channel)) {
+        channel_tear_down(channel);
+        ch->filter = *filter;
+        ret = channel_bring_up(channel);
+    } else {
+        ch->filter = *filter;
+    }
+    
+    pthread_mutex_unlock(&g_gpio_config_mutex);
+    return ret;
+}
+
+uint8_t gpio_int_set_storm(uint16_t channel, const GpioIntStormCfg *storm)
+{
+    static const GpioIntStormCfg no_storm = { 0 };
+    uint8_t ret = DIS_COMMON_ERR_OK;
+    
+    if (!storm) {
+        storm = &no_storm;
+    }
+    if (!storm_cfg_valid(storm)) {
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
+    
+    pthread_mutex_lock(&g_gpio_config_mutex);
+    
+    if (!g_gpio_system_initialized || channel >= g_gpio_system_ctx.int_cnt) {
+        pthread_mutex_unlock(&g_gpio_config_mutex);
+        return g_gpio_system_initialized ? DIS_COMMON_ERR_INV_PARAM : DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    GpioIntChannel *ch = &g_gpio_system_ctx.ch[channel];
+    if (storm_cfg_equal(&ch->storm, storm)) {
+        pthread_mutex_unlock(&g_gpio_config_mutex);
+        return DIS_COMMON_ERR_OK;
+    }
+    
+    /* The monitor reads the limits without locking, so swap them while the channel is down */
+    if (gpio_int_ctx_is_enabled(&g_gpio_system_ctx, channel)) {
+        channel_tear_down(channel);
+        ch->storm = *storm;
+        ret = channel_bring_up(channel);
+    } else {
+        ch->storm = *storm;
+    }
+    
+    pthread_mutex_unlock(&g_gpio_config_mutex);
+    return ret;
+}
+
+uint8_t gpio_int_set_counter(uint16_t channel, const GpioIntCounterCfg *counter)
+{
+    static const GpioIntCounterCfg no_counter = { 0 };
+    uint8_t ret = DIS_COMMON_ERR_OK;
+    
+    if (!counter) {
+        counter = &no_counter;
+    }
+    if (counter->window_us != 0 && counter->window_us < GPIO_INT_COUNTER_MIN_WINDOW_US) {
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
+    
+    pthread_mutex_lock(&g_gpio_config_mutex);
+    
+    if (!g_gpio_system_initialized || channel >= g_gpio_system_ctx.int_cnt) {
+        pthread_mutex_unlock(&g_gpio_config_mutex);
+        return g_gpio_system_initialized ? DIS_COMMON_ERR_INV_PARAM : DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    GpioIntChannel *ch = &g_gpio_system_ctx.ch[channel];
+    if (counter_cfg_equal(&ch->counter, counter)) {
+        pthread_mutex_unlock(&g_gpio_config_mutex);
+        return DIS_COMMON_ERR_OK;
+    }
+    
+    /* The monitor checks the counter timer without locking, so switch modes while the channel is down */
+    if (gpio_int_ctx_is_enabled(&g_gpio_system_ctx, channel)) {
+        channel_tear_down(channel);
+        ch->counter = *counter;
+        ret = channel_bring_up(channel);
+    } else {
+        ch->counter = *counter;
+    }
+    
+    pthread_mutex_unlock(&g_gpio_config_mutex);
+    return ret;
+}
+
+uint8_t gpio_int_register_counter_callback(uint16_t channel, gpio_interrupt_counter_callback_t callback, void *arg)
+{
+    pthread_mutex_lock(&g_gpio_config_mutex);
+    
+    if (!g_gpio_system_initialized || channel >= g_gpio_system_ctx.int_cnt) {
+        pthread_mutex_unlock(&g_gpio_config_mutex);
+        return g_gpio_system_initialized ? DIS_COMMON_ERR_INV_PARAM : DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    ChannelCounter *counter = &g_channel_counter[channel];
+    gpio_interrupt_counter_callback_t old = atomic_exchange(&counter->callback, NULL);
+    
+    /* A monitor pass that loaded the old callback may still be calling it with the old arg */
+    if (old) {
+        for (uint8_t i = 0; i < g_gpio_monitor_cnt; i++) {
+            wait_monitor_pass(&g_gpio_monitor[i]);
+        }
+    }
+    
+    counter->arg = arg;
+    atomic_store_explicit(&counter->callback, callback, memory_order_release);
+    
+    pthread_mutex_unlock(&g_gpio_config_mutex);
+    return DIS_COMMON_ERR_OK;
+}
+
+uint8_t gpio_int_register_storm_callback(gpio_interrupt_storm_callback_t callback)
+{
+    pthread_mutex_lock(&g_gpio_config_mutex);
+    
+    gpio_interrupt_storm_callback_t old = atomic_exchange(&g_gpio_storm_callback, callback);
+    
+    /* A monitor pass that loaded the old callback may still be calling it */
+    if (old && old != callback && g_gpio_system_initialized) {
+        for (uint8_t i = 0; i < g_gpio_monitor_cnt; i++) {
+            wait_monitor_pass(&g_gpio_monitor[i]);
+        }
+    }
+    
+    pthread_mutex_unlock(&g_gpio_config_mutex);
+    return DIS_COMMON_ERR_OK;
+}
+
+uint8_t gpio_int_set_rule(uint8_t rule, const GpioIntRuleCfg *cfg)
+{
+    static const GpioIntRuleCfg no_rule = { 0 };
+    uint8_t ret = DIS_COMMON_ERR_OK;
+    
+    if (rule >= GPIO_INT_MAX_RULES) {
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
+    if (!cfg) {
+        cfg = &no_rule;
+    }
+    
+    pthread_mutex_lock(&g_gpio_config_mutex);
+    
+    if (!g_gpio_system_initialized || !rule_cfg_valid(cfg, g_gpio_system_ctx.int_cnt)) {
+        pthread_mutex_unlock(&g_gpio_config_mutex);
+        return g_gpio_system_initialized ? DIS_COMMON_ERR_INV_PARAM : DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    GpioIntRuleCfg *cur = &g_gpio_system_ctx.rule[rule];
+    if (rule_cfg_equal(cur, cfg)) {
+        pthread_mutex_unlock(&g_gpio_config_mutex);
+        return DIS_COMMON_ERR_OK;
+    }
+    
+    /* The monitor reads the rule without locking, so swap it while the rule is stopped */
+    rule_stop(rule);
+    *cur = *cfg;
+    if (cur->term_cnt != 0) {
+        ret = rule_start(rule);
+        if (ret != DIS_COMMON_ERR_OK) {
+            memset(cur, 0, sizeof(*cur));
+        }
+    }
+    
+    pthread_mutex_unlock(&g_gpio_config_mutex);
+    return ret;
+}
+
+uint8_t gpio_int_register_rule_callback(uint8_t rule, gpio_interrupt_rule_callback_t callback, void *arg)
+{
+    if (rule >= GPIO_INT_MAX_RULES) {
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
+    
+    pthread_mutex_lock(&g_gpio_config_mutex);
+    
+    if (!g_gpio_system_initialized) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "GPIO system not initialized\n");
+        pthread_mutex_unlock(&g_gpio_config_mutex);
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    RuleState *st = &g_rule_state[rule];
+    gpio_interrupt_rule_callback_t old = atomic_exchange(&st->callback, NULL);
+    
+    /* A monitor pass that loaded the old callback may still be calling it with the old arg */
+    if (old) {
+        for (uint8_t i = 0; i < g_gpio_monitor_cnt; i++) {
+            wait_monitor_pass(&g_gpio_monitor[i]);
+        }
+    }
+    
+    st->arg = arg;
+    atomic_store_explicit(&st->callback, callback, memory_order_release);
+    
+    pthread_mutex_unlock(&g_gpio_config_mutex);
+    return DIS_COMMON_ERR_OK;
+}
+
+uint8_t gpio_int_system_reload(void)
+{
+    GpioIntCtx new_ctx;
+    uint8_t ret;
+    uint8_t result = DIS_COMMON_ERR_OK;
+    uint16_t changed = 0;
+    
+    memset(&new_ctx, 0, sizeof(new_ctx));
+    
+    pthread_mutex_lock(&g_gpio_config_mutex);
+    
+    if (!g_gpio_system_initialized) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "GPIO system not initialized\n");
+        pthread_mutex_unlock(&g_gpio_config_mutex);
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    ret = gpio_int_ctx_from_db(&new_ctx, GPIOINTERRUPT);
+    if (ret != DIS_COMMON_ERR_OK) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to load GPIO interrupt config from database\n");
+        pthread_mutex_unlock(&g_gpio_config_mutex);
+        return ret;
+    }
+    
+    /* The channel table keeps the size it was started with */
+    if (new_ctx.int_cnt > g_gpio_system_ctx.int_cnt) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Reloaded IntCount %u exceeds running channel count %u\n",
+                         new_ctx.int_cnt, g_gpio_system_ctx.int_cnt);
+        gpio_int_ctx_free(&new_ctx);
+        pthread_mutex_unlock(&g_gpio_config_mutex);
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
+    
+    for (uint16_t i = 0; i < g_gpio_system_ctx.int_cnt; i++) {
+        GpioIntChannel *ch = &g_gpio_system_ctx.ch[i];
+        uint8_t was_enabled = gpio_int_ctx_is_enabled(&g_gpio_system_ctx, i);
+        uint8_t now_enabled = gpio_int_ctx_is_enabled(&new_ctx, i);
+        
+        if (!was_enabled && !now_enabled) {
+            continue;
+        }
+        
+        /* Same pin, shard, class, filter, storm protection and counter mode: only the overflow policy can change, without a restart */
+        if (was_enabled && now_enabled && pin_cfg_equal(&ch->pin_cfg, &new_ctx.ch[i].pin_cfg) &&
+            ch->shard == new_ctx.ch[i].shard && ch->priority == new_ctx.ch[i].priority &&
+            ch->dispatch == new_ctx.ch[i].dispatch && filter_cfg_equal(&ch->filter, &new_ctx.ch[i].filter) &&
+            storm_cfg_equal(&ch->storm, &new_ctx.ch[i].storm) &&
+            counter_cfg_equal(&ch->counter, &new_ctx.ch[i].counter)) {
+            if (ch->overflow_policy != new_ctx.ch[i].overflow_policy) {
+                ch->overflow_policy = new_ctx.ch[i].overflow_policy;
+                atomic_store(&g_channel_queue[i].policy, ch->overflow_policy);
+                changed++;
+            }
+            continue;
+        }
+        
+        if (was_enabled) {
+            channel_tear_down(i);
+        }
+        
+        if (now_enabled) {
+            ch->pin_cfg = new_ctx.ch[i].pin_cfg;
+            ch->overflow_policy = new_ctx.ch[i].overflow_policy;
+            ch->shard = new_ctx.ch[i].shard;
+            ch->priority = new_ctx.ch[i].priority;
+            ch->dispatch = new_ctx.ch[i].dispatch;
+            ch->filter = new_ctx.ch[i].filter;
+            ch->storm = new_ctx.ch[i].storm;
+            ch->counter = new_ctx.ch[i].counter;
+            ret = channel_bring_up(i);
+            if (ret != DIS_COMMON_ERR_OK) {
+                DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to bring up reloaded channel %u\n", i);
+                result = ret;
+            }
+        }
+        
+        changed++;
+    }
+    
+    /* Restart changed rules and rules whose channels moved to another shard */
+    for (uint8_t r = 0; r < GPIO_INT_MAX_RULES; r++) {
+        GpioIntRuleCfg *rule = &g_gpio_system_ctx.rule[r];
+        const RuleState *st = &g_rule_state[r];
+        
+        if (rule_cfg_equal(rule, &new_ctx.rule[r]) &&
+            (!st->started || st->shard == channel_shard(rule->term[0].channel)->index)) {
+            continue;
+        }
+        
+        rule_stop(r);
+        *rule = new_ctx.rule[r];
+        if (rule->term_cnt != 0) {
+            ret = rule_start(r);
+            if (ret != DIS_COMMON_ERR_OK) {
+                DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to start reloaded rule %u\n", r);
+                memset(rule, 0, sizeof(*rule));
+                result = ret;
+            }
+        }
+        
+        changed++;
+    }
+    
+    gpio_int_ctx_free(&new_ctx);
+    pthread_mutex_unlock(&g_gpio_config_mutex);
+    
+    DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 2, "GPIO interrupt configuration reloaded, %u channels or rules changed\n", changed);
+    return result;
+}
+
+/**
+ * @brief Register the plain callback of a channel, narrow or wide
+ * @param channel GPIO interrupt channel number
+ * @param callback Narrow callback, NULL if wide_callback is given or to unregister
+ * @param wide_callback Wide callback, NULL if callback is given or to unregister
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ */
+static uint8_t register_plain_callback(uint16_t channel, gpio_interrupt_callback_t callback,
+                                       gpio_interrupt_wide_callback_t wide_callback)
+{
+    /* Check if GPIO system is initialized */
+    if (!g_gpio_system_initialized) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "GPIO system not initialized\n");
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    /* Check if the channel is valid and enabled */
+    if (channel >= g_gpio_system_ctx.int_cnt) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Channel %u exceeds configured channel count (%u)\n", 
+                         channel, g_gpio_system_ctx.int_cnt);
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
+    
+    if (!gpio_int_ctx_is_enabled(&g_gpio_system_ctx, channel)) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Channel %u is not enabled in configuration\n", channel);
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
+    
+    /* Register the callback, its worker must exist before the monitor can see it */
+    pthread_mutex_lock(&g_gpio_config_mutex);
+    uint8_t ret = (callback || wide_callback) ? prepare_callback_delivery(channel) : DIS_COMMON_ERR_OK;
+    if (ret == DIS_COMMON_ERR_OK) {
+        atomic_store_explicit(&g_channel_hot[channel].callback, callback, memory_order_release);
+        atomic_store_explicit(&g_channel_hot[channel].wide_callback, wide_callback, memory_order_release);
+    }
+    pthread_mutex_unlock(&g_gpio_config_mutex);
+    
+    if (ret != DIS_COMMON_ERR_OK) {
+        return ret;
+    }
+    
+    if (callback != NULL || wide_callback != NULL) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 2, "Registered callback for channel %u (%s)\n", 
+                         channel, g_gpio_system_ctx.ch[channel].pin_cfg.consumer);
+    }
+    
+    return DIS_COMMON_ERR_OK;
+}
+
+uint8_t gpio_int_register_callback(uint8_t channel, gpio_interrupt_callback_t callback)
+{
+    return register_plain_callback(channel, callback, NULL);
+}
+
+uint8_t gpio_int_register_wide_callback(uint16_t channel, gpio_interrupt_wide_callback_t callback)
+{
+    return register_plain_callback(channel, NULL, callback);
+}
+
+uint8_t gpio_int_register_event_callback(uint16_t channel, gpio_interrupt_event_callback_t callback)
+{
+    if (!g_gpio_system_initialized) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "GPIO system not initialized\n");
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    if (channel >= g_gpio_system_ctx.int_cnt || !gpio_int_ctx_is_enabled(&g_gpio_system_ctx, channel)) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Channel %u is not a configured and enabled channel\n", channel);
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
+    
+    pthread_mutex_lock(&g_gpio_config_mutex);
+    uint8_t ret = callback ? prepare_callback_delivery(channel) : DIS_COMMON_ERR_OK;
+    if (ret == DIS_COMMON_ERR_OK) {
+        atomic_store_explicit(&g_channel_hot[channel].event_callback, callback, memory_order_release);
+    }
+    pthread_mutex_unlock(&g_gpio_config_mutex);
+    
+    if (ret != DIS_COMMON_ERR_OK) {
+        return ret;
+    }
+    
+    if (callback != NULL) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 2, "Registered event callback for channel %u (%s)\n", 
+                         channel, g_gpio_system_ctx.ch[channel].pin_cfg.consumer);
+    }
+    
+    return DIS_COMMON_ERR_OK;
+}
+
+int gpio_int_get_event_fd(uint16_t channel)
+{
+    if (!g_gpio_system_initialized) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "GPIO system not initialized\n");
+        return -1;
+    }
     
-    /* Initialize GPIO line */
-    ret = init_gpio_line(cfg, &ctx->line[channel_idx]);
-    if (ret != DIS_COMMON_ERR_OK) {
-        close(ctx->fd[channel_idx]);
-        ctx->fd[channel_idx] = -1;
-        return ret;
+    if (channel >= g_gpio_system_ctx.int_cnt || !gpio_int_ctx_is_enabled(&g_gpio_system_ctx, channel)) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Channel %u is not a configured and enabled channel\n", channel);
+        return -1;
     }
     
-    return DIS_COMMON_ERR_OK;
+    if (atomic_load_explicit(&g_channel_worker[channel].pull, memory_order_acquire)) {
+        return g_channel_worker[channel].wake_fd;
+    }
+    
+    pthread_mutex_lock(&g_gpio_config_mutex);
+    int fd = open_pull_channel(channel);
+    pthread_mutex_unlock(&g_gpio_config_mutex);
+    
+    return fd;
 }
 
-/**
- * @brief GPIO interrupt monitoring thread function
- * @param arg Thread argument (unused)
- * @return void* Thread return value
- */
-static void* gpio_interrupt_monitor_thread(void *arg)
+int gpio_int_wait(uint16_t channel, int timeout_ms, GpioIntEvent *event)
 {
-    (void)arg; 
+    uint64_t deadline_ns = 0;
     
-    struct epoll_event events[MAX_INT_CNT];
-    int icount;
+    if (!event) {
+        return -1;
+    }
     
-    while (g_gpio_monitor_running) {
-        /* Wait for interrupt events */
-        int n = epoll_wait(g_gpio_epoll_fd, events, MAX_INT_CNT, -1);
+    int fd = gpio_int_get_event_fd(channel);
+    if (fd < 0) {
+        return -1;
+    }
+    
+    if (timeout_ms > 0) {
+        deadline_ns = gpio_int_now_ns() + (uint64_t)timeout_ms * 1000000ull;
+    }
+    
+    for (;;) {
+        if (!gpio_int_ctx_is_enabled(&g_gpio_system_ctx, channel)) {
+            return -1;
+        }
         
-        if (n < 0) {
-            if (g_gpio_monitor_running) {
-                DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "epoll_wait failed in GPIO monitor thread\n");
+        if (next_channel_event(channel, event)) {
+            uint64_t now = gpio_int_now_ns();
+            if (now > event->dispatch_ns) {
+                hist_record(&g_channel_stats[channel].dispatch_to_callback, now - event->dispatch_ns);
             }
-            break;
+            return 1;
         }
         
-        /* Process interrupt events */
-        for (int i = 0; i < n; i++) {
-            uint8_t channel = events[i].data.u32;
-            
-            /* Read interrupt count to clear the interrupt */
-            int fd = g_gpio_system_ctx.fd[channel];
-            if (read(fd, &icount, sizeof(icount)) > 0) {
-                /* Call interrupt handler */
-                gpio_interrupt_handler(channel, &g_gpio_system_ctx);
-                
-                /* Re-enable interrupt */
-                int irq_on = 1;
-                if (write(fd, &irq_on, sizeof(irq_on)) != sizeof(irq_on)) {
-                    DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to re-enable IRQ for channel %u\n", channel);
-                }
+        /* Queue drained: reset the fd and go idle, so the next event kicks it again */
+        uint64_t kicks;
+        if (read(fd, &kicks, sizeof(kicks)) < 0 && errno != EAGAIN) {
+            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "Failed to reset event fd of channel %u\n", channel);
+        }
+        uint8_t prev = atomic_exchange_explicit(&g_channel_hot[channel].delivery, CHANNEL_IDLE,
+                                                memory_order_acq_rel);
+        if (prev == CHANNEL_PENDING || event_queue_pending(&g_channel_queue[channel])) {
+            continue;
+        }
+        
+        int wait_ms = timeout_ms;
+        if (timeout_ms > 0) {
+            uint64_t now = gpio_int_now_ns();
+            if (now >= deadline_ns) {
+                return 0;
             }
+            wait_ms = (int)((deadline_ns - now + 999999ull) / 1000000ull);
+        } else if (timeout_ms == 0) {
+            return 0;
+        }
+        
+        struct pollfd pfd = { .fd = fd, .events = POLLIN };
+        if (poll(&pfd, 1, wait_ms) < 0 && errno != EINTR) {
+            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to wait on channel %u: %s\n", channel, strerror(errno));
+            return -1;
         }
     }
-    
-    DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 2, "GPIO interrupt monitor thread stopped\n");
-    return NULL;
-}
-
-/* ========== Public API Functions ========== */
-
-void gpio_int_debug_init(uint8_t enable)
-{
-    setModuleTraceEn(GPIOINTSERVICE, enable);
 }
 
-uint8_t gpio_int_ctx_from_db(GpioIntCtx *ctx, uint32_t db_region)
+uint8_t gpio_int_register_batch_callback(const uint16_t *channels, uint16_t channel_cnt,
+                                         gpio_interrupt_batch_callback_t callback, void *arg,
+                                         uint8_t *handle)
 {
-    if (!ctx) {
+    if (!callback || !handle || (channels && channel_cnt == 0)) {
         return DIS_COMMON_ERR_INV_PARAM;
     }
     
-    /* Initialize database */
-    uint32_t ret = dis_dfe8219_dataBaseInitWithRegion(DFE8219, db_region);
-    if (ret != NO_ERROR) {
-        return DIS_COMMON_ERR_API_FAIL;
-    }
+    pthread_mutex_lock(&g_gpio_config_mutex);
     
-    /* Read interrupt count */
-    char path[64];
-    snprintf(path, sizeof(path), "/GPIOINT/IntCount");
-    ret = dis_dfe8219_dataBaseGetU8(DFE8219, db_region, path, &ctx->int_cnt, 1);
-    if (ret != NO_ERROR) {
+    if (!g_gpio_system_initialized) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "GPIO system not initialized\n");
+        pthread_mutex_unlock(&g_gpio_config_mutex);
         return DIS_COMMON_ERR_API_FAIL;
     }
     
-    if (ctx->int_cnt > MAX_INT_CNT) {
-        return DIS_COMMON_ERR_INV_PARAM;
+    if (channels) {
+        for (uint16_t i = 0; i < channel_cnt; i++) {
+            if (channels[i] >= g_gpio_system_ctx.int_cnt) {
+                DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Channel %u exceeds configured channel count (%u)\n",
+                                 channels[i], g_gpio_system_ctx.int_cnt);
+                pthread_mutex_unlock(&g_gpio_config_mutex);
+                return DIS_COMMON_ERR_INV_PARAM;
+            }
+        }
     }
     
-    /* Read enable list */
-    snprintf(path, sizeof(path), "/GPIOINT/enable_list");
-    ret = dis_dfe8219_dataBaseGetU8(DFE8219, db_region, path, ctx->enable_list, ctx->int_cnt);
-    if (ret != NO_ERROR) {
+    uint8_t free_slots = (uint8_t)~atomic_load(&g_batch_active);
+    if (!free_slots) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "No free batch subscriber slot\n");
+        pthread_mutex_unlock(&g_gpio_config_mutex);
         return DIS_COMMON_ERR_API_FAIL;
     }
     
-    /* Read channel configurations */
-    for (uint8_t i = 0; i < ctx->int_cnt; ++i) {
-        if (ctx->enable_list[i] == 0) {
-            continue; /* Skip disabled channels */
-        }
-        
-        /* Read pin configuration */
-        snprintf(path, sizeof(path), "/GPIOINT/ch%u/pin_cfg", i);
-        ret = dis_dfe8219_dataBaseGetU8(DFE8219, db_region, path, (uint8_t*)&ctx->pin_cfg[i], 3);
-        if (ret != NO_ERROR) {
-            return DIS_COMMON_ERR_API_FAIL;
+    uint8_t sub = (uint8_t)__builtin_ctz(free_slots);
+    uint8_t bit = (uint8_t)(1u << sub);
+    
+    /* Publish the subscriber before any channel can collect events for it */
+    g_batch_subscriber[sub].callback = callback;
+    g_batch_subscriber[sub].arg = arg;
+    atomic_fetch_or(&g_batch_active, bit);
+    
+    if (channels) {
+        for (uint16_t i = 0; i < channel_cnt; i++) {
+            atomic_fetch_or(&g_channel_batch_subs[channels[i]], bit);
         }
-        
-        /* Read consumer string */
-        snprintf(path, sizeof(path), "/GPIOINT/ch%u/consumer", i);
-        ret = dis_dfe8219_dataBaseGet(DFE8219, db_region, path, ctx->pin_cfg[i].consumer);
-        if (ret != NO_ERROR) {
-            return DIS_COMMON_ERR_API_FAIL;
+    } else {
+        for (uint16_t i = 0; i < g_gpio_system_ctx.int_cnt; i++) {
+            atomic_fetch_or(&g_channel_batch_subs[i], bit);
         }
     }
     
+    *handle = sub;
+    pthread_mutex_unlock(&g_gpio_config_mutex);
+    
+    DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 2, "Registered batch callback %u for %u channels\n",
+                     sub, channels ? channel_cnt : g_gpio_system_ctx.int_cnt);
     return DIS_COMMON_ERR_OK;
 }
 
-uint8_t gpio_int_init(GpioIntCtx *ctx)
+uint8_t gpio_int_unregister_batch_callback(uint8_t handle)
 {
-    if (!ctx || ctx->int_cnt == 0 || ctx->int_cnt > MAX_INT_CNT) {
+    if (handle >= GPIO_INT_MAX_BATCH_SUBSCRIBERS) {
         return DIS_COMMON_ERR_INV_PARAM;
     }
     
-    for (uint8_t i = 0; i < ctx->int_cnt; ++i) {
-        if (ctx->enable_list[i] == 0) {
-            /* Mark as uninitialized */
-            ctx->fd[i] = -1;
-            ctx->line[i] = NULL;
-            continue;
-        }
-        
-        uint8_t ret = init_single_channel(ctx, i);
-        if (ret != DIS_COMMON_ERR_OK) {
-            return ret;
-        }
+    uint8_t bit = (uint8_t)(1u << handle);
+    
+    pthread_mutex_lock(&g_gpio_config_mutex);
+    
+    if (!g_gpio_system_initialized || !(atomic_load(&g_batch_active) & bit)) {
+        pthread_mutex_unlock(&g_gpio_config_mutex);
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
+    
+    for (uint16_t i = 0; i < g_gpio_system_ctx.int_cnt; i++) {
+        atomic_fetch_and(&g_channel_batch_subs[i], (uint8_t)~bit);
     }
+    atomic_fetch_and(&g_batch_active, (uint8_t)~bit);
     
+    /* A pass that saw the subscriber may still be calling it */
+    for (uint8_t i = 0; i < g_gpio_monitor_cnt; i++) {
+        wait_monitor_pass(&g_gpio_monitor[i]);
+    }
+    
+    g_batch_subscriber[handle].callback = NULL;
+    g_batch_subscriber[handle].arg = NULL;
+    
+    pthread_mutex_unlock(&g_gpio_config_mutex);
     return DIS_COMMON_ERR_OK;
 }
 
-uint8_t gpio_int_enable_irq(GpioIntCtx *ctx, uint8_t idx)
+uint8_t gpio_int_set_overflow_policy(uint16_t channel, GpioIntOverflowPolicy policy)
 {
-    if (!ctx || idx >= ctx->int_cnt) {
+    if (!g_gpio_system_initialized) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "GPIO system not initialized\n");
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    
+    if (channel >= g_gpio_system_ctx.int_cnt || !gpio_int_ctx_is_enabled(&g_gpio_system_ctx, channel) ||
+        policy > GPIO_INT_OVERFLOW_MERGE) {
         return DIS_COMMON_ERR_INV_PARAM;
     }
     
-    /* Check if channel is enabled */
-    if (ctx->enable_list[idx] == 0) {
+    g_gpio_system_ctx.ch[channel].overflow_policy = (uint8_t)policy;
+    atomic_store(&g_channel_queue[channel].policy, (uint8_t)policy);
+    return DIS_COMMON_ERR_OK;
+}
+
+int gpio_int_get_cached_value(uint16_t channel)
+{
+    GpioIntState state;
+    
+    if (!g_gpio_system_initialized || channel >= g_gpio_system_ctx.int_cnt) {
+        return -1;
+    }
+    
+    state_load(channel, &state);
+    return state.gpio_value;
+}
+
+uint8_t gpio_int_snapshot(GpioIntState *states, uint16_t cnt)
+{
+    if (!states) {
         return DIS_COMMON_ERR_INV_PARAM;
     }
     
-    /* Check if file descriptor is valid */
-    if (ctx->fd[idx] < 0) {
+    if (!g_gpio_system_initialized) {
         return DIS_COMMON_ERR_API_FAIL;
     }
     
-    // /* Clear any pending interrupt */
-    // int count = 0;
-    // read(ctx->fd[idx], &count, sizeof(count));
+    if (cnt < g_gpio_system_ctx.int_cnt) {
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
     
-    /* Enable interrupt */
-    int irq_on = 1;
-    if (write(ctx->fd[idx], &irq_on, sizeof(irq_on)) != sizeof(irq_on)) {
-        return DIS_COMMON_ERR_API_FAIL;
+    for (uint16_t i = 0; i < g_gpio_system_ctx.int_cnt; i++) {
+        state_load(i, &states[i]);
     }
     
     return DIS_COMMON_ERR_OK;
 }
 
-uint8_t gpio_int_deinit(GpioIntCtx *ctx)
+uint8_t gpio_int_get_drop_count(uint16_t channel, uint64_t *drops)
 {
-    if (!ctx) {
+    if (!drops || channel >= g_channel_state_cnt) {
         return DIS_COMMON_ERR_INV_PARAM;
     }
     
-    for (uint8_t i = 0; i < ctx->int_cnt; ++i) {
-        if (ctx->enable_list[i] == 0) {
-            continue; /* Skip disabled channels */
-        }
-        
-        if (ctx->line[i]) {
-            gpiod_line_release(ctx->line[i]);
-            ctx->line[i] = NULL;
-        }
-        
-        if (ctx->fd[i] >= 0) {
-            close(ctx->fd[i]);
-            ctx->fd[i] = -1;
-        }
-    }
-    
-    ctx->int_cnt = 0;
+    *drops = atomic_load_explicit(&g_channel_queue[channel].drop_cnt, memory_order_relaxed);
     return DIS_COMMON_ERR_OK;
 }
 
-void gpio_int_print_info(const GpioIntCtx *ctx)
+uint8_t gpio_int_get_counter(uint16_t channel, GpioIntCounterReport *report)
 {
-    if (!ctx) {
-        return;
+    if (!report || !g_gpio_system_initialized || channel >= g_gpio_system_ctx.int_cnt) {
+        return g_gpio_system_initialized ? DIS_COMMON_ERR_INV_PARAM : DIS_COMMON_ERR_API_FAIL;
     }
     
-    DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 2, "GPIO Interrupt Configuration: %u channels\n", ctx->int_cnt);
+    const ChannelCounter *counter = &g_channel_counter[channel];
+    uint32_t seq;
     
-    for (uint8_t i = 0; i < ctx->int_cnt; i++) {
-        if (ctx->enable_list[i] == 1) {
-            const GpioIntPinCfg *cfg = &ctx->pin_cfg[i];
-            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 2, "  Ch[%u]: group%u.bit%u -> uio%u (%s)\n", 
-                           i, cfg->group_id, cfg->group_bit, cfg->uio_index, cfg->consumer);
-        }
-    }
+    do {
+        seq = atomic_load_explicit(&counter->seq, memory_order_acquire);
+        *report = counter->report;
+        atomic_thread_fence(memory_order_acquire);
+    } while ((seq & 1u) || atomic_load_explicit(&counter->seq, memory_order_relaxed) != seq);
+    
+    return DIS_COMMON_ERR_OK;
 }
 
-uint8_t gpio_int_system_init(void)
+uint8_t gpio_int_trace_start(const char *path, uint32_t capacity)
 {
-    uint8_t ret;
+    if (!path || capacity == 0 || capacity > GPIO_INT_TRACE_MAX_RECORDS) {
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
     
-    if (g_gpio_system_initialized) {
-        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "GPIO interrupt system already initialized\n");
-        return DIS_COMMON_ERR_OK;
+    /* Round up to a power of two so slots are selected with a mask */
+    uint32_t cap = 1;
+    while (cap < capacity) {
+        cap <<= 1;
     }
     
-    /* Initialize channel mutexes */
-    ret = init_channel_mutexes();
-    if (ret != DIS_COMMON_ERR_OK) {
-        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to initialize channel mutexes\n");
-        return ret;
+    pthread_mutex_lock(&g_gpio_config_mutex);
+    
+    if (atomic_load(&g_gpio_trace)) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "GPIO interrupt trace already recording\n");
+        pthread_mutex_unlock(&g_gpio_config_mutex);
+        return DIS_COMMON_ERR_API_FAIL;
     }
     
-    /* Load GPIO interrupt configuration from database */
-    ret = gpio_int_ctx_from_db(&g_gpio_system_ctx, GPIOINTERRUPT);
-    if (ret != DIS_COMMON_ERR_OK) {
-        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to load GPIO interrupt config from database\n");
-        return ret;
+    size_t len = sizeof(GpioIntTraceHeader) + (size_t)cap * sizeof(GpioIntTraceRecord);
+    void *map = MAP_FAILED;
+    
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd >= 0) {
+        if (ftruncate(fd, (off_t)len) == 0) {
+            map = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        close(fd);
     }
     
-    /* Initialize all enabled GPIO interrupt channels */
-    ret = gpio_int_init(&g_gpio_system_ctx);
-    if (ret != DIS_COMMON_ERR_OK) {
-        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to initialize GPIO interrupt channels\n");
-        return ret;
+    if (map == MAP_FAILED) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to create GPIO interrupt trace %s: %s\n", path, strerror(errno));
+        pthread_mutex_unlock(&g_gpio_config_mutex);
+        return DIS_COMMON_ERR_API_FAIL;
     }
     
-    /* Print configuration information */
-    gpio_int_print_info(&g_gpio_system_ctx);
+    GpioIntTraceHeader *trace = map;
+    trace->magic = GPIO_INT_TRACE_MAGIC;
+    trace->version = GPIO_INT_TRACE_VERSION;
+    trace->record_size = sizeof(GpioIntTraceRecord);
+    trace->capacity = cap;
+    trace->head = 0;
     
-    g_gpio_system_initialized = true;
+    g_gpio_trace_len = len;
+    atomic_store_explicit(&g_gpio_trace, trace, memory_order_release);
     
-    /* Start GPIO interrupt monitoring thread */
-    ret = gpio_int_start_monitor_thread();
-    if (ret != DIS_COMMON_ERR_OK) {
-        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to start GPIO interrupt monitor thread\n");
-        g_gpio_system_initialized = false;
-        return ret;
+    pthread_mutex_unlock(&g_gpio_config_mutex);
+    
+    DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 2, "Recording GPIO interrupt trace to %s (%u records)\n", path, cap);
+    return DIS_COMMON_ERR_OK;
+}
+
+uint8_t gpio_int_trace_stop(void)
+{
+    pthread_mutex_lock(&g_gpio_config_mutex);
+    
+    GpioIntTraceHeader *trace = atomic_exchange(&g_gpio_trace, NULL);
+    if (!trace) {
+        pthread_mutex_unlock(&g_gpio_config_mutex);
+        return DIS_COMMON_ERR_OK;
+    }
+    
+    /* Monitors that loaded the pointer before the exchange finish within their pass */
+    for (uint8_t i = 0; i < g_gpio_monitor_cnt; i++) {
+        wait_monitor_pass(&g_gpio_monitor[i]);
     }
     
-    DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 2, "GPIO interrupt system initialized successfully\n");
+    munmap(trace, g_gpio_trace_len);
+    g_gpio_trace_len = 0;
     
+    pthread_mutex_unlock(&g_gpio_config_mutex);
     return DIS_COMMON_ERR_OK;
 }
 
-static uint8_t gpio_int_start_monitor_thread(void)
+uint8_t gpio_int_bus_start(const char *name, uint32_t capacity)
 {
-    if (g_gpio_monitor_running) {
-        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "GPIO monitor thread already running\n");
-        return DIS_COMMON_ERR_OK;
+    if (!name) {
+        name = GPIO_INT_BUS_DEFAULT_NAME;
     }
-        
-    /* Create epoll instance */
-    g_gpio_epoll_fd = epoll_create1(0);
-    if (g_gpio_epoll_fd < 0) {
-        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to create epoll instance\n");
+    if (capacity == 0 || capacity > GPIO_INT_BUS_MAX_SLOTS || strlen(name) >= sizeof(g_gpio_bus_name)) {
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
+    
+    /* Round up to a power of two so slots are selected with a mask */
+    uint32_t cap = 1;
+    while (cap < capacity) {
+        cap <<= 1;
+    }
+    
+    pthread_mutex_lock(&g_gpio_config_mutex);
+    
+    if (atomic_load(&g_gpio_bus)) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "GPIO interrupt bus already published\n");
+        pthread_mutex_unlock(&g_gpio_config_mutex);
         return DIS_COMMON_ERR_API_FAIL;
     }
     
-    struct epoll_event ev;
-    ev.events = EPOLLIN;
+    size_t len = sizeof(GpioIntBusHeader) + (size_t)cap * sizeof(GpioIntBusSlot);
+    void *map = MAP_FAILED;
     
-    /* Add all enabled GPIO interrupt channels to epoll */
-    for (uint8_t i = 0; i < g_gpio_system_ctx.int_cnt; i++) {
-        if (g_gpio_system_ctx.enable_list[i] == 1) {
-            ev.data.u32 = i; /* Store channel number */
-            if (epoll_ctl(g_gpio_epoll_fd, EPOLL_CTL_ADD, g_gpio_system_ctx.fd[i], &ev) != 0) {
-                DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to add channel %u to epoll\n", i);
-                close(g_gpio_epoll_fd);
-                g_gpio_epoll_fd = -1;
-                return DIS_COMMON_ERR_API_FAIL;
-            }
-            
-            /* Enable interrupt for this channel */
-            uint8_t ret = gpio_int_enable_irq(&g_gpio_system_ctx, i);
-            if (ret != DIS_COMMON_ERR_OK) {
-                DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to enable IRQ for channel %u\n", i);
-                close(g_gpio_epoll_fd);
-                g_gpio_epoll_fd = -1;
-                return ret;
-            }
-            
-            DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 2, "Added channel %u (%s) to interrupt monitoring\n", 
-                           i, g_gpio_system_ctx.pin_cfg[i].consumer);
+    /* A fresh object, so subscribers of a previous publisher keep their old mapping */
+    shm_unlink(name);
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0660);
+    if (fd >= 0) {
+        if (ftruncate(fd, (off_t)len) == 0) {
+            map = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
         }
+        close(fd);
     }
     
-    /* Start monitoring thread */
-    g_gpio_monitor_running = true;
-    if (pthread_create(&g_gpio_monitor_thread, NULL, gpio_interrupt_monitor_thread, NULL) != 0) {
-        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to create GPIO monitor thread\n");
-        g_gpio_monitor_running = false;
-        close(g_gpio_epoll_fd);
-        g_gpio_epoll_fd = -1;
+    if (map == MAP_FAILED) {
+        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to create GPIO interrupt bus %s: %s\n", name, strerror(errno));
+        if (fd >= 0) {
+            shm_unlink(name);
+        }
+        pthread_mutex_unlock(&g_gpio_config_mutex);
         return DIS_COMMON_ERR_API_FAIL;
     }
     
+    GpioIntBusHeader *bus = map;
+    bus->magic = GPIO_INT_BUS_MAGIC;
+    bus->version = GPIO_INT_BUS_VERSION;
+    bus->slot_size = sizeof(GpioIntBusSlot);
+    bus->capacity = cap;
+    bus->publisher_pid = (uint32_t)getpid();
+    if (g_gpio_system_initialized) {
+        FOR_EACH_ENABLED_CHANNEL(&g_gpio_system_ctx, i) {
+            memcpy(bus->consumer[i], g_gpio_system_ctx.ch[i].pin_cfg.consumer, sizeof(bus->consumer[i]));
+        }
+    }
+    __atomic_store_n(&bus->active, 1, __ATOMIC_RELEASE);
+    
+    snprintf(g_gpio_bus_name, sizeof(g_gpio_bus_name), "%s", name);
+    g_gpio_bus_len = len;
+    atomic_store_explicit(&g_gpio_bus, bus, memory_order_release);
+    
+    pthread_mutex_unlock(&g_gpio_config_mutex);
+    
+    DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 2, "Publishing GPIO interrupt events on bus %s (%u slots)\n", name, cap);
     return DIS_COMMON_ERR_OK;
 }
 
-static uint8_t gpio_int_stop_monitor_thread(void)
+uint8_t gpio_int_bus_stop(void)
 {
-    if (!g_gpio_monitor_running) {
-        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "GPIO monitor thread not running\n");
+    pthread_mutex_lock(&g_gpio_config_mutex);
+    
+    GpioIntBusHeader *bus = atomic_exchange(&g_gpio_bus, NULL);
+    if (!bus) {
+        pthread_mutex_unlock(&g_gpio_config_mutex);
         return DIS_COMMON_ERR_OK;
     }
     
-    /* Signal thread to stop */
-    g_gpio_monitor_running = false;
+    /* Monitors that loaded the pointer before the exchange finish within their pass */
+    for (uint8_t i = 0; i < g_gpio_monitor_cnt; i++) {
+        wait_monitor_pass(&g_gpio_monitor[i]);
+    }
+    
+    /* Subscribers drain the ring, then gpio_int_bus_read()/wait() report the stop */
+    __atomic_store_n(&bus->active, 0, __ATOMIC_RELEASE);
+    bus_wake(bus);
+    
+    munmap(bus, g_gpio_bus_len);
+    shm_unlink(g_gpio_bus_name);
+    g_gpio_bus_len = 0;
+    
+    pthread_mutex_unlock(&g_gpio_config_mutex);
+    return DIS_COMMON_ERR_OK;
+}
+
+uint8_t gpio_int_read_all(int *values, uint16_t cnt)
+{
+    if (!values) {
+        return DIS_COMMON_ERR_INV_PARAM;
+    }
+    
+    pthread_rwlock_rdlock(&g_gpio_line_lock);
+    
+    GpioIntCtx *ctx = &g_gpio_system_ctx;
+    if (!g_gpio_system_initialized || cnt < ctx->int_cnt) {
+        pthread_rwlock_unlock(&g_gpio_line_lock);
+        return g_gpio_system_initialized ? DIS_COMMON_ERR_INV_PARAM : DIS_COMMON_ERR_API_FAIL;
+    }
     
-    /* Wait for thread to finish */
-    if (pthread_join(g_gpio_monitor_thread, NULL) != 0) {
-        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Failed to join GPIO monitor thread\n");
+    for (uint16_t i = 0; i < cnt; i++) {
+        values[i] = -1;
     }
     
-    /* Close epoll file descriptor */
-    if (g_gpio_epoll_fd >= 0) {
-        close(g_gpio_epoll_fd);
-        g_gpio_epoll_fd = -1;
+    /* Sample line groups in one go, then whatever the backend left out */
+    if (g_gpio_backend->read_all) {
+        g_gpio_backend->read_all(ctx, values);
+    }
+    FOR_EACH_ENABLED_CHANNEL(ctx, i) {
+        if (values[i] < 0) {
+            values[i] = channel_read_value(ctx, (uint16_t)i);
+        }
     }
     
-    DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 2, "GPIO interrupt monitor thread stopped\n");
+    pthread_rwlock_unlock(&g_gpio_line_lock);
     return DIS_COMMON_ERR_OK;
 }
 
-uint8_t gpio_int_register_callback(uint8_t channel, gpio_interrupt_callback_t callback)
+uint8_t gpio_int_get_stats(uint16_t channel, GpioIntStats *stats)
 {
-    /* Check if GPIO system is initialized */
-    if (!g_gpio_system_initialized) {
-        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "GPIO system not initialized\n");
-        return DIS_COMMON_ERR_API_FAIL;
+    if (!stats || channel >= g_channel_state_cnt) {
+        return DIS_COMMON_ERR_INV_PARAM;
     }
     
-    /* Check if the channel is valid and enabled */
-    if (channel >= g_gpio_system_ctx.int_cnt) {
-        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Channel %u exceeds configured channel count (%u)\n", 
-                         channel, g_gpio_system_ctx.int_cnt);
+    ChannelStats *ch_stats = &g_channel_stats[channel];
+    
+    stats->interrupts = atomic_load_explicit(&ch_stats->interrupts, memory_order_relaxed);
+    stats->missed = atomic_load_explicit(&ch_stats->missed, memory_order_relaxed);
+    stats->filtered = atomic_load_explicit(&ch_stats->filtered, memory_order_relaxed);
+    stats->drops = atomic_load_explicit(&g_channel_queue[channel].drop_cnt, memory_order_relaxed);
+    stats->reenable_failures = atomic_load_explicit(&ch_stats->reenable_failures, memory_order_relaxed);
+    stats->storms = atomic_load_explicit(&ch_stats->storms, memory_order_relaxed);
+    stats->storm_polling = atomic_load_explicit(&g_channel_storm[channel].polling, memory_order_relaxed);
+    hist_summarize(&ch_stats->wake_to_dispatch, &stats->wake_to_dispatch);
+    hist_summarize(&ch_stats->dispatch_to_callback, &stats->dispatch_to_callback);
+    hist_summarize(&ch_stats->callback_duration, &stats->callback_duration);
+    
+    return DIS_COMMON_ERR_OK;
+}
+
+uint8_t gpio_int_get_class_stats(uint8_t priority, GpioIntStats *stats)
+{
+    static LatencyHistogram hist[3];
+    
+    if (!stats || priority >= GPIO_INT_PRIO_CNT) {
         return DIS_COMMON_ERR_INV_PARAM;
     }
     
-    if (g_gpio_system_ctx.enable_list[channel] == 0) {
-        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 0, "Channel %u is not enabled in configuration\n", channel);
-        return DIS_COMMON_ERR_INV_PARAM;
+    /* The mutex keeps the channel table stable and serializes use of the merge buffers */
+    pthread_mutex_lock(&g_gpio_config_mutex);
+    
+    memset(stats, 0, sizeof(*stats));
+    for (uint32_t i = 0; i < 3; i++) {
+        hist_reset(&hist[i]);
+    }
+    
+    for (uint16_t i = 0; i < g_channel_state_cnt && i < g_gpio_system_ctx.int_cnt; i++) {
+        if (!gpio_int_ctx_is_enabled(&g_gpio_system_ctx, i) || g_gpio_system_ctx.ch[i].priority != priority) {
+            continue;
+        }
+        
+        ChannelStats *ch_stats = &g_channel_stats[i];
+        
+        stats->interrupts += atomic_load_explicit(&ch_stats->interrupts, memory_order_relaxed);
+        stats->missed += atomic_load_explicit(&ch_stats->missed, memory_order_relaxed);
+        stats->filtered += atomic_load_explicit(&ch_stats->filtered, memory_order_relaxed);
+        stats->drops += atomic_load_explicit(&g_channel_queue[i].drop_cnt, memory_order_relaxed);
+        stats->reenable_failures += atomic_load_explicit(&ch_stats->reenable_failures, memory_order_relaxed);
+        stats->storms += atomic_load_explicit(&ch_stats->storms, memory_order_relaxed);
+        stats->storm_polling += atomic_load_explicit(&g_channel_storm[i].polling, memory_order_relaxed);
+        hist_merge(&hist[0], &ch_stats->wake_to_dispatch);
+        hist_merge(&hist[1], &ch_stats->dispatch_to_callback);
+        hist_merge(&hist[2], &ch_stats->callback_duration);
     }
     
-    /* Register the callback */
-    g_gpio_callbacks[channel] = callback;
+    hist_summarize(&hist[0], &stats->wake_to_dispatch);
+    hist_summarize(&hist[1], &stats->dispatch_to_callback);
+    hist_summarize(&hist[2], &stats->callback_duration);
     
-    if (callback != NULL) {
-        DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 2, "Registered callback for channel %u (%s)\n", 
-                         channel, g_gpio_system_ctx.pin_cfg[channel].consumer);
+    pthread_mutex_unlock(&g_gpio_config_mutex);
+    return DIS_COMMON_ERR_OK;
+}
+
+uint8_t gpio_int_reset_stats(uint16_t channel)
+{
+    if (channel >= g_channel_state_cnt) {
+        return DIS_COMMON_ERR_INV_PARAM;
     }
     
+    ChannelStats *ch_stats = &g_channel_stats[channel];
+    
+    atomic_store_explicit(&ch_stats->interrupts, 0, memory_order_relaxed);
+    atomic_store_explicit(&ch_stats->missed, 0, memory_order_relaxed);
+    atomic_store_explicit(&ch_stats->filtered, 0, memory_order_relaxed);
+    atomic_store_explicit(&ch_stats->reenable_failures, 0, memory_order_relaxed);
+    atomic_store_explicit(&ch_stats->storms, 0, memory_order_relaxed);
+    atomic_store_explicit(&g_channel_queue[channel].drop_cnt, 0, memory_order_relaxed);
+    hist_reset(&ch_stats->wake_to_dispatch);
+    hist_reset(&ch_stats->dispatch_to_callback);
+    hist_reset(&ch_stats->callback_duration);
+    
     return DIS_COMMON_ERR_OK;
 }
 
 uint8_t gpio_int_system_deinit(void)
 {
+    pthread_mutex_lock(&g_gpio_config_mutex);
+    
     if (!g_gpio_system_initialized) {
         DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 1, "GPIO interrupt system not initialized\n");
+        pthread_mutex_unlock(&g_gpio_config_mutex);
         return DIS_COMMON_ERR_OK;
     }
     
-    /* Stop monitoring thread */
-    gpio_int_stop_monitor_thread();
+    /* Stop monitoring threads */
+    gpio_int_stop_monitor_threads();
+    
+    /* Stop callback workers once no more interrupts are dispatched */
+    stop_callback_workers();
     
     /* Deinitialize GPIO context */
     gpio_int_deinit(&g_gpio_system_ctx);
     
-    /* Clear all callbacks */
-    for (uint8_t i = 0; i < MAX_INT_CNT; i++) {
-        g_gpio_callbacks[i] = NULL;
-    }
+    gpio_int_ctx_free(&g_gpio_system_ctx);
+    
+    /* Free callbacks, queues and statistics */
+    cleanup_channel_state();
     
-    /* Cleanup channel mutexes */
-    cleanup_channel_mutexes();
+    atomic_store(&g_batch_active, 0);
+    memset(g_batch_subscriber, 0, sizeof(g_batch_subscriber));
+    memset(g_rule_state, 0, sizeof(g_rule_state));
+    
+    if (g_gpio_memory_locked) {
+        munlockall();
+        g_gpio_memory_locked = false;
+    }
     
     g_gpio_system_initialized = false;
+    pthread_mutex_unlock(&g_gpio_config_mutex);
     
     DEBUG_LOG_SAMPLE(GPIOINTSERVICE, 2, "GPIO interrupt system deinitialized\n");
     return DIS_COMMON_ERR_OK;
@@ -2,13 +2,44 @@
 #define _GPIOINTERRUPT_H_
 
 #include <gpiod.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <sys/epoll.h>
 #include "dis_dfe8219_board.h"
 #include "gpio_pinmux.h"
 
-/* Maximum number of GPIO interrupt channels supported */
-#define MAX_INT_CNT 8
+/* Upper bound on the number of GPIO interrupt channels in one context */
+#define GPIO_INT_MAX_CHANNELS 1024
+
+/* Number of 64-bit words in a channel bitmap for cnt channels */
+#define GPIO_INT_MASK_WORDS(cnt) (((uint32_t)(cnt) + 63u) / 64u)
+
+/* Byte offset in UIO map 0 of the data-in register word holding a pin (GpioIntPinCfg *) */
+#define GPIO_INT_DATAIN_OFFSET(cfg) ((size_t)(cfg)->datain_reg + sizeof(uint32_t) * ((cfg)->group_bit / 32u))
+
+/* Depth of the per-channel event queue (must be a power of two) */
+#define GPIO_INT_QUEUE_DEPTH 64
+
+/* Maximum number of gpiod edge events read per wakeup */
+#define GPIO_INT_EVENT_BATCH 16
+
+/* Maximum number of monitor shards (epoll loops) */
+#define GPIO_INT_MAX_MONITORS 8
+
+/* Maximum number of batch callback subscribers */
+#define GPIO_INT_MAX_BATCH_SUBSCRIBERS 8
+
+/* Maximum number of events handed to a batch callback in one call */
+#define GPIO_INT_BATCH_MAX 256
+
+/* Maximum number of composite event rules (at most 16) */
+#define GPIO_INT_MAX_RULES 16
+
+/* Maximum number of channel terms in one rule */
+#define GPIO_INT_RULE_MAX_TERMS 4
+
+/* Interface version, bumped when a public type changes layout (2: 16-bit channel numbers) */
+#define GPIO_INT_API_VERSION 2
 
 /* ========== Data Structures ========== */
 
@@ -22,6 +53,383 @@
  */
 typedef void (*gpio_interrupt_callback_t)(uint8_t channel, int gpio_value);
 
+/**
+ * @brief GPIO interrupt callback function type for any channel number
+ * @param channel GPIO interrupt channel number
+ * @param gpio_value Current GPIO value (0 or 1)
+ * 
+ * Same as gpio_interrupt_callback_t, for channels beyond 255.
+ */
+typedef void (*gpio_interrupt_wide_callback_t)(uint16_t channel, int gpio_value);
+
+/**
+ * @brief Channel acquisition mode
+ *
+ * Edge mode timestamps are CLOCK_MONOTONIC from Linux 5.7 on. Older kernels
+ * stamp gpiod v1 line events with CLOCK_REALTIME; this is detected at init
+ * and the timestamps are shifted onto CLOCK_MONOTONIC when they are read,
+ * so a realtime clock step between an edge and its read skews that edge.
+ */
+typedef enum {
+    GPIO_INT_MODE_UIO  = 0,     /* UIO interrupt, value read through gpiod after wakeup */
+    GPIO_INT_MODE_EDGE = 1,     /* gpiod edge events with kernel timestamps, no UIO */
+} GpioIntAcqMode;
+
+/**
+ * @brief Edge that raised an event
+ */
+typedef enum {
+    GPIO_INT_EDGE_NONE    = 0,  /* Unknown (UIO mode) */
+    GPIO_INT_EDGE_RISING  = 1,
+    GPIO_INT_EDGE_FALLING = 2,
+} GpioIntEdge;
+
+/**
+ * @brief GPIO interrupt event passed to extended callbacks
+ */
+typedef struct {
+    uint16_t    channel;        /* GPIO interrupt channel number */
+    uint8_t     edge;           /* GpioIntEdge */
+    int         gpio_value;     /* GPIO value (0 or 1) */
+    uint32_t    icount;         /* UIO interrupt count, or edge sequence in edge mode */
+    uint32_t    count;          /* Number of interrupts represented by this event */
+    uint32_t    missed;         /* UIO interrupts coalesced without their own wakeup (0 in edge mode) */
+    uint64_t    timestamp_ns;   /* CLOCK_MONOTONIC time: kernel edge time or UIO wakeup */
+    uint64_t    dispatch_ns;    /* CLOCK_MONOTONIC time the event was queued for delivery */
+} GpioIntEvent;
+
+/**
+ * @brief Last known state of a channel, see gpio_int_snapshot()
+ */
+typedef struct {
+    int         gpio_value;     /* Latest GPIO value (0 or 1), -1 if unknown or the channel is disabled */
+    uint8_t     edge;           /* GpioIntEdge of the latest event */
+    uint64_t    timestamp_ns;   /* CLOCK_MONOTONIC time of the latest event, 0 before the first one */
+    uint64_t    seq;            /* Events seen since the channel was brought up */
+} GpioIntState;
+
+/* Trace record flags */
+#define GPIO_INT_TRACE_DROPPED      0x01    /* Queue full, event dropped (QUEUE policy) */
+#define GPIO_INT_TRACE_FOLDED       0x02    /* Queue full, event folded into the overflow slot */
+#define GPIO_INT_TRACE_UNQUEUED     0x04    /* No per-channel callback, batch subscribers only */
+
+#define GPIO_INT_TRACE_MAGIC        0x47495454u     /* "TTIG" */
+#define GPIO_INT_TRACE_VERSION      1
+
+/**
+ * @brief Header at the start of a trace file
+ *
+ * The records follow the header as a ring of capacity entries. Record n of
+ * the trace lives in slot n % capacity and carries seq n + 1 once complete.
+ */
+typedef struct {
+    uint32_t    magic;          /* GPIO_INT_TRACE_MAGIC */
+    uint16_t    version;        /* GPIO_INT_TRACE_VERSION */
+    uint16_t    record_size;    /* sizeof(GpioIntTraceRecord) */
+    uint32_t    capacity;       /* Records in the ring (power of two) */
+    uint32_t    reserved;
+    uint64_t    head;           /* Records written so far, updated atomically */
+    uint8_t     pad[40];        /* Records start on a cache line */
+} GpioIntTraceHeader;
+
+/**
+ * @brief Fixed-size binary trace record of one dispatched event
+ */
+typedef struct {
+    uint64_t    timestamp_ns;   /* GpioIntEvent.timestamp_ns */
+    uint32_t    icount;         /* GpioIntEvent.icount */
+    uint32_t    missed;         /* GpioIntEvent.missed */
+    uint32_t    latency_ns;     /* Wakeup to dispatch, saturated at UINT32_MAX */
+    uint32_t    seq;            /* Record number + 1, written last */
+    uint16_t    channel;        /* GPIO interrupt channel number */
+    uint8_t     gpio_value;     /* GPIO value (0 or 1) */
+    uint8_t     edge;           /* GpioIntEdge */
+    uint8_t     flags;          /* GPIO_INT_TRACE_* flags */
+    uint8_t     reserved[3];
+} GpioIntTraceRecord;
+
+/**
+ * @brief Extended GPIO interrupt callback function type
+ * @param event Interrupt event, valid only for the duration of the call
+ * 
+ * Receives the edge type, timestamp and merge count in addition to the
+ * value passed to gpio_interrupt_callback_t.
+ */
+typedef void (*gpio_interrupt_event_callback_t)(const GpioIntEvent *event);
+
+/**
+ * @brief Batch GPIO interrupt callback function type
+ * @param events Events collected from one epoll_wait() return, in arrival order
+ * @param count Number of events
+ * @param arg User argument given at registration
+ * 
+ * Runs on the monitor thread of the shard that collected the events, so it
+ * must not block. The event array is only valid for the duration of the call.
+ */
+typedef void (*gpio_interrupt_batch_callback_t)(const GpioIntEvent *events, uint32_t count, void *arg);
+
+/**
+ * @brief Interrupt storm transition callback function type
+ * @param channel GPIO interrupt channel number
+ * @param storm 1 when the channel switched to storm polling, 0 when it returned to interrupts
+ * @param rate Interrupts per second measured over the window that caused the switch
+ *
+ * Called on the monitor thread servicing the channel, must not block.
+ */
+typedef void (*gpio_interrupt_storm_callback_t)(uint16_t channel, uint8_t storm, uint32_t rate);
+
+/**
+ * @brief Aggregated report of one counter mode window, see GpioIntCounterCfg
+ */
+typedef struct {
+    uint16_t    channel;        /* GPIO interrupt channel number */
+    int         gpio_value;     /* Level at the end of the window, -1 if unknown */
+    uint32_t    edges;          /* Interrupts (UIO icount delta) or edges in the window */
+    uint32_t    rate;           /* Edges per second over the window */
+    uint32_t    periods;        /* Rising-to-rising periods measured */
+    uint16_t    duty_permille;  /* Share of high time in the time with a known level */
+    uint64_t    start_ns;       /* CLOCK_MONOTONIC start of the window */
+    uint64_t    end_ns;         /* CLOCK_MONOTONIC end of the window, 0 before the first report */
+    uint64_t    high_ns;        /* Time spent high */
+    uint64_t    low_ns;         /* Time spent low */
+    uint64_t    min_period_ns;  /* Shortest period measured, 0 if none */
+    uint64_t    max_period_ns;  /* Longest period measured, 0 if none */
+} GpioIntCounterReport;
+
+/**
+ * @brief Counter mode report callback function type
+ * @param report Report of the window just closed, valid only for the duration of the call
+ * @param arg User argument given at registration
+ *
+ * Called on the monitor thread servicing the channel, must not block.
+ */
+typedef void (*gpio_interrupt_counter_callback_t)(const GpioIntCounterReport *report, void *arg);
+
+/**
+ * @brief Match of a composite event rule
+ */
+typedef struct {
+    uint8_t     rule;           /* Rule index */
+    uint8_t     op;             /* GpioIntRuleOp */
+    uint16_t    channel;        /* Channel whose event made the condition true */
+    uint64_t    first_ns;       /* Timestamp of the earliest term assertion taking part in the match */
+    uint64_t    timestamp_ns;   /* Timestamp of the event that made the condition true */
+    uint64_t    match_ns;       /* CLOCK_MONOTONIC time of the match, after hold_us for held rules */
+    uint64_t    matches;        /* Matches since the rule was installed, this one included */
+} GpioIntRuleEvent;
+
+/**
+ * @brief Composite event rule callback function type
+ * @param event Rule match, valid only for the duration of the call
+ * @param arg User argument given at registration
+ *
+ * Called on the monitor thread evaluating the rule, must not block.
+ */
+typedef void (*gpio_interrupt_rule_callback_t)(const GpioIntRuleEvent *event, void *arg);
+
+/**
+ * @brief Per-channel event queue overflow policy
+ *
+ * Selects how events are handed to the callback when interrupts arrive
+ * faster than the callback consumes them.
+ */
+typedef enum {
+    GPIO_INT_OVERFLOW_QUEUE  = 0,   /* Deliver every event, count drops when the queue is full */
+    GPIO_INT_OVERFLOW_LATEST = 1,   /* Deliver only the latest pending value */
+    GPIO_INT_OVERFLOW_MERGE  = 2,   /* Merge pending events into one, keep the latest value */
+} GpioIntOverflowPolicy;
+
+/**
+ * @brief Latency distribution summary in nanoseconds
+ */
+typedef struct {
+    uint64_t    count;          /* Number of samples */
+    uint64_t    p50_ns;         /* Median */
+    uint64_t    p99_ns;         /* 99th percentile */
+    uint64_t    p999_ns;        /* 99.9th percentile */
+    uint64_t    max_ns;         /* Largest sample */
+} GpioIntLatency;
+
+/**
+ * @brief Per-channel interrupt statistics
+ *
+ * Percentiles come from log-linear histograms and are reported as the upper
+ * bound of their bucket (within 12.5% of the true value).
+ */
+typedef struct {
+    uint64_t        interrupts;             /* Interrupts handled by the monitor thread */
+    uint64_t        missed;                 /* UIO interrupts coalesced into other wakeups (icount gaps) */
+    uint64_t        filtered;               /* Interrupts absorbed by the glitch filter */
+    uint64_t        drops;                  /* Events dropped or superseded in the queue */
+    uint64_t        reenable_failures;      /* Failed IRQ re-enable writes */
+    uint64_t        storms;                 /* Switches to storm polling */
+    uint8_t         storm_polling;          /* 1 while the channel is storm polling (per class: channels) */
+    GpioIntLatency  wake_to_dispatch;       /* Monitor wakeup (or kernel edge) to event queued */
+    GpioIntLatency  dispatch_to_callback;   /* Event queued to callback start, or to gpio_int_wait() return */
+    GpioIntLatency  callback_duration;      /* Callback execution time */
+} GpioIntStats;
+
+/**
+ * @brief Scheduling policy of the monitor and callback worker threads
+ */
+typedef enum {
+    GPIO_INT_SCHED_OTHER = 0,   /* Default time-sharing scheduling */
+    GPIO_INT_SCHED_FIFO  = 1,   /* SCHED_FIFO real-time scheduling */
+    GPIO_INT_SCHED_RR    = 2,   /* SCHED_RR real-time scheduling */
+} GpioIntSchedPolicy;
+
+/**
+ * @brief Dispatch priority class of a channel
+ */
+typedef enum {
+    GPIO_INT_PRIO_NORMAL   = 0, /* Served in the order the kernel reports it */
+    GPIO_INT_PRIO_CRITICAL = 1, /* Served before normal channels of the same wakeup */
+} GpioIntPriority;
+
+/* Number of priority classes */
+#define GPIO_INT_PRIO_CNT 2
+
+/**
+ * @brief Where the callbacks of a critical channel run
+ */
+typedef enum {
+    GPIO_INT_DISPATCH_WORKER = 0,   /* Channel worker, at GpioIntRtCfg.critical_priority */
+    GPIO_INT_DISPATCH_INLINE = 1,   /* Monitor thread, before it serves the next channel */
+} GpioIntDispatch;
+
+/**
+ * @brief Event loop run by each monitor shard
+ */
+typedef enum {
+    GPIO_INT_LOOP_EPOLL    = 0, /* epoll_wait, then read and re-enable each UIO fd */
+    GPIO_INT_LOOP_IO_URING = 1, /* Posted UIO reads and batched re-enable writes on io_uring,
+                                 * needs a build with GPIO_INT_USE_IO_URING */
+} GpioIntMonitorLoop;
+
+/* CPU value that leaves a thread unpinned */
+#define GPIO_INT_CPU_ANY (-1)
+
+/**
+ * @brief Real-time configuration of the interrupt threads
+ *
+ * Applied when the system starts. Thread settings the process is not
+ * permitted to use are logged and the thread falls back to default
+ * attributes.
+ */
+typedef struct {
+    uint8_t     sched_policy;       /* GpioIntSchedPolicy */
+    uint8_t     monitor_priority;   /* Monitor thread priority for FIFO/RR */
+    uint8_t     worker_priority;    /* Callback worker priority for FIFO/RR */
+    int16_t     monitor_cpu;        /* CPU of monitor shard 0, shard n uses monitor_cpu + n; GPIO_INT_CPU_ANY for none */
+    int16_t     worker_cpu;         /* CPU the callback workers are pinned to, GPIO_INT_CPU_ANY for none */
+    uint8_t     lock_memory;        /* mlockall() and prefault thread stacks */
+    uint32_t    busy_poll_us;       /* Spin on the interrupt fds this long before sleeping, 0=off */
+    uint8_t     monitor_shards;     /* Number of monitor loops (1..GPIO_INT_MAX_MONITORS, 0 means 1) */
+    uint8_t     shard_by_group;     /* 1=map channels to shards by GPIO group, 0=use GpioIntChannel.shard */
+    uint8_t     monitor_loop;       /* GpioIntMonitorLoop, falls back to epoll when unavailable */
+    uint8_t     critical_priority;  /* Worker priority of critical channels, FIFO even under
+                                     * GPIO_INT_SCHED_OTHER; 0 uses worker_priority and sched_policy */
+} GpioIntRtCfg;
+
+/**
+ * @brief Edge direction passed by a channel filter
+ */
+typedef enum {
+    GPIO_INT_FILTER_BOTH    = 0,    /* Pass rising and falling transitions */
+    GPIO_INT_FILTER_RISING  = 1,    /* Pass rising transitions only */
+    GPIO_INT_FILTER_FALLING = 2,    /* Pass falling transitions only */
+} GpioIntEdgeFilter;
+
+/**
+ * @brief Per-channel glitch filter configuration
+ *
+ * With debounce_us or min_pulse_us set, interrupts only arm a timer and the
+ * line is sampled when it expires; a transition is reported only if the line
+ * then differs from the last reported level. All zero disables filtering.
+ */
+typedef struct {
+    uint32_t    debounce_us;    /* Line must be quiet this long after the last edge */
+    uint32_t    min_pulse_us;   /* Line must hold the new level this long after the first edge */
+    uint8_t     edge_filter;    /* GpioIntEdgeFilter */
+} GpioIntFilterCfg;
+
+/* Storm protection defaults for a zero window_us or poll_us */
+#define GPIO_INT_STORM_WINDOW_US    100000
+#define GPIO_INT_STORM_POLL_US      10000
+
+/**
+ * @brief Per-channel interrupt storm protection
+ *
+ * A channel that interrupts more than max_rate times per second within a
+ * window stops re-arming its interrupt after each wakeup. A timer re-arms it
+ * at most once every poll_us instead, so a stuck or oscillating line costs a
+ * bounded number of wakeups. Edge mode channels keep counting edges while
+ * polling and return to interrupt mode after a window whose rate fell below
+ * max_rate / 2; they stay polling while a poll finds a full
+ * GPIO_INT_EVENT_BATCH, since the kernel may have dropped edges beyond it.
+ * A masked UIO interrupt is disabled and not counted, so UIO channels
+ * return after a window in which the line did not fire at all. The poll
+ * rate must stay below max_rate; max_rate 0 disables storm protection.
+ */
+typedef struct {
+    uint32_t    max_rate;       /* Interrupts per second that start polling, 0=off */
+    uint32_t    window_us;      /* Measurement window, 0 for GPIO_INT_STORM_WINDOW_US */
+    uint32_t    poll_us;        /* Re-arm period while polling, 0 for GPIO_INT_STORM_POLL_US */
+} GpioIntStormCfg;
+
+/* Shortest counter mode window */
+#define GPIO_INT_COUNTER_MIN_WINDOW_US  1000
+
+/**
+ * @brief Per-channel counter mode
+ *
+ * A counter channel dispatches no events. The monitor thread counts its
+ * interrupts, high and low time and rising-to-rising periods, and reports
+ * them once per window. Edge mode measures every edge at its kernel
+ * timestamp; UIO mode samples the level at each wakeup, and periods are
+ * only measured between wakeups that did not coalesce interrupts. The
+ * glitch filter does not apply, and the state cache is updated once per
+ * window. window_us 0 disables counter mode.
+ */
+typedef struct {
+    uint32_t    window_us;      /* Report period, 0=off, at least GPIO_INT_COUNTER_MIN_WINDOW_US */
+} GpioIntCounterCfg;
+
+/**
+ * @brief Combination applied to the terms of a rule
+ */
+typedef enum {
+    GPIO_INT_RULE_AND = 0,  /* All terms asserted, the latest within window_us of the earliest */
+    GPIO_INT_RULE_OR  = 1,  /* At least one term asserted */
+    GPIO_INT_RULE_SEQ = 2,  /* Terms asserted in order, the last within window_us of the first */
+} GpioIntRuleOp;
+
+/**
+ * @brief One channel condition of a rule
+ */
+typedef struct {
+    uint16_t    channel;        /* GPIO interrupt channel number */
+    uint8_t     level;          /* Asserted level (0 or 1) */
+} GpioIntRuleTerm;
+
+/**
+ * @brief Composite event rule
+ *
+ * Evaluated by the monitor thread on the filtered channel states, as seen
+ * by gpio_int_snapshot(). A rule matches when its condition becomes true,
+ * or once it has stayed true for hold_us, and matches again only after the
+ * condition dropped. A SEQ condition stays true while its last term is
+ * asserted. All term channels must be serviced by the same monitor shard.
+ * term_cnt 0 marks an unused rule.
+ */
+typedef struct {
+    uint8_t         op;             /* GpioIntRuleOp */
+    uint8_t         term_cnt;       /* Number of terms (0..GPIO_INT_RULE_MAX_TERMS) */
+    GpioIntRuleTerm term[GPIO_INT_RULE_MAX_TERMS];
+    uint32_t        window_us;      /* AND/SEQ: maximum spread of the assertions, 0=unlimited */
+    uint32_t        hold_us;        /* Condition must stay true this long before matching, 0=match at once */
+} GpioIntRuleCfg;
+
 /**
  * @brief GPIO interrupt pin configuration
  */
@@ -30,21 +438,114 @@ typedef struct {
     uint8_t  group_bit;      /* GPIO bit number within the group */
     uint8_t  uio_index;      /* UIO device index for /dev/uio<uio_index> */
     char     consumer[16];   /* gpiod consumer identifier string */
+    uint8_t  mode;           /* GpioIntAcqMode */
+    uint8_t  datain_mmio;    /* 1=read the value from UIO map 0, 0=through gpiod */
+    uint16_t datain_reg;     /* Byte offset of the group's first 32-bit data-in register in map 0,
+                              * the line is bit group_bit % 32 of word group_bit / 32 */
 } GpioIntPinCfg;
 
+/**
+ * @brief GPIO interrupt channel table entry
+ */
+typedef struct {
+    GpioIntPinCfg       pin_cfg;            /* Pin configuration */
+    uint8_t             overflow_policy;    /* GpioIntOverflowPolicy */
+    uint8_t             shard;              /* Monitor shard (modulo monitor_shards) unless shard_by_group */
+    uint8_t             priority;           /* GpioIntPriority */
+    uint8_t             dispatch;           /* GpioIntDispatch of a critical channel */
+    GpioIntFilterCfg    filter;             /* Glitch filter applied before dispatch */
+    GpioIntStormCfg     storm;              /* Interrupt storm protection */
+    GpioIntCounterCfg   counter;            /* Counter mode instead of per-edge dispatch */
+    int                 fd;                 /* UIO file descriptor (-1 in edge mode) */
+    struct gpiod_line   *line;              /* gpiod line handle */
+    volatile uint32_t   *datain;            /* Mapped data-in register word, NULL to read through gpiod */
+    void                *regs;              /* Register mapping owned by the backend */
+    size_t              regs_len;           /* Length of the register mapping */
+} GpioIntChannel;
+
 /**
  * @brief GPIO interrupt context structure
+ *
+ * The channel table and enable bitmap are sized to int_cnt at runtime, see
+ * gpio_int_ctx_alloc().
  */
 typedef struct {
-    uint8_t             int_cnt;                    /* Number of interrupt channels */
-    uint8_t             enable_list[MAX_INT_CNT];   /* Enable list: 1=init, 0=skip */
-    GpioIntPinCfg       pin_cfg[MAX_INT_CNT];      /* Pin configuration array */
-    int                 fd[MAX_INT_CNT];           /* UIO file descriptors */
-    struct gpiod_line   *line[MAX_INT_CNT];        /* gpiod line handles */
+    uint16_t            int_cnt;        /* Number of interrupt channels */
+    uint64_t            *enable_mask;   /* Enable bitmap: bit set=init, clear=skip */
+    GpioIntChannel      *ch;            /* Channel table, int_cnt entries */
+    GpioIntRuleCfg      rule[GPIO_INT_MAX_RULES];   /* Composite event rules */
 } GpioIntCtx;
 
 extern GpioIntCtx g_gpio_system_ctx;
 
+/* Compile-time channel table, generated from gpioIntService.txt by gpioIntTableGen.py */
+extern const uint16_t g_gpio_int_static_cnt;
+extern const uint64_t g_gpio_int_static_enable[];
+extern const GpioIntChannel g_gpio_int_static_ch[];
+extern const GpioIntRuleCfg g_gpio_int_static_rule[GPIO_INT_MAX_RULES];
+
+/**
+ * @brief GPIO interrupt I/O backend operations
+ *
+ * All device access of the interrupt system goes through this table so the
+ * monitor thread, dispatch and shutdown can run against a simulated backend
+ * on any Linux host. Every operation acts on one channel of the context.
+ */
+typedef struct {
+    const char *name;                                                   /* Backend name for logging */
+    uint8_t (*init_irq)(GpioIntCtx *ctx, uint16_t channel);              /* Open interrupt source, set ch[].fd
+                                                                           * and map ch[].regs if datain_mmio */
+    uint8_t (*init_line)(GpioIntCtx *ctx, uint16_t channel);             /* Pinmux and request GPIO line */
+    void    (*release)(GpioIntCtx *ctx, uint16_t channel);               /* Release line and interrupt source */
+    int     (*read_irq)(GpioIntCtx *ctx, uint16_t channel, uint32_t *icount); /* Clear IRQ, >0 on success */
+    int     (*enable_irq)(GpioIntCtx *ctx, uint16_t channel);            /* Re-arm IRQ, 0 on success */
+    int     (*get_value)(GpioIntCtx *ctx, uint16_t channel);             /* Read line value, <0 on failure */
+    int     (*get_event_fd)(GpioIntCtx *ctx, uint16_t channel);          /* Pollable fd in edge mode */
+    int     (*read_events)(GpioIntCtx *ctx, uint16_t channel,
+                           GpioIntEvent *events, unsigned int max);     /* Read edge events, count or <0 */
+    uint8_t (*init_lines)(GpioIntCtx *ctx);                              /* Optional: request the lines of all
+                                                                           * enabled channels up front */
+    void    (*read_all)(GpioIntCtx *ctx, int *values);                   /* Optional: sample several lines at
+                                                                           * once, values[] left <0 if not read */
+    uint8_t raw_uio_fd;                                                  /* ch[].fd speaks the UIO read/write
+                                                                           * protocol, needed by the io_uring loop */
+} GpioIntBackendOps;
+
+/* Hardware backend: /dev/uioN, gpiod and board pinmux */
+extern const GpioIntBackendOps g_gpio_int_hw_backend;
+
+/**
+ * @brief Allocate the channel table and enable bitmap of a context
+ * @param ctx Context to set up
+ * @param int_cnt Number of channels (1..GPIO_INT_MAX_CHANNELS)
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * All channels start disabled with fd -1 and no line, and no rule is set.
+ */
+uint8_t gpio_int_ctx_alloc(GpioIntCtx *ctx, uint16_t int_cnt);
+
+/**
+ * @brief Free the channel table and enable bitmap of a context
+ * @param ctx Context to release
+ */
+void gpio_int_ctx_free(GpioIntCtx *ctx);
+
+/**
+ * @brief Enable or disable a channel in a context's enable bitmap
+ * @param ctx Context pointer
+ * @param channel Channel index
+ * @param enable 1=enable, 0=disable
+ */
+void gpio_int_ctx_set_enabled(GpioIntCtx *ctx, uint16_t channel, uint8_t enable);
+
+/**
+ * @brief Check whether a channel is enabled in a context
+ * @param ctx Context pointer
+ * @param channel Channel index
+ * @return uint8_t 1 if the channel exists and is enabled, 0 otherwise
+ */
+uint8_t gpio_int_ctx_is_enabled(const GpioIntCtx *ctx, uint16_t channel);
+
 /**
  * @brief Initialize GPIO interrupt module debug logging
  * @param enable Enable debug logging (1=enable, 0=disable)
@@ -60,6 +561,92 @@ void gpio_int_debug_init(uint8_t enable);
  */
 uint8_t gpio_int_system_init(void);
 
+/**
+ * @brief Select the I/O backend used by the GPIO interrupt system
+ * @param ops Backend operation table (NULL selects the hardware backend)
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * Must be called before gpio_int_system_init().
+ */
+uint8_t gpio_int_set_backend(const GpioIntBackendOps *ops);
+
+/**
+ * @brief Set the real-time configuration of the interrupt threads
+ * @param cfg Real-time configuration (NULL restores the defaults)
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * Must be called before the system is initialized. gpio_int_system_init()
+ * overrides the fields whose /GPIOINT/rt/ database key is present.
+ */
+uint8_t gpio_int_set_rt_config(const GpioIntRtCfg *cfg);
+
+/**
+ * @brief Initialize GPIO interrupt system from a caller-provided configuration
+ * @param cfg Configuration (int_cnt, enable_mask and the pin_cfg and
+ *            overflow_policy of each channel)
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * Same as gpio_int_system_init() without reading the database. The
+ * configuration is copied, the caller keeps ownership of cfg.
+ */
+uint8_t gpio_int_system_init_with_ctx(const GpioIntCtx *cfg);
+
+/**
+ * @brief Initialize GPIO interrupt system from the compiled-in channel table
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * Arms monitoring without waiting for the database, for the cold-boot path.
+ * The table comes from gpioIntTable.c. Real-time settings come only from
+ * gpio_int_set_rt_config(). Call gpio_int_system_reload() once the database
+ * is up to apply its overrides.
+ */
+uint8_t gpio_int_system_init_static(void);
+
+/**
+ * @brief Configure and start a channel while the system is running
+ * @param channel GPIO interrupt channel number (below the configured count)
+ * @param cfg Pin configuration of the channel
+ * @param policy Event queue overflow policy
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ *
+ * The channel must not be enabled. Other channels keep delivering interrupts
+ * while it is brought up.
+ */
+uint8_t gpio_int_channel_add(uint16_t channel, const GpioIntPinCfg *cfg, GpioIntOverflowPolicy policy);
+
+/**
+ * @brief Stop a channel and forget its configuration and callbacks
+ * @param channel GPIO interrupt channel number
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ *
+ * Returns once the monitor thread no longer references the channel. Events
+ * still queued for the channel are discarded. Filter, storm and counter mode
+ * settings and the counter callback are forgotten as well. A pulled channel
+ * leaves pull delivery and its event fd is closed.
+ */
+uint8_t gpio_int_channel_remove(uint16_t channel);
+
+/**
+ * @brief Enable or disable a configured channel while the system is running
+ * @param channel GPIO interrupt channel number
+ * @param enable 1=enable, 0=disable
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ *
+ * Disabling releases the interrupt source but keeps the configuration and
+ * registered callbacks, so re-enabling resumes delivery.
+ */
+uint8_t gpio_int_channel_set_enabled(uint16_t channel, uint8_t enable);
+
+/**
+ * @brief Reload the /GPIOINT configuration from the database
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ *
+ * Only channels whose enable state, pin configuration or mode changed are
+ * restarted; an overflow policy change is applied in place. IntCount may not
+ * grow beyond the channel count the system was started with.
+ */
+uint8_t gpio_int_system_reload(void);
+
 /**
  * @brief Register GPIO interrupt callback function for specific channel
  * @param channel GPIO interrupt channel number
@@ -72,6 +659,300 @@ uint8_t gpio_int_system_init(void);
  */
 uint8_t gpio_int_register_callback(uint8_t channel, gpio_interrupt_callback_t callback);
 
+/**
+ * @brief Register GPIO interrupt callback function for any channel number
+ * @param channel GPIO interrupt channel number
+ * @param callback Callback function pointer (NULL to unregister)
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * As gpio_int_register_callback(), for channels beyond 255. A channel has one
+ * such callback: registering through either function replaces the other.
+ */
+uint8_t gpio_int_register_wide_callback(uint16_t channel, gpio_interrupt_wide_callback_t callback);
+
+/**
+ * @brief Register extended GPIO interrupt callback for specific channel
+ * @param channel GPIO interrupt channel number
+ * @param callback Callback function pointer (NULL to unregister)
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * Takes precedence over a callback registered with gpio_int_register_callback()
+ * or gpio_int_register_wide_callback().
+ * In GPIO_INT_MODE_EDGE channels the event carries the kernel timestamp and
+ * the edge type of every edge read from gpiod.
+ */
+uint8_t gpio_int_register_event_callback(uint16_t channel, gpio_interrupt_event_callback_t callback);
+
+/**
+ * @brief Get a pollable fd that is readable while events of a channel are pending
+ * @param channel GPIO interrupt channel number
+ * @return int Event fd, -1 on failure
+ * 
+ * Switches the channel to pull delivery: events are queued for
+ * gpio_int_wait() and no callback worker thread is created. The fd stays
+ * readable until gpio_int_wait(channel, 0, ...) returns 0, so add it to an
+ * epoll set level-triggered and drain the channel on each wakeup. A pulled
+ * channel cannot take callbacks and stays pulled, with the same fd, until
+ * gpio_int_channel_remove() or gpio_int_system_deinit(). Do not read or
+ * close the fd.
+ */
+int gpio_int_get_event_fd(uint16_t channel);
+
+/**
+ * @brief Take the next event of a pulled channel, waiting for one if needed
+ * @param channel GPIO interrupt channel number
+ * @param timeout_ms Timeout in milliseconds, 0 to poll, < 0 to wait forever
+ * @param event Output event
+ * @return int 1 if an event was returned, 0 on timeout, -1 on error or once the channel is disabled
+ * 
+ * Switches the channel to pull delivery like gpio_int_get_event_fd(). The
+ * overflow policy applies as for callbacks: LATEST and MERGE return all
+ * pending events collapsed into one. Only one thread may consume a channel.
+ */
+int gpio_int_wait(uint16_t channel, int timeout_ms, GpioIntEvent *event);
+
+/**
+ * @brief Register a callback receiving all events of one monitor wakeup at once
+ * @param channels Channels to subscribe to (NULL subscribes to every channel)
+ * @param channel_cnt Number of entries in channels
+ * @param callback Batch callback function
+ * @param arg User argument passed to the callback
+ * @param handle Output: subscription handle for gpio_int_unregister_batch_callback()
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * Events of all subscribed channels that fire within one epoll_wait() return
+ * are delivered in one call, up to GPIO_INT_BATCH_MAX per call. Per-channel
+ * callbacks registered on the same channels are still invoked.
+ */
+uint8_t gpio_int_register_batch_callback(const uint16_t *channels, uint16_t channel_cnt,
+                                         gpio_interrupt_batch_callback_t callback, void *arg,
+                                         uint8_t *handle);
+
+/**
+ * @brief Remove a batch callback subscription
+ * @param handle Handle returned by gpio_int_register_batch_callback()
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * Returns once the callback is no longer running on any monitor thread.
+ */
+uint8_t gpio_int_unregister_batch_callback(uint8_t handle);
+
+/**
+ * @brief Select the event queue overflow policy for a channel
+ * @param channel GPIO interrupt channel number
+ * @param policy Overflow policy to apply
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * The default policy is loaded from /GPIOINT/chN/overflow_policy and falls
+ * back to GPIO_INT_OVERFLOW_QUEUE when the key is absent. Events folded
+ * under LATEST or MERGE are delivered after the queued ones and before any
+ * newer event, so the last event delivered always carries the latest value,
+ * also across a policy change.
+ */
+uint8_t gpio_int_set_overflow_policy(uint16_t channel, GpioIntOverflowPolicy policy);
+
+/**
+ * @brief Set the glitch filter of a channel
+ * @param channel GPIO interrupt channel number
+ * @param filter Filter configuration (NULL disables filtering)
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * The defaults are loaded from /GPIOINT/chN/debounce_ms, min_pulse_us and
+ * edge_filter. An enabled channel is restarted to apply the new filter.
+ */
+uint8_t gpio_int_set_filter(uint16_t channel, const GpioIntFilterCfg *filter);
+
+/**
+ * @brief Set the interrupt storm protection of a channel
+ * @param channel GPIO interrupt channel number
+ * @param storm Storm protection configuration (NULL disables it)
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * The defaults are loaded from /GPIOINT/chN/storm_rate, storm_window_ms and
+ * storm_poll_ms. An enabled channel is restarted to apply the new settings.
+ */
+uint8_t gpio_int_set_storm(uint16_t channel, const GpioIntStormCfg *storm);
+
+/**
+ * @brief Register the callback notified of interrupt storm transitions
+ * @param callback Callback function pointer (NULL to unregister)
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * One callback serves all channels. Transitions are also counted in
+ * GpioIntStats.storms. Returns once a replaced callback is no longer
+ * running on any monitor thread.
+ */
+uint8_t gpio_int_register_storm_callback(gpio_interrupt_storm_callback_t callback);
+
+/**
+ * @brief Set the counter mode of a channel
+ * @param channel GPIO interrupt channel number
+ * @param counter Counter mode configuration (NULL returns to per-edge dispatch)
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * The default is loaded from /GPIOINT/chN/counter_window_ms. An enabled
+ * channel is restarted to apply the new settings.
+ */
+uint8_t gpio_int_set_counter(uint16_t channel, const GpioIntCounterCfg *counter);
+
+/**
+ * @brief Register the callback notified of the window reports of a counter channel
+ * @param channel GPIO interrupt channel number
+ * @param callback Callback function pointer (NULL to unregister)
+ * @param arg User argument passed to the callback
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * Stays registered while the channel is down or not in counter mode.
+ * Returns once a replaced callback is no longer running on any monitor
+ * thread.
+ */
+uint8_t gpio_int_register_counter_callback(uint16_t channel, gpio_interrupt_counter_callback_t callback, void *arg);
+
+/**
+ * @brief Get the report of the last window closed on a counter channel
+ * @param channel GPIO interrupt channel number
+ * @param report Output report, end_ns 0 before the first window closed
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * Lock-free, may be called from any thread including callbacks. The report
+ * is kept when the channel leaves counter mode or is taken down.
+ */
+uint8_t gpio_int_get_counter(uint16_t channel, GpioIntCounterReport *report);
+
+/**
+ * @brief Set or remove a composite event rule
+ * @param rule Rule index (below GPIO_INT_MAX_RULES)
+ * @param cfg Rule configuration (NULL removes the rule)
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * The defaults are loaded from /GPIOINT/RuleCount and /GPIOINT/ruleN/op,
+ * term_cnt, terms (channel, level pairs), window_us and hold_ms. Terms
+ * already asserted when the rule is set do not match until they drop. On
+ * failure the rule is left removed. A registered callback is kept.
+ */
+uint8_t gpio_int_set_rule(uint8_t rule, const GpioIntRuleCfg *cfg);
+
+/**
+ * @brief Register the callback notified of the matches of a rule
+ * @param rule Rule index (below GPIO_INT_MAX_RULES)
+ * @param callback Callback function pointer (NULL to unregister)
+ * @param arg User argument passed to the callback
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * Matches are delivered only to this callback, so channels whose edges are
+ * only of interest in combination need no per-channel callback. Returns
+ * once a replaced callback is no longer running on any monitor thread.
+ */
+uint8_t gpio_int_register_rule_callback(uint8_t rule, gpio_interrupt_rule_callback_t callback, void *arg);
+
+/**
+ * @brief Start recording dispatched events to a binary trace file
+ * @param path Trace file, created or truncated
+ * @param capacity Number of records kept, rounded up to a power of two
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * The file is a GpioIntTraceHeader followed by a ring of GpioIntTraceRecord
+ * mapped shared, so the monitor threads only copy a record per event and the
+ * trace survives a crash of the process. Replay it with gpioIntReplay.
+ */
+uint8_t gpio_int_trace_start(const char *path, uint32_t capacity);
+
+/**
+ * @brief Stop recording and unmap the trace file
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ */
+uint8_t gpio_int_trace_stop(void);
+
+/**
+ * @brief Start publishing dispatched events on a cross-process shared memory bus
+ * @param name Shared memory object name (NULL for GPIO_INT_BUS_DEFAULT_NAME)
+ * @param capacity Number of event slots, rounded up to a power of two
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * Other processes consume the events with the subscriber API in gpioIntBus.h
+ * instead of opening the UIO devices themselves. The monitor threads write
+ * each event into a seqlock slot and wake sleeping subscribers once per pass.
+ */
+uint8_t gpio_int_bus_start(const char *name, uint32_t capacity);
+
+/**
+ * @brief Stop publishing, mark the bus inactive and remove the shared memory object
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ */
+uint8_t gpio_int_bus_stop(void);
+
+/**
+ * @brief Read a snapshot of the line values of all enabled channels
+ * @param values Output array indexed by channel, -1 for disabled or unreadable channels
+ * @param cnt Number of entries in values, at least the configured channel count
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * UIO mode channels on the same gpiochip with the same consumer are requested
+ * together at startup and sampled with a single ioctl, so their values are
+ * coherent. Channels added or restarted at runtime are read one by one.
+ */
+uint8_t gpio_int_read_all(int *values, uint16_t cnt);
+
+/**
+ * @brief Get the last known value of a channel without touching the hardware
+ * @param channel GPIO interrupt channel number
+ * @return int GPIO value (0 or 1), -1 if unknown or the channel is disabled
+ * 
+ * The value is read when the channel is brought up and updated by the
+ * monitor thread on every event, after filtering. No lock or syscall is
+ * taken, so this is cheap enough to poll from hot paths.
+ */
+int gpio_int_get_cached_value(uint16_t channel);
+
+/**
+ * @brief Copy the last known state of all channels without touching the hardware
+ * @param states Output array indexed by channel
+ * @param cnt Number of entries in states, at least the configured channel count
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * Each entry is consistent in itself, but entries are read one after the
+ * other: use gpio_int_read_all() for coherent values across channels.
+ */
+uint8_t gpio_int_snapshot(GpioIntState *states, uint16_t cnt);
+
+/**
+ * @brief Get the number of events dropped on a channel
+ * @param channel GPIO interrupt channel number
+ * @param drops Output: events dropped or superseded since initialization
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * With GPIO_INT_OVERFLOW_QUEUE an event is dropped when the queue is full.
+ * With GPIO_INT_OVERFLOW_LATEST every superseded value counts as a drop.
+ * GPIO_INT_OVERFLOW_MERGE never drops.
+ */
+uint8_t gpio_int_get_drop_count(uint16_t channel, uint64_t *drops);
+
+/**
+ * @brief Get interrupt counters and latency percentiles of a channel
+ * @param channel GPIO interrupt channel number
+ * @param stats Output statistics
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ * 
+ * Reading does not stop recording, so the counters of a busy channel may be
+ * a few samples apart from each other.
+ */
+uint8_t gpio_int_get_stats(uint16_t channel, GpioIntStats *stats);
+
+/**
+ * @brief Get interrupt counters and latency percentiles of a priority class
+ * @param priority GpioIntPriority
+ * @param stats Output statistics, summed over the enabled channels of the class
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ */
+uint8_t gpio_int_get_class_stats(uint8_t priority, GpioIntStats *stats);
+
+/**
+ * @brief Reset interrupt counters and latency histograms of a channel
+ * @param channel GPIO interrupt channel number
+ * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
+ */
+uint8_t gpio_int_reset_stats(uint16_t channel);
+
 /**
  * @brief Deinitialize complete GPIO interrupt system
  * @return uint8_t DIS_COMMON_ERR_OK on success, error code on failure
@@ -0,0 +1,114 @@
+/*
+ * Per-interrupt cost against the number of configured channels.
+ *
+ *   make -C tests bench && tests/build/bench_channels [rounds]
+ *
+ * Starts the sim backend with a growing channel table, every channel
+ * enabled, and ping-pongs interrupts on the last channel: inject, then spin
+ * until its callback ran. The round trip and the monitor's wake-to-dispatch
+ * latency should stay flat as the table grows, since the monitor only
+ * touches the channels epoll reports ready.
+ */
+#include <stdlib.h>
+#include <sys/resource.h>
+#include "test_util.h"
+
+#define DEFAULT_ROUNDS  20000
+
+static const uint16_t g_channel_cnt[] = { 4, 64, 256, 1024 };
+
+static _Atomic uint64_t g_calls = 0;
+
+static void probe_callback(uint16_t channel, int gpio_value)
+{
+    (void)channel;
+    (void)gpio_value;
+
+    atomic_fetch_add_explicit(&g_calls, 1, memory_order_release);
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Measure the interrupt round trip with cnt channels configured
+ * @param cnt Number of channels
+ * @param rounds Interrupts to measure
+ * @param samples Scratch buffer of rounds entries
+ * @return int 0 on success, -1 if the system did not start
+ */
+static int bench_channels(uint16_t cnt, int rounds, uint64_t *samples)
+{
+    GpioIntCtx ctx;
+    GpioIntStats stats;
+    uint16_t probe = (uint16_t)(cnt - 1);
+
+    test_ctx_init(&ctx, cnt, GPIO_INT_MODE_UIO);
+    if (test_start(&ctx) != DIS_COMMON_ERR_OK ||
+        gpio_int_register_wide_callback(probe, probe_callback) != DIS_COMMON_ERR_OK) {
+        gpio_int_system_deinit();
+        return -1;
+    }
+
+    for (int i = 0; i < rounds; i++) {
+        uint64_t calls = atomic_load_explicit(&g_calls, memory_order_acquire);
+
+        while (gpio_int_sim_busy(probe)) {
+        }
+        uint64_t start = test_now_ns();
+        gpio_int_sim_inject(probe, i & 1);
+        while (atomic_load_explicit(&g_calls, memory_order_acquire) == calls) {
+        }
+        samples[i] = test_now_ns() - start;
+    }
+
+    gpio_int_get_stats(probe, &stats);
+    gpio_int_system_deinit();
+
+    qsort(samples, (size_t)rounds, sizeof(*samples), cmp_u64);
+    printf("%8u %12llu %12llu %12llu %12llu\n", cnt,
+           (unsigned long long)samples[rounds / 2],
+           (unsigned long long)samples[(uint64_t)rounds * 99 / 100],
+           (unsigned long long)stats.wake_to_dispatch.p50_ns,
+           (unsigned long long)stats.wake_to_dispatch.p99_ns);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int rounds = (argc > 1) ? atoi(argv[1]) : DEFAULT_ROUNDS;
+    struct rlimit nofile;
+
+    if (rounds <= 0) {
+        fprintf(stderr, "usage: %s [rounds]\n", argv[0]);
+        return 1;
+    }
+
+    /* Every simulated channel holds a few fds */
+    if (getrlimit(RLIMIT_NOFILE, &nofile) == 0) {
+        nofile.rlim_cur = nofile.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &nofile);
+    }
+
+    uint64_t *samples = malloc((size_t)rounds * sizeof(*samples));
+    if (!samples) {
+        return 1;
+    }
+
+    printf("%8s %12s %12s %12s %12s\n", "channels", "rtt p50 ns", "rtt p99 ns", "wake p50 ns", "wake p99 ns");
+    for (size_t i = 0; i < sizeof(g_channel_cnt) / sizeof(g_channel_cnt[0]); i++) {
+        if (bench_channels(g_channel_cnt[i], rounds, samples) != 0) {
+            fprintf(stderr, "Failed to start %u channels\n", g_channel_cnt[i]);
+            free(samples);
+            return 1;
+        }
+    }
+
+    free(samples);
+    return 0;
+}
@@ -0,0 +1,247 @@
+/*
+ * UIO interrupt round trip: epoll monitor loop against the io_uring loop.
+ *
+ *   make -C tests bench URING=1 && tests/build/bench_uring [rounds]
+ *
+ * The io_uring loop reads and writes ch[].fd itself, so the sim backend
+ * (no raw UIO fds) cannot drive it. This benchmark installs a backend whose
+ * UIO fds are SOCK_SEQPACKET socketpairs speaking the UIO protocol: the
+ * device end sends a 4-byte icount to raise an interrupt, the service
+ * re-enables it by writing a 4-byte 1 back. A device thread ping-pongs
+ * interrupts over the channels, one at a time, and times each raise until
+ * the re-enable arrives. Also reported is the CPU time the service spent
+ * per interrupt. Without URING=1 the library is built without
+ * GPIO_INT_USE_IO_URING and only the epoll loop is measured.
+ */
+#include <stdlib.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include "test_util.h"
+
+#define CHANNELS        4
+#define DEFAULT_ROUNDS  20000
+
+/* Device end of the UIO stand-in of each channel */
+static int g_device_fd[CHANNELS];
+static uint32_t g_icount[CHANNELS];
+
+/**
+ * @brief Open the UIO stand-in of a channel
+ */
+static uint8_t bench_init_irq(GpioIntCtx *ctx, uint16_t channel)
+{
+    int sv[2];
+
+    if (channel >= CHANNELS || socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sv) != 0) {
+        return DIS_COMMON_ERR_API_FAIL;
+    }
+    ctx->ch[channel].fd = sv[0];
+    g_device_fd[channel] = sv[1];
+    g_icount[channel] = 0;
+    return DIS_COMMON_ERR_OK;
+}
+
+static uint8_t bench_init_line(GpioIntCtx *ctx, uint16_t channel)
+{
+    (void)ctx;
+    (void)channel;
+
+    return DIS_COMMON_ERR_OK;
+}
+
+static void bench_release(GpioIntCtx *ctx, uint16_t channel)
+{
+    if (ctx->ch[channel].fd >= 0) {
+        close(ctx->ch[channel].fd);
+        ctx->ch[channel].fd = -1;
+    }
+    close(g_device_fd[channel]);
+    g_device_fd[channel] = -1;
+}
+
+static int bench_read_irq(GpioIntCtx *ctx, uint16_t channel, uint32_t *icount)
+{
+    return (int)read(ctx->ch[channel].fd, icount, sizeof(*icount));
+}
+
+static int bench_enable_irq(GpioIntCtx *ctx, uint16_t channel)
+{
+    int irq_on = 1;
+
+    return (write(ctx->ch[channel].fd, &irq_on, sizeof(irq_on)) == sizeof(irq_on)) ? 0 : -1;
+}
+
+static int bench_get_value(GpioIntCtx *ctx, uint16_t channel)
+{
+    (void)ctx;
+
+    return (int)(__atomic_load_n(&g_icount[channel], __ATOMIC_RELAXED) & 1u);
+}
+
+static int bench_get_event_fd(GpioIntCtx *ctx, uint16_t channel)
+{
+    (void)ctx;
+    (void)channel;
+
+    return -1;
+}
+
+static int bench_read_events(GpioIntCtx *ctx, uint16_t channel, GpioIntEvent *events, unsigned int max)
+{
+    (void)ctx;
+    (void)channel;
+    (void)events;
+    (void)max;
+
+    return -1;
+}
+
+static const GpioIntBackendOps g_bench_backend = {
+    .name         = "bench",
+    .init_irq     = bench_init_irq,
+    .init_line    = bench_init_line,
+    .release      = bench_release,
+    .read_irq     = bench_read_irq,
+    .enable_irq   = bench_enable_irq,
+    .get_value    = bench_get_value,
+    .get_event_fd = bench_get_event_fd,
+    .read_events  = bench_read_events,
+    .raw_uio_fd   = 1,
+};
+
+typedef struct {
+    int         rounds;
+    uint64_t    *samples;       /* Round trip of each interrupt */
+    uint64_t    cpu_ns;         /* CPU time of the device thread */
+    int         failed;
+} DeviceRun;
+
+/**
+ * @brief Wait for the service to re-enable the interrupt of a channel
+ * @return int 0 on success, -1 on failure
+ */
+static int device_wait_enable(uint16_t channel)
+{
+    int irq_on;
+
+    return (read(g_device_fd[channel], &irq_on, sizeof(irq_on)) == sizeof(irq_on)) ? 0 : -1;
+}
+
+static void *device_thread(void *arg)
+{
+    DeviceRun *run = arg;
+    struct timespec cpu;
+
+    /* Channel bring-up enabled every interrupt once */
+    for (uint16_t ch = 0; ch < CHANNELS; ch++) {
+        run->failed |= device_wait_enable(ch);
+    }
+
+    for (int i = 0; i < run->rounds && !run->failed; i++) {
+        uint16_t ch = (uint16_t)(i % CHANNELS);
+        uint32_t icount = __atomic_add_fetch(&g_icount[ch], 1, __ATOMIC_RELAXED);
+
+        uint64_t start = test_now_ns();
+        if (write(g_device_fd[ch], &icount, sizeof(icount)) != sizeof(icount)) {
+            run->failed = -1;
+            break;
+        }
+        run->failed |= device_wait_enable(ch);
+        run->samples[i] = test_now_ns() - start;
+    }
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+    run->cpu_ns = (uint64_t)cpu.tv_sec * 1000000000ull + (uint64_t)cpu.tv_nsec;
+    return NULL;
+}
+
+static uint64_t process_cpu_ns(void)
+{
+    struct timespec cpu;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu);
+    return (uint64_t)cpu.tv_sec * 1000000000ull + (uint64_t)cpu.tv_nsec;
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Run the ping-pong on one monitor loop and print the result
+ * @param loop GpioIntMonitorLoop
+ * @param run Device run with rounds and samples set
+ * @return int 0 on success, -1 on failure
+ */
+static int bench_loop(uint8_t loop, DeviceRun *run)
+{
+    GpioIntRtCfg rt = {
+        .monitor_cpu = GPIO_INT_CPU_ANY,
+        .worker_cpu = GPIO_INT_CPU_ANY,
+        .monitor_loop = loop,
+    };
+    GpioIntCtx ctx;
+    pthread_t device;
+
+    test_ctx_init(&ctx, CHANNELS, GPIO_INT_MODE_UIO);
+    gpio_int_set_backend(&g_bench_backend);
+    if (gpio_int_set_rt_config(&rt) != DIS_COMMON_ERR_OK ||
+        gpio_int_system_init_with_ctx(&ctx) != DIS_COMMON_ERR_OK) {
+        gpio_int_ctx_free(&ctx);
+        return -1;
+    }
+    gpio_int_ctx_free(&ctx);
+
+    run->failed = 0;
+    uint64_t cpu_start = process_cpu_ns();
+    pthread_create(&device, NULL, device_thread, run);
+    pthread_join(device, NULL);
+    uint64_t cpu_ns = process_cpu_ns() - cpu_start - run->cpu_ns;
+
+    gpio_int_system_deinit();
+    if (run->failed) {
+        return -1;
+    }
+
+    qsort(run->samples, (size_t)run->rounds, sizeof(*run->samples), cmp_u64);
+    printf("%-8s %12llu %12llu %14llu\n", (loop == GPIO_INT_LOOP_IO_URING) ? "io_uring" : "epoll",
+           (unsigned long long)run->samples[run->rounds / 2],
+           (unsigned long long)run->samples[(uint64_t)run->rounds * 99 / 100],
+           (unsigned long long)(cpu_ns / (uint64_t)run->rounds));
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    DeviceRun run = { .rounds = (argc > 1) ? atoi(argv[1]) : DEFAULT_ROUNDS };
+
+    if (run.rounds <= 0) {
+        fprintf(stderr, "usage: %s [rounds]\n", argv[0]);
+        return 1;
+    }
+    run.samples = malloc((size_t)run.rounds * sizeof(*run.samples));
+    if (!run.samples) {
+        return 1;
+    }
+
+    printf("%d channels, %d rounds\n", CHANNELS, run.rounds);
+    printf("%-8s %12s %12s %14s\n", "loop", "rtt p50 ns", "rtt p99 ns", "service cpu ns");
+    int ret = bench_loop(GPIO_INT_LOOP_EPOLL, &run);
+#ifdef GPIO_INT_USE_IO_URING
+    if (ret == 0) {
+        ret = bench_loop(GPIO_INT_LOOP_IO_URING, &run);
+    }
+#else
+    printf("io_uring skipped, build with URING=1\n");
+#endif
+
+    if (ret != 0) {
+        fprintf(stderr, "Benchmark run failed\n");
+    }
+    free(run.samples);
+    return ret ? 1 : 0;
+}
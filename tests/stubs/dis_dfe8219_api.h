@@ -0,0 +1,5 @@
+/* Host build stand-in for the DFE8219 SDK, see tests/Makefile */
+#ifndef _DIS_DFE8219_API_H_
+#define _DIS_DFE8219_API_H_
+
+#endif
@@ -0,0 +1,11 @@
+/* Host build stand-in for the DFE8219 SDK, see tests/Makefile */
+#ifndef _DIS_DFE8219_BOARD_H_
+#define _DIS_DFE8219_BOARD_H_
+
+#include <stdint.h>
+
+#define DIS_COMMON_ERR_OK           0
+#define DIS_COMMON_ERR_INV_PARAM    1
+#define DIS_COMMON_ERR_API_FAIL     2
+
+#endif
@@ -0,0 +1,16 @@
+/* Host build stand-in for the DFE8219 SDK, see tests/Makefile */
+#ifndef _DIS_DFE8219_DATABASE_H_
+#define _DIS_DFE8219_DATABASE_H_
+
+#include <stdint.h>
+
+#define DFE8219         0
+#define GPIOINTERRUPT   1
+#define NO_ERROR        0
+
+/* The host build has no database, every lookup fails */
+uint32_t dis_dfe8219_dataBaseInitWithRegion(uint32_t dev, uint32_t region);
+uint32_t dis_dfe8219_dataBaseGetU8(uint32_t dev, uint32_t region, const char *path, uint8_t *value, uint32_t len);
+uint32_t dis_dfe8219_dataBaseGet(uint32_t dev, uint32_t region, const char *path, void *value);
+
+#endif
@@ -0,0 +1,16 @@
+/* Host build stand-in for the DFE8219 SDK, see tests/Makefile */
+#ifndef _DIS_DFE8219_LOG_H_
+#define _DIS_DFE8219_LOG_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define GPIOINTSERVICE  7
+
+void setModuleTraceEn(int module, int enable);
+
+/* Errors (level 0) go to stderr when GPIO_INT_TEST_LOG is set, the tests trigger many on purpose */
+#define DEBUG_LOG_SAMPLE(module, level, ...) \
+    do { if ((level) == 0 && getenv("GPIO_INT_TEST_LOG")) fprintf(stderr, __VA_ARGS__); } while (0)
+
+#endif
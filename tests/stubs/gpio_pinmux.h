@@ -0,0 +1,9 @@
+/* Host build stand-in for the DFE8219 SDK, see tests/Makefile */
+#ifndef _GPIO_PINMUX_H_
+#define _GPIO_PINMUX_H_
+
+#include <stdint.h>
+
+int gpio_setPinmux(uint8_t group, uint8_t bit, uint8_t mode);
+
+#endif
@@ -0,0 +1,49 @@
+/* Host build stand-in for libgpiod v1, see tests/Makefile */
+#ifndef _GPIOD_H_
+#define _GPIOD_H_
+
+#include <time.h>
+
+#define GPIOD_LINE_BULK_MAX_LINES 64
+
+struct gpiod_chip;
+struct gpiod_line;
+
+struct gpiod_line_bulk {
+    struct gpiod_line *lines[GPIOD_LINE_BULK_MAX_LINES];
+    unsigned int num_lines;
+};
+
+enum {
+    GPIOD_LINE_EVENT_RISING_EDGE = 1,
+    GPIOD_LINE_EVENT_FALLING_EDGE,
+};
+
+struct gpiod_line_event {
+    struct timespec ts;
+    int event_type;
+};
+
+static inline void gpiod_line_bulk_init(struct gpiod_line_bulk *bulk)
+{
+    bulk->num_lines = 0;
+}
+
+static inline void gpiod_line_bulk_add(struct gpiod_line_bulk *bulk, struct gpiod_line *line)
+{
+    bulk->lines[bulk->num_lines++] = line;
+}
+
+struct gpiod_chip *gpiod_chip_open_by_name(const char *name);
+void gpiod_chip_close(struct gpiod_chip *chip);
+struct gpiod_line *gpiod_chip_get_line(struct gpiod_chip *chip, unsigned int offset);
+int gpiod_line_request_input(struct gpiod_line *line, const char *consumer);
+int gpiod_line_request_bulk_input(struct gpiod_line_bulk *bulk, const char *consumer);
+int gpiod_line_request_both_edges_events(struct gpiod_line *line, const char *consumer);
+int gpiod_line_get_value(struct gpiod_line *line);
+int gpiod_line_get_value_bulk(struct gpiod_line_bulk *bulk, int *values);
+void gpiod_line_release(struct gpiod_line *line);
+int gpiod_line_event_get_fd(struct gpiod_line *line);
+int gpiod_line_event_read_multiple(struct gpiod_line *line, struct gpiod_line_event *events, unsigned int num_events);
+
+#endif
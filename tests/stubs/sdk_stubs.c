@@ -0,0 +1,119 @@
+/* Host build stand-in for the DFE8219 SDK and libgpiod, see tests/Makefile */
+#include <stddef.h>
+#include <stdint.h>
+#include "dis_dfe8219_dataBase.h"
+#include "dis_dfe8219_log.h"
+#include "gpio_pinmux.h"
+#include "gpiod.h"
+
+uint32_t dis_dfe8219_dataBaseInitWithRegion(uint32_t dev, uint32_t region)
+{
+    (void)dev;
+    (void)region;
+    return 1;
+}
+
+uint32_t dis_dfe8219_dataBaseGetU8(uint32_t dev, uint32_t region, const char *path, uint8_t *value, uint32_t len)
+{
+    (void)dev;
+    (void)region;
+    (void)path;
+    (void)value;
+    (void)len;
+    return 1;
+}
+
+uint32_t dis_dfe8219_dataBaseGet(uint32_t dev, uint32_t region, const char *path, void *value)
+{
+    (void)dev;
+    (void)region;
+    (void)path;
+    (void)value;
+    return 1;
+}
+
+void setModuleTraceEn(int module, int enable)
+{
+    (void)module;
+    (void)enable;
+}
+
+int gpio_setPinmux(uint8_t group, uint8_t bit, uint8_t mode)
+{
+    (void)group;
+    (void)bit;
+    (void)mode;
+    return 0;
+}
+
+/* The hardware backend is never selected on the host, all gpiod calls fail */
+struct gpiod_chip *gpiod_chip_open_by_name(const char *name)
+{
+    (void)name;
+    return NULL;
+}
+
+void gpiod_chip_close(struct gpiod_chip *chip)
+{
+    (void)chip;
+}
+
+struct gpiod_line *gpiod_chip_get_line(struct gpiod_chip *chip, unsigned int offset)
+{
+    (void)chip;
+    (void)offset;
+    return NULL;
+}
+
+int gpiod_line_request_input(struct gpiod_line *line, const char *consumer)
+{
+    (void)line;
+    (void)consumer;
+    return -1;
+}
+
+int gpiod_line_request_bulk_input(struct gpiod_line_bulk *bulk, const char *consumer)
+{
+    (void)bulk;
+    (void)consumer;
+    return -1;
+}
+
+int gpiod_line_request_both_edges_events(struct gpiod_line *line, const char *consumer)
+{
+    (void)line;
+    (void)consumer;
+    return -1;
+}
+
+int gpiod_line_get_value(struct gpiod_line *line)
+{
+    (void)line;
+    return -1;
+}
+
+int gpiod_line_get_value_bulk(struct gpiod_line_bulk *bulk, int *values)
+{
+    (void)bulk;
+    (void)values;
+    return -1;
+}
+
+void gpiod_line_release(struct gpiod_line *line)
+{
+    (void)line;
+}
+
+int gpiod_line_event_get_fd(struct gpiod_line *line)
+{
+    (void)line;
+    return -1;
+}
+
+int gpiod_line_event_read_multiple(struct gpiod_line *line, struct gpiod_line_event *events, unsigned int num_events)
+{
+    (void)line;
+    (void)events;
+    (void)num_events;
+    return -1;
+}
@@ -0,0 +1,129 @@
+/*
+ * Runtime channel add/remove while every channel is interrupting.
+ *
+ * A driver thread keeps raising UIO interrupts on all channels while the
+ * main thread repeatedly removes and re-adds one of them. The other
+ * channels must keep delivering, and the removed channel must never call
+ * back once gpio_int_channel_remove() returned.
+ */
+#include <pthread.h>
+#include "test_util.h"
+
+#define CH_CNT      4
+#define CH_CYCLED   1
+
+/* Remove/add cycles of the cycled channel */
+#define CYCLES      50
+
+static _Atomic bool g_driving = true;
+static _Atomic bool g_removed = false;
+static _Atomic uint64_t g_calls[CH_CNT];
+static _Atomic uint64_t g_late_calls = 0;
+
+/**
+ * @brief Count deliveries, flagging any that reach a removed channel
+ */
+static void count_callback(uint16_t channel, int gpio_value)
+{
+    (void)gpio_value;
+
+    if (channel == CH_CYCLED && atomic_load(&g_removed)) {
+        atomic_fetch_add(&g_late_calls, 1);
+    }
+    atomic_fetch_add(&g_calls[channel], 1);
+}
+
+/**
+ * @brief Raise interrupts on every channel until g_driving is cleared
+ */
+static void *driver_thread(void *arg)
+{
+    int value = 0;
+    (void)arg;
+
+    while (atomic_load(&g_driving)) {
+        value = !value;
+        for (uint16_t ch = 0; ch < CH_CNT; ch++) {
+            /* Fails while the cycled channel is down */
+            gpio_int_sim_inject(ch, value);
+        }
+        usleep(50);
+    }
+    return NULL;
+}
+
+static void test_remove_add_under_load(void)
+{
+    GpioIntPinCfg cfg = {
+        .group_bit = CH_CYCLED,
+        .uio_index = CH_CYCLED,
+        .consumer = "test1",
+        .mode = GPIO_INT_MODE_UIO,
+    };
+    pthread_t driver;
+
+    for (uint16_t ch = 0; ch < CH_CNT; ch++) {
+        TEST_CHECK(gpio_int_register_wide_callback(ch, count_callback) == DIS_COMMON_ERR_OK);
+    }
+    TEST_CHECK(pthread_create(&driver, NULL, driver_thread, NULL) == 0);
+
+    for (int i = 0; i < CYCLES; i++) {
+        uint64_t others = atomic_load(&g_calls[0]);
+        uint64_t cycled = atomic_load(&g_calls[CH_CYCLED]);
+
+        /* The cycled channel delivers while it is up */
+        TEST_CHECK(TEST_WAIT(atomic_load(&g_calls[CH_CYCLED]) > cycled, TEST_TIMEOUT_MS));
+
+        TEST_CHECK(gpio_int_channel_remove(CH_CYCLED) == DIS_COMMON_ERR_OK);
+        atomic_store(&g_removed, true);
+        TEST_CHECK(gpio_int_get_cached_value(CH_CYCLED) < 0);
+        TEST_CHECK(gpio_int_register_wide_callback(CH_CYCLED, count_callback) != DIS_COMMON_ERR_OK);
+        usleep(1000);
+
+        /* The other channels are serviced throughout */
+        TEST_CHECK(TEST_WAIT(atomic_load(&g_calls[0]) > others, TEST_TIMEOUT_MS));
+
+        atomic_store(&g_removed, false);
+        TEST_CHECK(gpio_int_channel_add(CH_CYCLED, &cfg, GPIO_INT_OVERFLOW_QUEUE) == DIS_COMMON_ERR_OK);
+        TEST_CHECK(gpio_int_channel_add(CH_CYCLED, &cfg, GPIO_INT_OVERFLOW_QUEUE) != DIS_COMMON_ERR_OK);
+
+        /* Removal forgot the registration */
+        TEST_CHECK(gpio_int_register_wide_callback(CH_CYCLED, count_callback) == DIS_COMMON_ERR_OK);
+    }
+
+    atomic_store(&g_driving, false);
+    pthread_join(driver, NULL);
+
+    TEST_CHECK(atomic_load(&g_late_calls) == 0);
+    for (uint16_t ch = 0; ch < CH_CNT; ch++) {
+        TEST_CHECK(atomic_load(&g_calls[ch]) > 0);
+    }
+}
+
+static void test_disable_keeps_registration(void)
+{
+    uint64_t cycled;
+
+    /* Disabling takes the channel down but keeps its callback for re-enabling */
+    TEST_CHECK(gpio_int_channel_set_enabled(CH_CYCLED, 0) == DIS_COMMON_ERR_OK);
+    TEST_CHECK(gpio_int_sim_inject(CH_CYCLED, 1) != DIS_COMMON_ERR_OK);
+    TEST_CHECK(gpio_int_channel_set_enabled(CH_CYCLED, 1) == DIS_COMMON_ERR_OK);
+
+    cycled = atomic_load(&g_calls[CH_CYCLED]);
+    test_inject(CH_CYCLED, 0);
+    TEST_CHECK(TEST_WAIT(atomic_load(&g_calls[CH_CYCLED]) == cycled + 1, TEST_TIMEOUT_MS));
+}
+
+int main(void)
+{
+    GpioIntCtx ctx;
+
+    test_ctx_init(&ctx, CH_CNT, GPIO_INT_MODE_UIO);
+    TEST_CHECK(test_start(&ctx) == DIS_COMMON_ERR_OK);
+
+    test_remove_add_under_load();
+    test_disable_keeps_registration();
+
+    gpio_int_system_deinit();
+    return test_report("test_channel");
+}
@@ -0,0 +1,209 @@
+/*
+ * Event queue overflow under each policy.
+ *
+ * Pulled channels are used so nothing is consumed while the queue fills:
+ * the edges are injected first and drained with gpio_int_wait() afterwards.
+ * The last tests let a callback worker drain the queue while it overflows.
+ */
+#include "test_util.h"
+
+#define CH_QUEUE    0
+#define CH_LATEST   1
+#define CH_MERGE    2
+#define CH_SWITCH   3
+#define CH_BURST    4
+#define CH_CNT      5
+
+/* Bursts run against the callback worker of CH_BURST, and edges per burst */
+#define BURST_CNT   20
+#define BURST_EDGES (4 * GPIO_INT_QUEUE_DEPTH + 1)
+
+/* Edges injected per channel, enough to wrap the queue several times */
+#define EDGE_CNT    (3 * GPIO_INT_QUEUE_DEPTH + 1)
+
+/**
+ * @brief Inject EDGE_CNT alternating edges, starting with a rising one
+ * @param channel GPIO interrupt channel number
+ * @return int Last value written
+ */
+static int overfill(uint16_t channel)
+{
+    int value = 0;
+
+    TEST_CHECK(gpio_int_get_event_fd(channel) >= 0);
+    for (int i = 0; i < EDGE_CNT; i++) {
+        value = !value;
+        test_inject(channel, value);
+    }
+    TEST_CHECK(TEST_WAIT(test_interrupts(channel) == EDGE_CNT, TEST_TIMEOUT_MS));
+
+    return value;
+}
+
+/**
+ * @brief Drain a pulled channel without blocking
+ * @param channel GPIO interrupt channel number
+ * @param events Output events
+ * @param max Capacity of events
+ * @return int Number of events taken
+ */
+static int drain(uint16_t channel, GpioIntEvent *events, int max)
+{
+    int n = 0;
+
+    while (n < max && gpio_int_wait(channel, 0, &events[n]) == 1) {
+        n++;
+    }
+    return n;
+}
+
+static void test_overflow_queue(void)
+{
+    GpioIntEvent events[EDGE_CNT];
+    uint64_t drops = 0;
+
+    overfill(CH_QUEUE);
+    int n = drain(CH_QUEUE, events, EDGE_CNT);
+
+    /* The queue keeps the oldest events and counts the rest as dropped */
+    TEST_CHECK(n == GPIO_INT_QUEUE_DEPTH);
+    TEST_CHECK(gpio_int_get_drop_count(CH_QUEUE, &drops) == DIS_COMMON_ERR_OK);
+    TEST_CHECK(drops == EDGE_CNT - GPIO_INT_QUEUE_DEPTH);
+    for (int i = 0; i < n; i++) {
+        TEST_CHECK(events[i].count == 1);
+        TEST_CHECK(events[i].gpio_value == !(i & 1));
+        TEST_CHECK(i == 0 || events[i].timestamp_ns >= events[i - 1].timestamp_ns);
+    }
+}
+
+static void test_overflow_latest(void)
+{
+    GpioIntEvent events[EDGE_CNT];
+    uint64_t drops = 0;
+
+    int last = overfill(CH_LATEST);
+    int n = drain(CH_LATEST, events, EDGE_CNT);
+
+    /* Everything pending collapses into the latest value, the rest is superseded */
+    TEST_CHECK(n == 1);
+    TEST_CHECK(events[0].count == 1);
+    TEST_CHECK(events[0].gpio_value == last);
+    TEST_CHECK(gpio_int_get_drop_count(CH_LATEST, &drops) == DIS_COMMON_ERR_OK);
+    TEST_CHECK(drops == EDGE_CNT - 1);
+}
+
+static void test_overflow_merge(void)
+{
+    GpioIntEvent events[EDGE_CNT];
+    uint64_t drops = 0;
+
+    int last = overfill(CH_MERGE);
+    int n = drain(CH_MERGE, events, EDGE_CNT);
+
+    /* One event carrying the count of every edge, nothing is dropped */
+    TEST_CHECK(n == 1);
+    TEST_CHECK(events[0].count == EDGE_CNT);
+    TEST_CHECK(events[0].gpio_value == last);
+    TEST_CHECK(gpio_int_get_drop_count(CH_MERGE, &drops) == DIS_COMMON_ERR_OK);
+    TEST_CHECK(drops == 0);
+}
+
+static void test_fold_not_overtaken(void)
+{
+    GpioIntEvent events[EDGE_CNT];
+
+    /* Fill the ring and fold under LATEST, then take the ring one event at a time */
+    overfill(CH_SWITCH);
+    TEST_CHECK(gpio_int_set_overflow_policy(CH_SWITCH, GPIO_INT_OVERFLOW_QUEUE) == DIS_COMMON_ERR_OK);
+    TEST_CHECK(gpio_int_wait(CH_SWITCH, 0, &events[0]) == 1);
+
+    /* An edge arriving once the ring has room must still come after the folded ones */
+    int last = !(EDGE_CNT & 1);
+    test_inject(CH_SWITCH, last);
+    TEST_CHECK(TEST_WAIT(test_interrupts(CH_SWITCH) == EDGE_CNT + 1, TEST_TIMEOUT_MS));
+
+    int n = 1 + drain(CH_SWITCH, &events[1], EDGE_CNT - 1);
+    uint32_t total = 0;
+    for (int i = 0; i < n; i++) {
+        TEST_CHECK(i == 0 || events[i].timestamp_ns >= events[i - 1].timestamp_ns);
+        total += events[i].count;
+    }
+    TEST_CHECK(events[n - 1].gpio_value == last);
+    TEST_CHECK(total == EDGE_CNT + 1);
+}
+
+static _Atomic int g_burst_value = -1;
+static _Atomic uint64_t g_burst_ts = 0;
+static _Atomic uint64_t g_burst_count = 0;
+static _Atomic uint64_t g_burst_reordered = 0;
+
+/**
+ * @brief Record the latest delivered event, spinning a little so the queue overflows
+ */
+static void burst_callback(const GpioIntEvent *event)
+{
+    uint64_t until = test_now_ns() + 20000u;
+
+    if (event->timestamp_ns < atomic_load(&g_burst_ts)) {
+        atomic_fetch_add(&g_burst_reordered, 1);
+    }
+    atomic_store(&g_burst_ts, event->timestamp_ns);
+    atomic_store(&g_burst_value, event->gpio_value);
+    atomic_fetch_add(&g_burst_count, event->count);
+
+    while (test_now_ns() < until) {
+    }
+}
+
+static void test_burst(uint8_t policy)
+{
+    /* The line keeps its level from one run to the next */
+    static int value = 0;
+    uint64_t edges = test_interrupts(CH_BURST);
+
+    TEST_CHECK(gpio_int_set_overflow_policy(CH_BURST, policy) == DIS_COMMON_ERR_OK);
+    atomic_store(&g_burst_count, 0);
+    uint64_t first = edges;
+
+    /* Each burst overflows the queue while the worker keeps draining it */
+    for (int b = 0; b < BURST_CNT; b++) {
+        for (int i = 0; i < BURST_EDGES; i++) {
+            value = !value;
+            test_inject(CH_BURST, value);
+        }
+        edges += BURST_EDGES;
+        TEST_CHECK(TEST_WAIT(test_interrupts(CH_BURST) == edges, TEST_TIMEOUT_MS));
+
+        /* The last value delivered is the last value written */
+        TEST_CHECK(TEST_WAIT(atomic_load(&g_burst_value) == value, TEST_TIMEOUT_MS));
+    }
+
+    TEST_CHECK(atomic_load(&g_burst_reordered) == 0);
+    if (policy == GPIO_INT_OVERFLOW_MERGE) {
+        TEST_CHECK(TEST_WAIT(atomic_load(&g_burst_count) == edges - first, TEST_TIMEOUT_MS));
+    }
+}
+
+int main(void)
+{
+    GpioIntCtx ctx;
+
+    test_ctx_init(&ctx, CH_CNT, GPIO_INT_MODE_EDGE);
+    ctx.ch[CH_QUEUE].overflow_policy = GPIO_INT_OVERFLOW_QUEUE;
+    ctx.ch[CH_LATEST].overflow_policy = GPIO_INT_OVERFLOW_LATEST;
+    ctx.ch[CH_MERGE].overflow_policy = GPIO_INT_OVERFLOW_MERGE;
+    ctx.ch[CH_SWITCH].overflow_policy = GPIO_INT_OVERFLOW_LATEST;
+    TEST_CHECK(test_start(&ctx) == DIS_COMMON_ERR_OK);
+
+    test_overflow_queue();
+    test_overflow_latest();
+    test_overflow_merge();
+    test_fold_not_overtaken();
+
+    TEST_CHECK(gpio_int_register_event_callback(CH_BURST, burst_callback) == DIS_COMMON_ERR_OK);
+    test_burst(GPIO_INT_OVERFLOW_LATEST);
+    test_burst(GPIO_INT_OVERFLOW_MERGE);
+
+    gpio_int_system_deinit();
+    return test_report("test_queue");
+}
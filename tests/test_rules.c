@@ -0,0 +1,137 @@
+/*
+ * Composite event rule evaluation: AND, OR with hold time and SEQ.
+ */
+#include "test_util.h"
+
+#define RULE_AND    0
+#define RULE_HOLD   1
+#define RULE_SEQ    2
+
+/* Hold time of RULE_HOLD */
+#define HOLD_US     20000
+
+static _Atomic int g_hits[GPIO_INT_MAX_RULES];
+static GpioIntRuleEvent g_last[GPIO_INT_MAX_RULES];
+
+static void rule_callback(const GpioIntRuleEvent *event, void *arg)
+{
+    (void)arg;
+
+    g_last[event->rule] = *event;
+    atomic_fetch_add(&g_hits[event->rule], 1);
+}
+
+/**
+ * @brief Set a line and let the monitor evaluate the rules
+ */
+static void set_line(uint16_t channel, int value)
+{
+    uint64_t interrupts = test_interrupts(channel);
+
+    test_inject(channel, value);
+    TEST_CHECK(TEST_WAIT(test_interrupts(channel) > interrupts, TEST_TIMEOUT_MS));
+    usleep(2000);
+}
+
+static void test_and(void)
+{
+    /* Both terms asserted, in either order */
+    set_line(1, 1);
+    set_line(0, 1);
+    TEST_CHECK(atomic_load(&g_hits[RULE_AND]) == 1);
+    TEST_CHECK(g_last[RULE_AND].channel == 0);
+    TEST_CHECK(g_last[RULE_AND].first_ns <= g_last[RULE_AND].timestamp_ns);
+    TEST_CHECK(atomic_load(&g_hits[RULE_SEQ]) == 0);
+
+    /* Matches again only after the condition dropped */
+    set_line(1, 0);
+    set_line(1, 1);
+    TEST_CHECK(atomic_load(&g_hits[RULE_AND]) == 2);
+    TEST_CHECK(g_last[RULE_AND].matches == 2);
+}
+
+static void test_seq(void)
+{
+    /* Channel 1 rose again after channel 0 in test_and(): one SEQ match so far */
+    TEST_CHECK(atomic_load(&g_hits[RULE_SEQ]) == 1);
+    TEST_CHECK(g_last[RULE_SEQ].channel == 1);
+
+    /* Out of order, then in order */
+    set_line(0, 0);
+    set_line(1, 0);
+    set_line(1, 1);
+    set_line(0, 1);
+    TEST_CHECK(atomic_load(&g_hits[RULE_SEQ]) == 1);
+    set_line(1, 0);
+    set_line(0, 0);
+    set_line(0, 1);
+    set_line(1, 1);
+    TEST_CHECK(atomic_load(&g_hits[RULE_SEQ]) == 2);
+    TEST_CHECK(g_last[RULE_SEQ].first_ns < g_last[RULE_SEQ].timestamp_ns);
+    TEST_CHECK(atomic_load(&g_hits[RULE_AND]) == 4);
+}
+
+static void test_hold(void)
+{
+    /* The line starts low, which the rule does not count as a new assertion */
+    set_line(2, 1);
+    TEST_CHECK(atomic_load(&g_hits[RULE_HOLD]) == 0);
+
+    /* Asserted shorter than hold_us: no match */
+    set_line(2, 0);
+    usleep(HOLD_US / 2);
+    set_line(2, 1);
+    usleep(HOLD_US);
+    TEST_CHECK(atomic_load(&g_hits[RULE_HOLD]) == 0);
+
+    /* Held long enough: one match, after the hold time */
+    set_line(2, 0);
+    TEST_CHECK(TEST_WAIT(atomic_load(&g_hits[RULE_HOLD]) == 1, TEST_TIMEOUT_MS));
+    TEST_CHECK(g_last[RULE_HOLD].match_ns - g_last[RULE_HOLD].timestamp_ns >= HOLD_US * 1000ull);
+    TEST_CHECK(g_last[RULE_HOLD].matches == 1);
+}
+
+static void test_remove(void)
+{
+    GpioIntRuleCfg bad = { .op = GPIO_INT_RULE_AND, .term_cnt = 1, .term = { { 7, 1 } } };
+
+    /* Terms must name configured channels */
+    TEST_CHECK(gpio_int_set_rule(3, &bad) == DIS_COMMON_ERR_INV_PARAM);
+    TEST_CHECK(gpio_int_set_rule(GPIO_INT_MAX_RULES, NULL) == DIS_COMMON_ERR_INV_PARAM);
+
+    /* A removed rule stops matching */
+    TEST_CHECK(gpio_int_set_rule(RULE_AND, NULL) == DIS_COMMON_ERR_OK);
+    set_line(0, 0);
+    set_line(0, 1);
+    TEST_CHECK(atomic_load(&g_hits[RULE_AND]) == 4);
+}
+
+int main(void)
+{
+    GpioIntCtx ctx;
+
+    test_ctx_init(&ctx, 3, GPIO_INT_MODE_UIO);
+    ctx.ch[2].pin_cfg.mode = GPIO_INT_MODE_EDGE;
+    ctx.rule[RULE_AND] = (GpioIntRuleCfg){
+        .op = GPIO_INT_RULE_AND, .term_cnt = 2, .term = { { 0, 1 }, { 1, 1 } },
+    };
+    ctx.rule[RULE_HOLD] = (GpioIntRuleCfg){
+        .op = GPIO_INT_RULE_OR, .term_cnt = 1, .term = { { 2, 0 } }, .hold_us = HOLD_US,
+    };
+    ctx.rule[RULE_SEQ] = (GpioIntRuleCfg){
+        .op = GPIO_INT_RULE_SEQ, .term_cnt = 2, .term = { { 0, 1 }, { 1, 1 } }, .window_us = 100000,
+    };
+    TEST_CHECK(test_start(&ctx) == DIS_COMMON_ERR_OK);
+
+    for (uint8_t r = 0; r < GPIO_INT_MAX_RULES; r++) {
+        TEST_CHECK(gpio_int_register_rule_callback(r, rule_callback, NULL) == DIS_COMMON_ERR_OK);
+    }
+
+    test_and();
+    test_seq();
+    test_hold();
+    test_remove();
+
+    gpio_int_system_deinit();
+    return test_report("test_rules");
+}
@@ -0,0 +1,130 @@
+#ifndef _GPIOINT_TEST_UTIL_H_
+#define _GPIOINT_TEST_UTIL_H_
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include "gpioInterrupt.h"
+#include "gpioIntSim.h"
+
+/*
+ * Helpers shared by the tests driven by the simulated backend. Each test
+ * program starts the interrupt system on the sim backend, drives the lines
+ * with gpio_int_sim_inject() and checks what reaches the consumers.
+ */
+
+/* Default time a test waits for the monitor or a worker to catch up */
+#define TEST_TIMEOUT_MS 2000
+
+static int g_test_failures = 0;
+
+/* Record a failed check without aborting the test program */
+#define TEST_CHECK(cond)                                                            \
+    do {                                                                            \
+        if (!(cond)) {                                                              \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);\
+            g_test_failures++;                                                      \
+        }                                                                           \
+    } while (0)
+
+/* Poll cond every millisecond until it holds or timeout_ms passed, evaluates to cond */
+#define TEST_WAIT(cond, timeout_ms)                                                 \
+    ({                                                                              \
+        uint64_t test_deadline_ = test_now_ns() + (uint64_t)(timeout_ms) * 1000000ull; \
+        while (!(cond) && test_now_ns() < test_deadline_) {                         \
+            usleep(1000);                                                           \
+        }                                                                           \
+        (cond);                                                                     \
+    })
+
+/**
+ * @brief Get the current CLOCK_MONOTONIC time
+ * @return uint64_t Time in nanoseconds
+ */
+static inline uint64_t test_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Allocate a context with all channels enabled in one acquisition mode
+ * @param ctx Context to set up
+ * @param cnt Number of channels
+ * @param mode GpioIntAcqMode of every channel
+ */
+static inline void test_ctx_init(GpioIntCtx *ctx, uint16_t cnt, uint8_t mode)
+{
+    memset(ctx, 0, sizeof(*ctx));
+    gpio_int_ctx_alloc(ctx, cnt);
+    for (uint16_t i = 0; i < cnt; i++) {
+        gpio_int_ctx_set_enabled(ctx, i, 1);
+        ctx->ch[i].pin_cfg.mode = mode;
+        ctx->ch[i].pin_cfg.uio_index = (uint8_t)i;
+        ctx->ch[i].pin_cfg.group_bit = (uint8_t)i;
+        snprintf(ctx->ch[i].pin_cfg.consumer, sizeof(ctx->ch[i].pin_cfg.consumer), "test%u", i);
+    }
+}
+
+/**
+ * @brief Start the interrupt system on the sim backend and release the context
+ * @param ctx Context set up with test_ctx_init()
+ * @return uint8_t Result of gpio_int_system_init_with_ctx()
+ */
+static inline uint8_t test_start(GpioIntCtx *ctx)
+{
+    gpio_int_set_backend(&g_gpio_int_sim_backend);
+    uint8_t ret = gpio_int_system_init_with_ctx(ctx);
+    gpio_int_ctx_free(ctx);
+    return ret;
+}
+
+/**
+ * @brief Get the number of interrupts the monitor handled on a channel
+ * @param channel GPIO interrupt channel number
+ * @return uint64_t GpioIntStats.interrupts
+ */
+static inline uint64_t test_interrupts(uint16_t channel)
+{
+    GpioIntStats stats;
+
+    if (gpio_int_get_stats(channel, &stats) != DIS_COMMON_ERR_OK) {
+        return 0;
+    }
+    return stats.interrupts;
+}
+
+/**
+ * @brief Drive a line once the previous interrupt has been taken
+ * @param channel GPIO interrupt channel number
+ * @param value Line value (0 or 1)
+ *
+ * Waits while the simulated source would coalesce or drop the interrupt,
+ * so every call becomes its own wakeup or edge event.
+ */
+static inline void test_inject(uint16_t channel, int value)
+{
+    TEST_WAIT(!gpio_int_sim_busy(channel), TEST_TIMEOUT_MS);
+    gpio_int_sim_inject(channel, value);
+}
+
+/**
+ * @brief Report the outcome of a test program
+ * @param name Test name
+ * @return int Exit status, 0 if every check passed
+ */
+static inline int test_report(const char *name)
+{
+    if (g_test_failures != 0) {
+        printf("FAIL %s (%d checks failed)\n", name, g_test_failures);
+        return 1;
+    }
+    printf("PASS %s\n", name);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,329 @@
+/*
+ * Timer driven windows: glitch filter, storm protection and counter mode.
+ */
+#include "test_util.h"
+
+#define CH_DEBOUNCE 0
+#define CH_RISING   1
+#define CH_PULSE    2
+#define CH_STORM    3
+#define CH_COUNTER  4
+#define CH_EDGE_STORM 5
+#define CH_CNT      6
+
+/* Storm protection of CH_STORM and CH_EDGE_STORM */
+#define STORM_MAX_RATE  500
+#define STORM_WINDOW_US 20000
+#define STORM_POLL_US   5000
+
+/* Counter window and edges of CH_COUNTER */
+#define COUNTER_WINDOW_US   50000
+#define COUNTER_EDGES       20
+
+static _Atomic int g_events[CH_CNT];
+static _Atomic int g_last_value[CH_CNT];
+static _Atomic int g_storm_on[CH_CNT];
+static _Atomic int g_storm_off[CH_CNT];
+static _Atomic uint32_t g_storm_off_rate[CH_CNT];
+static _Atomic uint32_t g_counter_edges = 0;
+static _Atomic int g_counter_reports = 0;
+static GpioIntCounterReport g_counter_last;
+
+static void event_callback(const GpioIntEvent *event)
+{
+    atomic_store(&g_last_value[event->channel], event->gpio_value);
+    atomic_fetch_add(&g_events[event->channel], 1);
+}
+
+static void storm_callback(uint16_t channel, uint8_t storm, uint32_t rate)
+{
+    if (channel >= CH_CNT) {
+        return;
+    }
+    if (!storm) {
+        atomic_store(&g_storm_off_rate[channel], rate);
+    }
+    atomic_fetch_add(storm ? &g_storm_on[channel] : &g_storm_off[channel], 1);
+}
+
+static void counter_callback(const GpioIntCounterReport *report, void *arg)
+{
+    (void)arg;
+
+    if (report->edges != 0) {
+        g_counter_last = *report;
+    }
+    atomic_fetch_add(&g_counter_edges, report->edges);
+    atomic_fetch_add(&g_counter_reports, 1);
+}
+
+/**
+ * @brief Get the filtered interrupt count of a channel
+ */
+static uint64_t filtered(uint16_t channel)
+{
+    GpioIntStats stats;
+
+    gpio_int_get_stats(channel, &stats);
+    return stats.filtered;
+}
+
+static void test_debounce(void)
+{
+    GpioIntFilterCfg cfg = { .debounce_us = 5000 };
+
+    TEST_CHECK(gpio_int_set_filter(CH_DEBOUNCE, &cfg) == DIS_COMMON_ERR_OK);
+    TEST_CHECK(gpio_int_register_event_callback(CH_DEBOUNCE, event_callback) == DIS_COMMON_ERR_OK);
+
+    /* A bounce ending high reports one rising transition once the line is quiet */
+    int bounce[] = { 1, 0, 1, 0, 1 };
+    for (unsigned int i = 0; i < sizeof(bounce) / sizeof(bounce[0]); i++) {
+        test_inject(CH_DEBOUNCE, bounce[i]);
+    }
+    TEST_CHECK(TEST_WAIT(atomic_load(&g_events[CH_DEBOUNCE]) == 1, TEST_TIMEOUT_MS));
+    TEST_CHECK(atomic_load(&g_last_value[CH_DEBOUNCE]) == 1);
+    TEST_CHECK(filtered(CH_DEBOUNCE) == 4);
+
+    /* A glitch returning to the reported level is absorbed entirely */
+    test_inject(CH_DEBOUNCE, 0);
+    test_inject(CH_DEBOUNCE, 1);
+    TEST_CHECK(TEST_WAIT(filtered(CH_DEBOUNCE) == 6, TEST_TIMEOUT_MS));
+    usleep(20000);
+    TEST_CHECK(atomic_load(&g_events[CH_DEBOUNCE]) == 1);
+}
+
+static void test_edge_filter(void)
+{
+    GpioIntFilterCfg cfg = { .edge_filter = GPIO_INT_FILTER_RISING };
+
+    TEST_CHECK(gpio_int_set_filter(CH_RISING, &cfg) == DIS_COMMON_ERR_OK);
+    TEST_CHECK(gpio_int_register_event_callback(CH_RISING, event_callback) == DIS_COMMON_ERR_OK);
+
+    for (int i = 0; i < 6; i++) {
+        test_inject(CH_RISING, !(i & 1));
+    }
+    TEST_CHECK(TEST_WAIT(atomic_load(&g_events[CH_RISING]) == 3, TEST_TIMEOUT_MS));
+    TEST_CHECK(TEST_WAIT(filtered(CH_RISING) == 3, TEST_TIMEOUT_MS));
+    TEST_CHECK(atomic_load(&g_last_value[CH_RISING]) == 1);
+}
+
+static void test_min_pulse(void)
+{
+    GpioIntFilterCfg cfg = { .min_pulse_us = 10000 };
+
+    TEST_CHECK(gpio_int_set_filter(CH_PULSE, &cfg) == DIS_COMMON_ERR_OK);
+    TEST_CHECK(gpio_int_register_event_callback(CH_PULSE, event_callback) == DIS_COMMON_ERR_OK);
+
+    /* A pulse shorter than min_pulse_us is not reported */
+    test_inject(CH_PULSE, 1);
+    usleep(2000);
+    test_inject(CH_PULSE, 0);
+    TEST_CHECK(TEST_WAIT(filtered(CH_PULSE) == 2, TEST_TIMEOUT_MS));
+    TEST_CHECK(atomic_load(&g_events[CH_PULSE]) == 0);
+
+    /* A level held long enough is */
+    test_inject(CH_PULSE, 1);
+    TEST_CHECK(TEST_WAIT(atomic_load(&g_events[CH_PULSE]) == 1, TEST_TIMEOUT_MS));
+    TEST_CHECK(atomic_load(&g_last_value[CH_PULSE]) == 1);
+}
+
+/**
+ * @brief Raise interrupts on a channel at a fixed rate
+ * @param channel GPIO interrupt channel number
+ * @param period_us Time between interrupts, 0 for as fast as possible
+ * @param duration_us Time to keep going
+ */
+static void drive(uint16_t channel, uint32_t period_us, uint32_t duration_us)
+{
+    uint64_t end = test_now_ns() + (uint64_t)duration_us * 1000u;
+    int value = 0;
+
+    while (test_now_ns() < end) {
+        value = !value;
+        gpio_int_sim_inject(channel, value);
+        if (period_us) {
+            usleep(period_us);
+        }
+    }
+}
+
+/**
+ * @brief Check whether a channel is storm polling
+ */
+static uint8_t storm_polling(uint16_t channel)
+{
+    GpioIntStats stats;
+
+    gpio_int_get_stats(channel, &stats);
+    return stats.storm_polling;
+}
+
+/**
+ * @brief Flood a channel until it enters storm polling
+ * @param channel GPIO interrupt channel number
+ * @param storms Storms the channel entered so far
+ */
+static void flood(uint16_t channel, int storms)
+{
+    uint64_t deadline = test_now_ns() + TEST_TIMEOUT_MS * 1000000ull;
+
+    while (atomic_load(&g_storm_on[channel]) == storms && test_now_ns() < deadline) {
+        drive(channel, 0, 10000);
+    }
+    TEST_CHECK(atomic_load(&g_storm_on[channel]) == storms + 1);
+    TEST_CHECK(storm_polling(channel) == 1);
+}
+
+static void test_storm(void)
+{
+    GpioIntStormCfg cfg = { .max_rate = STORM_MAX_RATE, .window_us = STORM_WINDOW_US, .poll_us = STORM_POLL_US };
+    GpioIntStormCfg too_fast = { .max_rate = 100, .poll_us = 1000 };
+
+    TEST_CHECK(gpio_int_set_storm(CH_STORM, &too_fast) == DIS_COMMON_ERR_INV_PARAM);
+    TEST_CHECK(gpio_int_register_storm_callback(storm_callback) == DIS_COMMON_ERR_OK);
+    TEST_CHECK(gpio_int_set_storm(CH_STORM, &cfg) == DIS_COMMON_ERR_OK);
+    TEST_CHECK(gpio_int_register_event_callback(CH_STORM, event_callback) == DIS_COMMON_ERR_OK);
+
+    /* A flood far above max_rate switches the channel to polling */
+    flood(CH_STORM, 0);
+
+    /* While polling, the wakeups are bounded by the poll rate */
+    uint64_t before = test_interrupts(CH_STORM);
+    drive(CH_STORM, 0, 50000);
+    uint64_t polled = test_interrupts(CH_STORM) - before;
+    TEST_CHECK(polled <= 50000 / STORM_POLL_US + 3);
+
+    /* A quiet line returns to interrupt mode */
+    TEST_CHECK(TEST_WAIT(atomic_load(&g_storm_off[CH_STORM]) == 1, TEST_TIMEOUT_MS));
+    TEST_CHECK(storm_polling(CH_STORM) == 0);
+
+    int events = atomic_load(&g_events[CH_STORM]);
+    usleep(5000);
+    test_inject(CH_STORM, 1);
+    TEST_CHECK(TEST_WAIT(atomic_load(&g_events[CH_STORM]) > events, TEST_TIMEOUT_MS));
+
+    GpioIntStats stats;
+    TEST_CHECK(gpio_int_get_stats(CH_STORM, &stats) == DIS_COMMON_ERR_OK);
+    TEST_CHECK(stats.storms == 1);
+}
+
+static void test_storm_uio_firing(void)
+{
+    flood(CH_STORM, 1);
+
+    /* A masked UIO line tells only that it fired: firing at every poll keeps it polled */
+    drive(CH_STORM, STORM_POLL_US / 5, 5 * STORM_WINDOW_US);
+    TEST_CHECK(storm_polling(CH_STORM) == 1);
+    TEST_CHECK(atomic_load(&g_storm_off[CH_STORM]) == 1);
+
+    /* and a window without any interrupt ends polling */
+    TEST_CHECK(TEST_WAIT(atomic_load(&g_storm_off[CH_STORM]) == 2, TEST_TIMEOUT_MS));
+    TEST_CHECK(storm_polling(CH_STORM) == 0);
+}
+
+static void test_storm_edge_moderate(void)
+{
+    GpioIntStormCfg cfg = { .max_rate = STORM_MAX_RATE, .window_us = STORM_WINDOW_US, .poll_us = STORM_POLL_US };
+
+    TEST_CHECK(gpio_int_set_storm(CH_EDGE_STORM, &cfg) == DIS_COMMON_ERR_OK);
+    flood(CH_EDGE_STORM, 0);
+
+    /* Edge polls count every edge: a line still firing at every poll, but
+     * below max_rate / 2, leaves polling */
+    uint64_t deadline = test_now_ns() + TEST_TIMEOUT_MS * 1000000ull;
+    while (atomic_load(&g_storm_off[CH_EDGE_STORM]) == 0 && test_now_ns() < deadline) {
+        drive(CH_EDGE_STORM, STORM_POLL_US, STORM_WINDOW_US);
+    }
+    TEST_CHECK(atomic_load(&g_storm_off[CH_EDGE_STORM]) == 1);
+    TEST_CHECK(atomic_load(&g_storm_off_rate[CH_EDGE_STORM]) < STORM_MAX_RATE / 2);
+
+    /* and stays in interrupt mode at that rate */
+    drive(CH_EDGE_STORM, STORM_POLL_US, 5 * STORM_WINDOW_US);
+    TEST_CHECK(atomic_load(&g_storm_on[CH_EDGE_STORM]) == 1);
+    TEST_CHECK(storm_polling(CH_EDGE_STORM) == 0);
+}
+
+static void test_counter(void)
+{
+    GpioIntCounterCfg cfg = { .window_us = COUNTER_WINDOW_US };
+    GpioIntCounterCfg too_short = { .window_us = GPIO_INT_COUNTER_MIN_WINDOW_US - 1 };
+    GpioIntCounterReport report;
+
+    TEST_CHECK(gpio_int_set_counter(CH_COUNTER, &too_short) == DIS_COMMON_ERR_INV_PARAM);
+    TEST_CHECK(gpio_int_set_counter(CH_COUNTER, &cfg) == DIS_COMMON_ERR_OK);
+    TEST_CHECK(gpio_int_register_counter_callback(CH_COUNTER, counter_callback, NULL) == DIS_COMMON_ERR_OK);
+    TEST_CHECK(gpio_int_register_event_callback(CH_COUNTER, event_callback) == DIS_COMMON_ERR_OK);
+
+    /* A 2 ms square wave: every edge is counted, none is dispatched */
+    for (int i = 0; i < COUNTER_EDGES; i++) {
+        test_inject(CH_COUNTER, !(i & 1));
+        usleep(1000);
+    }
+    TEST_CHECK(TEST_WAIT(atomic_load(&g_counter_edges) == COUNTER_EDGES, TEST_TIMEOUT_MS));
+    TEST_CHECK(atomic_load(&g_events[CH_COUNTER]) == 0);
+
+    TEST_CHECK(g_counter_last.channel == CH_COUNTER);
+    TEST_CHECK(g_counter_last.periods > 0);
+    TEST_CHECK(g_counter_last.min_period_ns >= 2000000u);
+    TEST_CHECK(g_counter_last.min_period_ns <= g_counter_last.max_period_ns);
+    TEST_CHECK(g_counter_last.end_ns - g_counter_last.start_ns >= COUNTER_WINDOW_US * 500ull);
+    TEST_CHECK(gpio_int_get_counter(CH_COUNTER, &report) == DIS_COMMON_ERR_OK);
+    TEST_CHECK(report.end_ns != 0);
+
+    /* Quiet windows keep being reported, with no edges */
+    int reports = atomic_load(&g_counter_reports);
+    TEST_CHECK(TEST_WAIT(atomic_load(&g_counter_reports) >= reports + 2, TEST_TIMEOUT_MS));
+    TEST_CHECK(atomic_load(&g_counter_edges) == COUNTER_EDGES);
+
+    /* Leaving counter mode restores per-edge dispatch */
+    TEST_CHECK(gpio_int_set_counter(CH_COUNTER, NULL) == DIS_COMMON_ERR_OK);
+    test_inject(CH_COUNTER, 1);
+    TEST_CHECK(TEST_WAIT(atomic_load(&g_events[CH_COUNTER]) == 1, TEST_TIMEOUT_MS));
+}
+
+static void test_counter_remove(void)
+{
+    GpioIntCounterCfg cfg = { .window_us = COUNTER_WINDOW_US };
+    GpioIntPinCfg pin = {
+        .group_bit = CH_COUNTER,
+        .uio_index = CH_COUNTER,
+        .consumer = "test4",
+        .mode = GPIO_INT_MODE_EDGE,
+    };
+
+    /* Removal forgets counter mode and its callback */
+    TEST_CHECK(gpio_int_set_counter(CH_COUNTER, &cfg) == DIS_COMMON_ERR_OK);
+    TEST_CHECK(gpio_int_channel_remove(CH_COUNTER) == DIS_COMMON_ERR_OK);
+    TEST_CHECK(gpio_int_channel_add(CH_COUNTER, &pin, GPIO_INT_OVERFLOW_QUEUE) == DIS_COMMON_ERR_OK);
+    TEST_CHECK(gpio_int_register_event_callback(CH_COUNTER, event_callback) == DIS_COMMON_ERR_OK);
+
+    int reports = atomic_load(&g_counter_reports);
+    int events = atomic_load(&g_events[CH_COUNTER]);
+    test_inject(CH_COUNTER, 0);
+    TEST_CHECK(TEST_WAIT(atomic_load(&g_events[CH_COUNTER]) == events + 1, TEST_TIMEOUT_MS));
+    usleep(2 * COUNTER_WINDOW_US);
+    TEST_CHECK(atomic_load(&g_counter_reports) == reports);
+}
+
+int main(void)
+{
+    GpioIntCtx ctx;
+
+    test_ctx_init(&ctx, CH_CNT, GPIO_INT_MODE_UIO);
+    ctx.ch[CH_RISING].pin_cfg.mode = GPIO_INT_MODE_EDGE;
+    ctx.ch[CH_COUNTER].pin_cfg.mode = GPIO_INT_MODE_EDGE;
+    ctx.ch[CH_EDGE_STORM].pin_cfg.mode = GPIO_INT_MODE_EDGE;
+    TEST_CHECK(test_start(&ctx) == DIS_COMMON_ERR_OK);
+
+    test_debounce();
+    test_edge_filter();
+    test_min_pulse();
+    test_storm();
+    test_storm_uio_firing();
+    test_storm_edge_moderate();
+    test_counter();
+    test_counter_remove();
+
+    gpio_int_system_deinit();
+    return test_report("test_windows");
+}
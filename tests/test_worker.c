@@ -0,0 +1,160 @@
+/*
+ * Callback worker delivery state transitions.
+ *
+ * The worker of a channel goes IDLE -> RUNNING when kicked, a new event
+ * while it runs moves it to PENDING so it drains again before going back
+ * to IDLE. Callbacks of one channel never overlap.
+ */
+#include "test_util.h"
+
+#define CH_GATED    0
+#define CH_PULLED   1
+
+/* Events injected while the first callback is held */
+#define HELD_CNT    10
+
+static _Atomic int g_calls = 0;
+static _Atomic int g_inside = 0;
+static _Atomic int g_max_inside = 0;
+static _Atomic bool g_hold = false;
+static _Atomic bool g_held = false;
+static int g_values[GPIO_INT_QUEUE_DEPTH];
+
+/**
+ * @brief Record the event, holding the first call until g_hold is cleared
+ */
+static void gated_callback(const GpioIntEvent *event)
+{
+    int inside = atomic_fetch_add(&g_inside, 1) + 1;
+    int max = atomic_load(&g_max_inside);
+
+    while (inside > max && !atomic_compare_exchange_weak(&g_max_inside, &max, inside)) {
+    }
+
+    int call = atomic_load(&g_calls);
+    if (call < GPIO_INT_QUEUE_DEPTH) {
+        g_values[call] = event->gpio_value;
+    }
+
+    atomic_store(&g_held, true);
+    while (atomic_load(&g_hold)) {
+        usleep(100);
+    }
+
+    atomic_fetch_sub(&g_inside, 1);
+    atomic_fetch_add(&g_calls, 1);
+}
+
+static void test_pending_while_running(void)
+{
+    atomic_store(&g_hold, true);
+    TEST_CHECK(gpio_int_register_event_callback(CH_GATED, gated_callback) == DIS_COMMON_ERR_OK);
+
+    /* IDLE -> RUNNING: the first edge wakes the worker, which stays in the callback */
+    test_inject(CH_GATED, 1);
+    TEST_CHECK(TEST_WAIT(atomic_load(&g_held), TEST_TIMEOUT_MS));
+
+    /* RUNNING -> PENDING: more edges queue up, the worker is not re-entered */
+    for (int i = 0; i < HELD_CNT; i++) {
+        test_inject(CH_GATED, i & 1);
+    }
+    TEST_CHECK(TEST_WAIT(test_interrupts(CH_GATED) == HELD_CNT + 1, TEST_TIMEOUT_MS));
+    usleep(10000);
+    TEST_CHECK(atomic_load(&g_calls) == 0);
+    TEST_CHECK(atomic_load(&g_inside) == 1);
+
+    /* PENDING -> RUNNING -> IDLE: once released, the worker drains everything queued */
+    atomic_store(&g_hold, false);
+    TEST_CHECK(TEST_WAIT(atomic_load(&g_calls) == HELD_CNT + 1, TEST_TIMEOUT_MS));
+    TEST_CHECK(atomic_load(&g_max_inside) == 1);
+    TEST_CHECK(g_values[0] == 1);
+    for (int i = 0; i < HELD_CNT; i++) {
+        TEST_CHECK(g_values[i + 1] == (i & 1));
+    }
+}
+
+static void test_idle_wakeup(void)
+{
+    /* IDLE again: a single edge after a quiet period is delivered on its own */
+    for (int i = 0; i < 5; i++) {
+        int calls = atomic_load(&g_calls);
+        usleep(5000);
+        test_inject(CH_GATED, i & 1);
+        TEST_CHECK(TEST_WAIT(atomic_load(&g_calls) == calls + 1, TEST_TIMEOUT_MS));
+    }
+    TEST_CHECK(atomic_load(&g_max_inside) == 1);
+}
+
+static void test_unregister(void)
+{
+    int calls = atomic_load(&g_calls);
+    uint64_t interrupts = test_interrupts(CH_GATED);
+
+    /* Without a callback the monitor still handles the line but queues nothing */
+    TEST_CHECK(gpio_int_register_event_callback(CH_GATED, NULL) == DIS_COMMON_ERR_OK);
+    test_inject(CH_GATED, 1);
+    test_inject(CH_GATED, 0);
+    TEST_CHECK(TEST_WAIT(test_interrupts(CH_GATED) == interrupts + 2, TEST_TIMEOUT_MS));
+    usleep(10000);
+    TEST_CHECK(atomic_load(&g_calls) == calls);
+
+    /* The worker survives and picks up delivery for the next registration */
+    TEST_CHECK(gpio_int_register_event_callback(CH_GATED, gated_callback) == DIS_COMMON_ERR_OK);
+    test_inject(CH_GATED, 1);
+    TEST_CHECK(TEST_WAIT(atomic_load(&g_calls) == calls + 1, TEST_TIMEOUT_MS));
+}
+
+static void test_pull_exclusive(void)
+{
+    GpioIntEvent event;
+
+    /* A channel delivers either to callbacks or to gpio_int_wait(), never both */
+    TEST_CHECK(gpio_int_get_event_fd(CH_GATED) < 0);
+    TEST_CHECK(gpio_int_get_event_fd(CH_PULLED) >= 0);
+    TEST_CHECK(gpio_int_register_event_callback(CH_PULLED, gated_callback) != DIS_COMMON_ERR_OK);
+
+    /* The pull consumer times out on a quiet line and wakes on an edge */
+    TEST_CHECK(gpio_int_wait(CH_PULLED, 10, &event) == 0);
+    test_inject(CH_PULLED, 1);
+    TEST_CHECK(gpio_int_wait(CH_PULLED, TEST_TIMEOUT_MS, &event) == 1);
+    TEST_CHECK(event.channel == CH_PULLED && event.gpio_value == 1);
+    TEST_CHECK(gpio_int_wait(CH_PULLED, 0, &event) == 0);
+}
+
+static void test_pull_remove(void)
+{
+    GpioIntPinCfg pin = {
+        .group_bit = CH_PULLED,
+        .uio_index = CH_PULLED,
+        .consumer = "test1",
+        .mode = GPIO_INT_MODE_EDGE,
+    };
+    int calls = atomic_load(&g_calls);
+
+    /* Removal ends pull delivery, the channel added again takes callbacks */
+    TEST_CHECK(gpio_int_get_event_fd(CH_PULLED) >= 0);
+    TEST_CHECK(gpio_int_channel_remove(CH_PULLED) == DIS_COMMON_ERR_OK);
+    TEST_CHECK(gpio_int_channel_add(CH_PULLED, &pin, GPIO_INT_OVERFLOW_QUEUE) == DIS_COMMON_ERR_OK);
+    TEST_CHECK(gpio_int_register_event_callback(CH_PULLED, gated_callback) == DIS_COMMON_ERR_OK);
+
+    test_inject(CH_PULLED, 0);
+    TEST_CHECK(TEST_WAIT(atomic_load(&g_calls) == calls + 1, TEST_TIMEOUT_MS));
+    TEST_CHECK(gpio_int_get_event_fd(CH_PULLED) < 0);
+}
+
+int main(void)
+{
+    GpioIntCtx ctx;
+
+    test_ctx_init(&ctx, 2, GPIO_INT_MODE_EDGE);
+    TEST_CHECK(test_start(&ctx) == DIS_COMMON_ERR_OK);
+
+    test_pending_while_running();
+    test_idle_wakeup();
+    test_unregister();
+    test_pull_exclusive();
+    test_pull_remove();
+
+    gpio_int_system_deinit();
+    return test_report("test_worker");
+}